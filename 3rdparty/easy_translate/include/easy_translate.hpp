@@ -11,11 +11,21 @@
 #define EASY_TRANSLATE_HPP
 
 #include <cstddef>              // size_t
+#include <cstring>              // memcpy, strcmp
 #include <string>               // string
 #include <vector>               // vector
+#include <algorithm>            // find, min, max
 #include <set>                  // set
 #include <map>                  // map
+#include <unordered_map>        // unordered_map
+#include <unordered_set>        // unordered_set
+#include <memory>               // unique_ptr
+#include <atomic>               // atomic
+#include <mutex>                // mutex, lock_guard
+#include <thread>               // thread, this_thread::yield
+#include <functional>           // hash
 #include <fstream>              // ifstream
+#include <iterator>             // istreambuf_iterator
 
 #include <nlohmann/json.hpp>    // json
 
@@ -52,8 +62,13 @@
 
 // Languages
 //   - Language ID : Translations filename
+//   - Language ID : { "file" : Translations filename, "fallback" : Language ID }
 //   - ...
 //
+// A `Language ID` can declare a fallback language, e.g. zh_TW -> zh -> en. The `Translation ID`s missing
+// (or with empty `Translation text`) in a language are filled from its fallback chain when the language
+// is loaded, so the lookup is still a single probe whatever the length of the chain.
+//
 // Translations
 //   - Translation ID : Translation text
 //   -...
@@ -62,6 +77,17 @@
 // The `Languages file` (e.g. languages.json) and the `Transalations file` (e.g. en.json, zh.json) should
 // use the UTF-8 encoding to save.
 
+// Thread-safety:
+// The translate() and the other query functions of the `TranslateManager` can be called from any thread,
+// they read an immutable snapshot of the `Languages` and the current language without lock.
+// The setLanguages() and setCurrentLanguage() publish a new snapshot and free the retired snapshots if no reader
+// is in a query function, else they are freed by a later publish. So only the current snapshot and the ones
+// retired while the readers were busy are kept (plus the baseline with the EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES).
+// The `Translation text` returned by translate() and the `Language ID` returned by currentLanguage() are stored
+// in a pool that keeps each distinct text once until the `TranslateManager` is destroyed, so they never dangle,
+// and the pool is bounded by the content of the `Translations file`s. The languages(), translations() and
+// fallbackStatistics() return copies.
+
 namespace easytr
 {
 
@@ -81,7 +107,7 @@ public:
     Languages(const std::map<std::string, std::string>& langs) : languages_(langs) {}
 
     /// @brief Load the `Languages` from a json string.
-    /// @note If the json is invalid, the `Languages` will be empty.
+    /// @note If the json is invalid, the `Languages` will be empty. The entries of an invalid type are skipped.
     static Languages fromJson(const std::string& json)
     {
         using Json = nlohmann::json;
@@ -90,15 +116,11 @@ public:
         if (j.is_discarded())
             return Languages();
 
-        std::map<std::string, std::string> list;
-        for (const auto& var : j.items())
-            list.insert({ var.key(), var.value() });
-
-        return Languages(list);
+        return fromJson_(j);
     }
 
     /// @brief Load the `Languages` from a json file.
-    /// @note If the json is invalid, the `Languages` will be empty.
+    /// @note If the json is invalid, the `Languages` will be empty. The entries of an invalid type are skipped.
     static Languages fromFile(const std::string& filename)
     {
         using Json = nlohmann::json;
@@ -108,18 +130,11 @@ public:
             return Languages();
 
         Json j = Json::parse(ifs, nullptr, false, true);
+        ifs.close();
         if (j.is_discarded())
-        {
-            ifs.close();
             return Languages();
-        }
-
-        std::map<std::string, std::string> list;
-        ifs.close();
-        for (const auto& var : j.items())
-            list.insert({ var.key(), var.value() });
 
-        return Languages(list);
+        return fromJson_(j);
     }
 
     /// @brief Get the json string.
@@ -127,7 +142,18 @@ public:
     {
         nlohmann::json j;
         for (const auto& var : languages_)
-            j[var.first] = var.second;
+        {
+            auto it = fallbacks_.find(var.first);
+            if (it == fallbacks_.end())
+            {
+                j[var.first] = var.second;
+            }
+            else
+            {
+                j[var.first]["file"] = var.second;
+                j[var.first]["fallback"] = it->second;
+            }
+        }
         return j.dump(4);
     }
 
@@ -179,14 +205,75 @@ public:
     {
         if (has(languageId))
             languages_.erase(languageId);
+        fallbacks_.erase(languageId);
     }
 
     /// @brief Remove all `Language ID`s and it corresponding `Translations filename`s.
-    void clear() { languages_.clear(); }
+    void clear() { languages_.clear(); fallbacks_.clear(); }
+
+    /// @brief Get the fallback `Language ID` of the given `Language ID`.
+    /// @note If the given `Language ID` has not fallback language, return empty string.
+    const char* fallback(const std::string& languageId) const
+    {
+        auto it = fallbacks_.find(languageId);
+        return it == fallbacks_.end() ? "" : it->second.c_str();
+    }
+
+    /// @brief Set the fallback `Language ID` of the given `Language ID`.
+    /// @note If the fallback `Language ID` is empty, remove the fallback language.
+    void setFallback(const std::string& languageId, const std::string& fallbackId)
+    {
+        if (fallbackId.empty())
+            fallbacks_.erase(languageId);
+        else
+            fallbacks_[languageId] = fallbackId;
+    }
+
+    /// @brief Get the fallback chain of the given `Language ID`, the first element is the given `Language ID`.
+    /// @note The chain stops at a not exists `Language ID` or a cycle.
+    std::vector<std::string> getFallbackChain(const std::string& languageId) const
+    {
+        std::vector<std::string> chain;
+        std::string id = languageId;
+        while (has(id) && std::find(chain.begin(), chain.end(), id) == chain.end())
+        {
+            chain.push_back(id);
+            id = fallback(id);
+        }
+        return chain;
+    }
 
 private:
+    static Languages fromJson_(const nlohmann::json& j)
+    {
+        Languages langs;
+        if (!j.is_object())
+            return langs;
+        for (const auto& var : j.items())
+        {
+            if (var.value().is_string())
+            {
+                langs.languages_.insert({ var.key(), var.value() });
+            }
+            else if (var.value().is_object())
+            {
+                // The entry without a string "file" is skipped, the fallback which is not a string is ignored.
+                auto file = var.value().find("file");
+                if (file == var.value().end() || !file->is_string())
+                    continue;
+                langs.languages_.insert({ var.key(), file->get<std::string>() });
+                auto fallback = var.value().find("fallback");
+                if (fallback != var.value().end() && fallback->is_string())
+                    langs.setFallback(var.key(), fallback->get<std::string>());
+            }
+        }
+        return langs;
+    }
+
     // {Language ID : Translations filename}
     std::map<std::string, std::string> languages_;
+    // {Language ID : Fallback Language ID}
+    std::map<std::string, std::string> fallbacks_;
 };
 
 class Translations
@@ -270,9 +357,10 @@ public:
     /// @note If the given `Translation ID` is not exist, return the `Translation ID` itself.
     const char* at(const std::string& tranId) const
     {
-        if (!has(tranId))
+        auto it = translations_.find(tranId);
+        if (it == translations_.end())
             return tranId.c_str();
-        return translations_.at(tranId).c_str();
+        return it->second.c_str();
     }
 
     /// @brief Get the number of the `Translation ID`.
@@ -317,6 +405,146 @@ private:
     std::map<std::string, std::string> translations_;
 };
 
+/// @brief A set of `Translation ID`s which supports concurrent insertion.
+/// @note The `Translation ID`s are stored in a lock-free open addressing table until it is 3/4 full,
+/// the later `Translation ID`s are stored in an overflow set under a lock, so the set has no capacity limit.
+/// @note Only the first insertion of a `Translation ID` allocates memory, the later insertions of the same
+/// `Translation ID` just probe the table.
+class TranslationIdSet
+{
+public:
+    static constexpr size_t CAPACITY = 4096;
+    // Keep the probe sequences short and always end at an empty slot.
+    static constexpr size_t TABLE_LIMIT = CAPACITY / 4 * 3;
+
+    TranslationIdSet() = default;
+
+    ~TranslationIdSet()
+    {
+        for (auto& slot : slots_)
+            delete[] slot.id.load(std::memory_order_relaxed);
+    }
+
+    TranslationIdSet(const TranslationIdSet&) = delete;
+
+    TranslationIdSet& operator=(const TranslationIdSet&) = delete;
+
+    /// @brief Insert a `Translation ID`, do nothing if it already exists.
+    void insert(const std::string& tranId)
+    {
+        size_t hash = hash_(tranId);
+        size_t index = hash & (CAPACITY - 1);
+        for (size_t i = 0; i < CAPACITY; ++i, index = (index + 1) & (CAPACITY - 1))
+        {
+            Slot& slot = slots_[index];
+            size_t cur = slot.hash.load(std::memory_order_acquire);
+            if (cur == 0)
+            {
+                // The `Translation ID` is not in the table, claim the slot if the table is below the limit.
+                if (reserved_.fetch_add(1, std::memory_order_relaxed) >= TABLE_LIMIT)
+                {
+                    reserved_.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+                if (slot.hash.compare_exchange_strong(cur, hash, std::memory_order_acq_rel))
+                {
+                    char* id = new char[tranId.size() + 1];
+                    std::memcpy(id, tranId.c_str(), tranId.size() + 1);
+                    slot.id.store(id, std::memory_order_release);
+                    return;
+                }
+                // Another thread claimed this slot, #cur is the hash of it now.
+                reserved_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            if (cur != hash)
+                continue;
+
+            // The slot is claimed but the `Translation ID` may not be published yet.
+            const char* id = nullptr;
+            while ((id = slot.id.load(std::memory_order_acquire)) == nullptr)
+                std::this_thread::yield();
+            if (std::strcmp(id, tranId.c_str()) == 0)
+                return;
+        }
+
+        std::lock_guard<std::mutex> lock(overflowMtx_);
+        overflow_.insert(tranId);
+    }
+
+    /// @brief Check whether exists the given `Translation ID`.
+    bool has(const std::string& tranId) const
+    {
+        if (tableHas_(tranId))
+            return true;
+        std::lock_guard<std::mutex> lock(overflowMtx_);
+        return overflow_.find(tranId) != overflow_.end();
+    }
+
+    /// @brief Get the number of the `Translation ID`.
+    size_t count() const { return getIds().size(); }
+
+    /// @brief Get all `Translation ID`s (unordered).
+    std::vector<std::string> getIds() const
+    {
+        std::vector<std::string> ids;
+        for (const auto& slot : slots_)
+        {
+            const char* id = slot.id.load(std::memory_order_acquire);
+            if (id)
+                ids.push_back(id);
+        }
+
+        // A `Translation ID` inserted concurrently while the table reaches the limit may be in both.
+        std::lock_guard<std::mutex> lock(overflowMtx_);
+        for (const auto& id : overflow_)
+        {
+            if (!tableHas_(id))
+                ids.push_back(id);
+        }
+        return ids;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> hash{0};
+        std::atomic<const char*> id{nullptr};
+    };
+
+    // The hash 0 marks the empty slot.
+    static size_t hash_(const std::string& tranId)
+    {
+        size_t hash = std::hash<std::string>()(tranId);
+        return hash == 0 ? 1 : hash;
+    }
+
+    bool tableHas_(const std::string& tranId) const
+    {
+        size_t hash = hash_(tranId);
+        size_t index = hash & (CAPACITY - 1);
+        for (size_t i = 0; i < CAPACITY; ++i, index = (index + 1) & (CAPACITY - 1))
+        {
+            const Slot& slot = slots_[index];
+            size_t cur = slot.hash.load(std::memory_order_acquire);
+            if (cur == 0)
+                return false;
+            if (cur != hash)
+                continue;
+            const char* id = slot.id.load(std::memory_order_acquire);
+            if (id && std::strcmp(id, tranId.c_str()) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    Slot slots_[CAPACITY];
+    // The number of the claimed slots.
+    std::atomic<size_t> reserved_{0};
+    mutable std::mutex overflowMtx_;
+    std::set<std::string> overflow_;
+};
+
 // Singleton class
 class TranslateManager
 {
@@ -329,69 +557,157 @@ public:
 
     /// @brief Get the `Translation text` of the given `Translation ID` on current language.
     /// @note If the given `Translation ID` is not exist on the current language, return the `Translation ID` itself.
+    /// @note Thread-safe and lock-free.
 #ifndef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
     const char* translate(const std::string& tranId) const
     {
-        return translations_.at(tranId);
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->text(tranId);
     }
 #else
     /// @brief Get the `Translation text` of the given `Translation ID` on current language.
     /// @note If the given `Translation ID` is not exist on the current language, return the `Translation ID` itself.
+    /// @note Thread-safe and lock-free.
     const char* translate(const std::string& tranId)
     {
-        tranIds_.insert(tranId);
-        return translations_.at(tranId);
+        ReadGuard guard(readers_);
+        const Snapshot* snapshot = current_.load(std::memory_order_seq_cst);
+        // The `Translation ID`s of the first loaded `Translations` are always recorded,
+        // so only the missing `Translation ID`s need to be stored.
+        const Snapshot* baseline = baseline_.load(std::memory_order_seq_cst);
+        if (!baseline || !baseline->translations.has(tranId))
+            tranIds_.insert(tranId);
+        return snapshot->text(tranId);
     }
 #endif // EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
 
     /// @brief Set the `Languages` and reset the current language.
-    void setLanguages(const Languages& languages) { languages_ = languages; currentLanguage_.clear(); }
+    void setLanguages(const Languages& languages)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        publish_("", languages, current_.load(std::memory_order_relaxed)->translations, {});
+    }
 
     /// @brief Set the `Languages` that from a json file and reset the current language.
     void setLanguages(const std::string& filename) { setLanguages(Languages::fromFile(filename)); }
 
     /// @brief Get the `Language ID` of the current language.
-    const char* currentLanguage() const { return currentLanguage_.c_str(); }
+    const char* currentLanguage() const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->languageIdText;
+    }
 
     /// @brief Set the current language by `Language ID`.
     /// @return If success to change return true else return false.
     bool setCurrentLanguage(const std::string& languageId)
     {
-        if (!hasLanguage(languageId))
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        // The publish_() copies the languages before it frees the retired snapshots.
+        const Languages& languages = current_.load(std::memory_order_relaxed)->languages;
+        if (!languages.has(languageId))
             return false;
 
     #ifdef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
-        bool isFirst = currentLanguage_.empty();
+        bool isFirst = current_.load(std::memory_order_relaxed)->languageId.empty();
     #endif // !EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
-        currentLanguage_ = languageId;
-        translations_ = Translations::fromFile(languages_.at(languageId));
+        // Flatten the fallback chain into one table.
+        Translations translations;
+        std::vector<std::pair<std::string, size_t>> statistics;
+        for (const auto& id : languages.getFallbackChain(languageId))
+        {
+            size_t supplied = 0;
+            for (const auto& var : Translations::fromFile(languages.at(id)).translations_)
+            {
+                if (var.second.empty() && translations.has(var.first))
+                    continue;
+                auto ret = translations.translations_.insert(var);
+                if (ret.second)
+                {
+                    supplied += !var.second.empty();
+                }
+                else if (ret.first->second.empty())
+                {
+                    ret.first->second = var.second;
+                    supplied++;
+                }
+            }
+            statistics.push_back({ id, supplied });
+        }
+        publish_(languageId, languages, translations, statistics);
 
     #ifdef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
         if (isFirst)
         {
-            for (const auto& var : translations_.translations_)
-                tranIds_.insert(var.first);
+            // Keep the `Translation ID`s of the previous baseline.
+            const Snapshot* baseline = baseline_.load(std::memory_order_relaxed);
+            if (baseline)
+            {
+                for (const auto& var : baseline->translations.translations_)
+                    tranIds_.insert(var.first);
+            }
+            baseline_.store(current_.load(std::memory_order_relaxed), std::memory_order_seq_cst);
         }
     #endif // !EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
 
         return true;
     }
 
-    const Languages& languages() const { return languages_; }
+    Languages languages() const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->languages;
+    }
 
-    const Translations& translations() const { return translations_; }
+    Translations translations() const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->translations;
+    }
+
+    /// @brief Get the number of the `Translation text` that each layer of the fallback chain of the current
+    /// language supplied. {Language ID : Number}
+    std::vector<std::pair<std::string, size_t>> fallbackStatistics() const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->statistics;
+    }
 
     /// @brief Get the number of the `Language ID`.
-    size_t languageCount() const { return languages_.count(); }
+    size_t languageCount() const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->languages.count();
+    }
 
     /// @brief Get the number of the `Translation ID` on current language.
-    size_t translationCount() const { return translations_.count(); }
+    size_t translationCount() const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->translations.count();
+    }
 
     /// @brief Check whether exists the given `Language ID`.
-    bool hasLanguage(const std::string& languageId) const { return languages_.has(languageId); }
+    bool hasLanguage(const std::string& languageId) const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->languages.has(languageId);
+    }
 
     /// @brief Check whether exists the given `Translation ID`.
-    bool hasTranslation(const std::string& tranId) const { return translations_.has(tranId); }
+    bool hasTranslation(const std::string& tranId) const
+    {
+        ReadGuard guard(readers_);
+        return current_.load(std::memory_order_seq_cst)->translations.has(tranId);
+    }
+
+    /// @brief Get the number of the kept snapshots, the current one and the retired ones that are not freed yet.
+    size_t snapshotCount() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return snapshots_.size();
+    }
 
     /// @brief Update all `Translations file`s. (add pairs of the new `Translation ID` and empty `Translation text`)
     /// @return The number of updated files.
@@ -405,57 +721,182 @@ public:
     #ifndef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
         return 0;
     #else
+        std::set<std::string> tranIds;
+        for (const auto& tranId : tranIds_.getIds())
+            tranIds.insert(tranId);
+        const Snapshot* baseline = baseline_.load(std::memory_order_acquire);
+        if (baseline)
+        {
+            for (const auto& var : baseline->translations.translations_)
+                tranIds.insert(var.first);
+        }
+
+        // Each file is merged and written by a worker thread.
+        Languages langs = languages();
+        std::vector<std::string> filenames;
+        for (const auto& languageId : langs.getIds())
+            filenames.push_back(langs.at(languageId));
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> updated{0};
+        auto work = [&]()
+        {
+            for (size_t i = next++; i < filenames.size(); i = next++)
+            {
+                if (updateTranslationsFile_(filenames[i], tranIds))
+                    updated++;
+            }
+        };
+
+        size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), filenames.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; ++i)
+            threads.emplace_back(work);
+        work();
+        for (auto& th : threads)
+            th.join();
+
+        return updated;
+    #endif // EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
+    }
+
+private:
+#ifdef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
+    /// @brief Merge the given `Translation ID`s into a `Translations file`.
+    /// @return If the file is written return true, if the content is unchanged or failed to write return false.
+    /// @note The output is the same as the `nlohmann::json::dump(4)` of the sorted merged object,
+    /// but it is written directly without building the json object.
+    static bool updateTranslationsFile_(const std::string& filename, const std::set<std::string>& tranIds)
+    {
         using Json = nlohmann::json;
 
-        size_t updated = 0;
-        for (const auto& languageId : languages_.getIds())
+        std::string original;
+        bool isOpen = false;
         {
-            std::string filename = languages_.at(languageId);
             std::ifstream ifs(filename);
-            Json j;
-            if (!ifs.is_open())
+            if (ifs.is_open())
             {
-                for (const auto& tranId : tranIds_)
-                    j[tranId] = "";
+                isOpen = true;
+                original.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
             }
-            else
+        }
+
+        Json j;
+        if (isOpen)
+        {
+            j = Json::parse(original, nullptr, false, true);
+            if (j.is_discarded() || !j.is_object())
+                j = Json();
+        }
+
+        std::string content;
+        if (tranIds.empty())
+        {
+            content = j.is_object() ? "{}" : "null";
+        }
+        else
+        {
+            content += "{\n";
+            bool isFirst = true;
+            for (const auto& tranId : tranIds)
             {
-                j = Json::parse(ifs, nullptr, false, true);
-                if (j.is_discarded())
+                if (!isFirst)
+                    content += ",\n";
+                isFirst = false;
+
+                content += "    \"";
+                appendEscaped_(content, tranId);
+                content += "\": \"";
+                if (j.is_object())
                 {
-                    j = Json();
-                    for (const auto& tranId : tranIds_)
-                        j[tranId] = "";
+                    auto it = j.find(tranId);
+                    if (it != j.end() && it->is_string())
+                        appendEscaped_(content, it->get_ref<const std::string&>());
                 }
-                else
-                {
-                    std::map<std::string, std::string> map; // For sort
-                    for (const auto& tranId : tranIds_)
-                        j.contains(tranId) ? map.insert({ tranId, j[tranId] }) : map.insert({ tranId, "" });
+                content += '"';
+            }
+            content += "\n}";
+        }
 
-                    j.clear();
-                    for (const auto& var : map)
-                        j[var.first] = var.second;
-                }
+        if (isOpen && content == original)
+            return false;
 
-                ifs.close();
-            }
+        std::ofstream ofs(filename);
+        if (!ofs.is_open())
+            return false;
+        ofs << content;
+        ofs.close();
+        return true;
+    }
 
-            std::ofstream ofs(filename);
-            if (!ofs.is_open())
-                continue;
+    // Same as the string escaping of the `nlohmann::json::dump()`.
+    static void appendEscaped_(std::string& out, const std::string& str)
+    {
+        static const char* HEX = "0123456789abcdef";
+        for (char ch : str)
+        {
+            switch (ch)
+            {
+                case '"':   out += "\\\""; break;
+                case '\\':  out += "\\\\"; break;
+                case '\b':  out += "\\b"; break;
+                case '\f':  out += "\\f"; break;
+                case '\n':  out += "\\n"; break;
+                case '\r':  out += "\\r"; break;
+                case '\t':  out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(ch) < 0x20)
+                    {
+                        out += "\\u00";
+                        out += HEX[(ch >> 4) & 0x0F];
+                        out += HEX[ch & 0x0F];
+                    }
+                    else
+                    {
+                        out += ch;
+                    }
+                    break;
+            }
+        }
+    }
+#endif // EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
 
-            ofs << j.dump(4);
-            ofs.close();
-            updated++;
+    // The immutable state of a language.
+    struct Snapshot
+    {
+        std::string languageId;
+        Languages languages;
+        Translations translations;
+        std::vector<std::pair<std::string, size_t>> statistics;
+        // The #languageId and the `Translation text`s in the #texts_ pool, they outlive the snapshot.
+        const char* languageIdText = "";
+        std::unordered_map<std::string, const char*> texts;
+
+        const char* text(const std::string& tranId) const
+        {
+            auto it = texts.find(tranId);
+            return it == texts.end() ? tranId.c_str() : it->second;
         }
+    };
 
-        return updated;
-    #endif // EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
-    }
+    // Count the readers in a query function, the retired snapshots are freed only when there is no reader.
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(std::atomic<size_t>& readers) : readers_(readers)
+        { readers_.fetch_add(1, std::memory_order_seq_cst); }
 
-private:
-    TranslateManager() = default;
+        ~ReadGuard() { readers_.fetch_sub(1, std::memory_order_release); }
+
+        ReadGuard(const ReadGuard&) = delete;
+
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        std::atomic<size_t>& readers_;
+    };
+
+    TranslateManager() { publish_("", Languages(), Translations(), {}); }
 
     ~TranslateManager() = default;
 
@@ -463,12 +904,59 @@ private:
 
     TranslateManager& operator=(const TranslateManager&) = delete;
 
+    // Must be called with the #mtx_ locked.
+    const Snapshot* publish_(const std::string& languageId, const Languages& languages,
+        const Translations& translations, const std::vector<std::pair<std::string, size_t>>& statistics)
+    {
+        auto snapshot = new Snapshot{ languageId, languages, translations, statistics, "", {} };
+        snapshot->languageIdText = intern_(languageId);
+        snapshot->texts.reserve(translations.translations_.size());
+        for (const auto& var : translations.translations_)
+            snapshot->texts.insert({ var.first, intern_(var.second) });
+
+        snapshots_.emplace_back(snapshot);
+        current_.store(snapshot, std::memory_order_seq_cst);
+        reclaim_();
+        return snapshot;
+    }
+
+    // Must be called with the #mtx_ locked.
+    // Free the retired snapshots if no reader is in a query function, else they are left to the next publish_().
+    // A reader that enters later loads the current snapshot (or the baseline), which are never freed here.
+    void reclaim_()
+    {
+        if (readers_.load(std::memory_order_seq_cst) != 0)
+            return;
+
+        const Snapshot* current = current_.load(std::memory_order_relaxed);
+    #ifdef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
+        const Snapshot* baseline = baseline_.load(std::memory_order_relaxed);
+    #else
+        const Snapshot* baseline = nullptr;
+    #endif // EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
+        auto isRetired = [&](const std::unique_ptr<Snapshot>& var)
+        { return var.get() != current && var.get() != baseline; };
+        snapshots_.erase(std::remove_if(snapshots_.begin(), snapshots_.end(), isRetired), snapshots_.end());
+    }
+
+    // Must be called with the #mtx_ locked.
+    const char* intern_(const std::string& text) { return texts_.insert(text).first->c_str(); }
+
 #ifdef EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
-    std::set<std::string> tranIds_;
+    // The `Translation ID`s that passed to translate() but not exist in the #baseline_.
+    TranslationIdSet tranIds_;
+    // The snapshot of the first loaded language.
+    std::atomic<const Snapshot*> baseline_{nullptr};
 #endif // !EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES
-    std::string currentLanguage_;
-    Languages languages_;
-    Translations translations_;
+    // Serialize the writers, the readers never lock it.
+    mutable std::mutex mtx_;
+    std::atomic<const Snapshot*> current_{nullptr};
+    // The current snapshot and the retired snapshots that are not freed yet.
+    std::vector<std::unique_ptr<Snapshot>> snapshots_;
+    // The number of the readers in the query functions.
+    mutable std::atomic<size_t> readers_{0};
+    // The distinct `Translation text`s and `Language ID`s, the node addresses are stable.
+    std::unordered_set<std::string> texts_;
 };
 
 // For convenience
@@ -513,12 +1001,17 @@ inline bool hasLanguage(const std::string& languageId)
 inline bool hasTranslation(const std::string& tranId)
 { return getTranslateManager().hasTranslation(tranId); }
 
-inline const Languages& languages()
+inline Languages languages()
 { return getTranslateManager().languages(); }
 
-inline const Translations& translations()
+inline Translations translations()
 { return getTranslateManager().translations(); }
 
+/// @brief Get the number of the `Translation text` that each layer of the fallback chain of the current
+/// language supplied. {Language ID : Number}
+inline std::vector<std::pair<std::string, size_t>> fallbackStatistics()
+{ return getTranslateManager().fallbackStatistics(); }
+
 /// @brief Update all `Translations file`s. (add pairs of the new `Translation ID` and empty `Translation text`)
 /// @return The number of updated files.
 /// @note - The new `Translation ID` is from all `Translation ID` that passed as #tr() function argument in programs.
@@ -29,15 +29,27 @@
 #define MINILOG_HPP
 
 #include <cstddef>          // size_t
-#include <ctime>            // time_t, tm, time, localtime_s, strftime
+#include <cstdint>          // uint64_t
+#include <ctime>            // time_t, tm, localtime_s, localtime_r, strftime
 #include <chrono>           // chrono For #StopWatch
 #include <mutex>            // mutex, lock_guard For thread-safe
+#include <atomic>           // atomic For #RingBuffer
+#include <thread>           // thread For async mode
+#include <condition_variable> // condition_variable For async mode
+#include <memory>           // unique_ptr
+#include <vector>           // vector
+#include <type_traits>      // is_convertible, is_integral
+#include <charconv>         // to_chars
+#include <cstdio>           // snprintf
 #include <string>           // string
 #include <unordered_map>    // unordered_map
 #include <iostream>         // ostream, cout, cerr, clog
 #include <sstream>          // stringstream
 #include <fstream>          // ofstream
+#include <filesystem>       // u8path, rename, remove
 #include <stdexcept>        // runtime_error
+#include <string_view>      // string_view For #Field and the format string
+#include <initializer_list> // initializer_list For #Field
 
 namespace mlog
 {
@@ -62,7 +74,63 @@ enum OutFlag
     OUT_WITH_TIMESTAMP  = 0x02,
     // Whether colorize the output.
     // Just useful for std::cout, std::cerr, std::clog.
-    OUT_WITH_COLORIZE   = 0x04
+    OUT_WITH_COLORIZE   = 0x04,
+    // Output the JSON Lines instead of the text, one object per message.
+    // The level and timestamp are attached as the fields by the #OUT_WITH_LEVEL and #OUT_WITH_TIMESTAMP.
+    // Not included in the #OUT_WITH_ALL.
+    OUT_AS_JSON         = 0x100
+};
+
+/// @brief What to do when the queue of the async mode is full.
+enum OverflowPolicy
+{
+    // Wait until the queue has free space.
+    OVERFLOW_BLOCK          = 0,
+    // Discard the new message.
+    OVERFLOW_DROP           = 1,
+    // Discard the oldest message in the queue.
+    OVERFLOW_DROP_OLDEST    = 2
+};
+
+/// @brief The precision of the fraction part of the timestamp.
+enum TimestampPrecision
+{
+    // e.g. 2025-01-01 12:00:00
+    TIMESTAMP_SECOND        = 0,
+    // e.g. 2025-01-01 12:00:00.123
+    TIMESTAMP_MILLISECOND   = 3,
+    // e.g. 2025-01-01 12:00:00.123456
+    TIMESTAMP_MICROSECOND   = 6
+};
+
+/// @brief When the buffered file stream writes the buffer to the file.
+enum FlushPolicy
+{
+    // Flush after each message.
+    FLUSH_EVERY_MESSAGE     = 0,
+    // Flush when the buffer is full or the #RotatingFileOptions::flushInterval elapsed.
+    // The interval is checked when a message is written, and periodically by the background thread in the async mode.
+    // In the sync mode there is no timer, the buffered messages wait for the next message or the #Logger::flush().
+    FLUSH_INTERVAL          = 1,
+    // Flush when the buffer is full or a message of #LVL_WARNING and above is written.
+    FLUSH_ON_WARNING        = 2
+};
+
+/// @brief The options of the rotating file stream.
+/// The current file is "name", the rotated files are "name.1" (the newest) to "name.#maxFiles".
+struct RotatingFileOptions
+{
+    // Rotate when the file will exceed this size (byte), 0 means no size-based rotation.
+    size_t maxFileSize          = 10 * 1024 * 1024;
+    // Rotate when the file has been opened for this long (second), 0 means no time-based rotation.
+    long long rotateInterval    = 0;
+    // The max number of the retained rotated files, the older files are removed.
+    size_t maxFiles             = 5;
+    // The size of the write buffer (byte).
+    size_t bufferSize           = 64 * 1024;
+    FlushPolicy flushPolicy     = FLUSH_ON_WARNING;
+    // Used by the #FLUSH_INTERVAL (millisecond).
+    long long flushInterval     = 1000;
 };
 
 constexpr int LEVLE_FILTER_ALL    = 0xFF;
@@ -72,6 +140,16 @@ constexpr int OUT_WITH_NONE       = 0x00;
 
 } // namespace mlog
 
+/// @brief The minimum log level that compiled, the log calls of the lower levels are removed entirely.
+/// @note Default is #LVL_WARNING when define the NDEBUG, else is #LVL_DEBUG.
+#ifndef MINILOG_MIN_LEVEL
+#ifdef NDEBUG
+#define MINILOG_MIN_LEVEL 0x04
+#else
+#define MINILOG_MIN_LEVEL 0x01
+#endif // NDEBUG
+#endif // !MINILOG_MIN_LEVEL
+
 namespace mlog
 {
 
@@ -94,102 +172,273 @@ inline String levelToString(Level level)
     }
 }
 
-template <typename T>
-String format(const String& fmt, const T& arg)
+namespace detail
 {
-    std::stringstream ss;
-
-    if (fmt.size() < 4)
-    {
-        size_t pos = fmt.find("{}");
-        if (pos == String::npos)
-            return fmt;
 
-        ss << fmt.substr(0, pos);
-        ss << arg;
+/// @brief Get the buffer of the current thread that used to format the message.
+inline String& threadBuffer()
+{
+    thread_local String buffer;
+    return buffer;
+}
 
-        return ss.str() + fmt.substr(pos + 2);
+/// @brief Append the text of the given value, the result is same as the `std::ostream << value`.
+template <typename T>
+void appendValue(String& out, const T& value)
+{
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        out += value ? '1' : '0';
     }
-
-    String window(4, '\0');
-    for (size_t i = 0; i < fmt.size();)
+    else if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                       std::is_same<T, unsigned char>::value)
+    {
+        out += static_cast<char>(value);
+    }
+    else if constexpr (std::is_integral<T>::value)
+    {
+        char buffer[24];
+        std::to_chars_result ret;
+        if constexpr (std::is_signed<T>::value)
+            ret = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<long long>(value));
+        else
+            ret = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<unsigned long long>(value));
+        out.append(buffer, ret.ptr);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
+    {
+        // The default format of the std::ostream is same as the "%g".
+        char buffer[64];
+        int n = std::snprintf(buffer, sizeof(buffer), "%Lg", static_cast<long double>(value));
+        if (n > 0)
+            out.append(buffer, static_cast<size_t>(n) < sizeof(buffer) ? n : sizeof(buffer) - 1);
+    }
+    else if constexpr (std::is_convertible<const T&, const char*>::value)
+    {
+        const char* str = value;
+        if (str)
+            out += str;
+    }
+    else if constexpr (std::is_convertible<const T&, String>::value)
     {
-        window[0] = fmt[i];
-        window[1] = i < fmt.size() - 1 ? fmt[i + 1] : '\0';
-        window[2] = i < fmt.size() - 2 ? fmt[i + 2] : '\0';
-        window[3] = i < fmt.size() - 3 ? fmt[i + 3] : '\0';
+        out += static_cast<const String&>(value);
+    }
+    else
+    {
+        thread_local std::ostringstream ss;
+        ss.str(String());
+        ss.clear();
+        ss << value;
+        out += ss.str();
+    }
+}
 
-        if (window == "{{}}")
+inline void formatArgs(String&, const char*, size_t, size_t&) {}
+
+// Replace the "{}" by the arguments in order and replace the "{{}}" by the "{}".
+// After the last argument is consumed, the rest of the format string is left to the caller as is.
+template <typename T, typename... Args>
+void formatArgs(String& out, const char* fmt, size_t len, size_t& i, const T& arg, const Args&... args)
+{
+    while (i < len)
+    {
+        if (fmt[i] != '{')
         {
-            ss << "{}";
-            i += 4;
+            size_t j = i + 1;
+            while (j < len && fmt[j] != '{')
+                ++j;
+            out.append(fmt + i, j - i);
+            i = j;
             continue;
         }
 
-        if (window[0] == '{' && window[1] == '}')
+        if (i + 3 < len && fmt[i + 1] == '{' && fmt[i + 2] == '}' && fmt[i + 3] == '}')
         {
-            ss << arg;
-            return ss.str() + fmt.substr(i + 2);
+            out += "{}";
+            i += 4;
+            continue;
         }
-        else
+
+        if (i + 1 < len && fmt[i + 1] == '}')
         {
-            ss << window[0];
-            i += 1;
-            continue;
+            appendValue(out, arg);
+            i += 2;
+            formatArgs(out, fmt, len, i, args...);
+            return;
         }
+
+        out += '{';
+        i += 1;
     }
+}
 
-    return ss.str();
+/// @brief Append the formatted string to the #out in a single pass.
+template <typename... Args>
+void formatTo(String& out, std::string_view fmt, const Args&... args)
+{
+    size_t i = 0;
+    formatArgs(out, fmt.data(), fmt.size(), i, args...);
+    out.append(fmt.substr(i));
 }
 
+} // namespace detail
+
 template <typename T, typename... Args>
 String format(const String& fmt, const T& arg, Args&&... args)
 {
-    std::stringstream ss;
+    String& buffer = detail::threadBuffer();
+    buffer.clear();
+    detail::formatTo(buffer, fmt, arg, args...);
+    return buffer;
+}
 
-    if (fmt.size() < 4)
+/// @brief A typed key-value field of the structured log event, see the #Logger::event().
+/// @note The key and the string value are not copied, they should be valid until the event is logged.
+struct Field
+{
+    enum Type
     {
-        size_t pos = fmt.find("{}");
-        if (pos == String::npos)
-            return fmt;
+        FIELD_BOOL,
+        FIELD_INT,
+        FIELD_UINT,
+        FIELD_FLOAT,
+        FIELD_STRING
+    };
 
-        ss << fmt.substr(0, pos);
-        ss << arg;
+    const char* key = "";
+    Type type       = FIELD_INT;
+    union
+    {
+        bool b;
+        long long i = 0;
+        unsigned long long u;
+        double f;
+    };
+    std::string_view s;
+};
 
-        return ss.str() + fmt.substr(pos + 2);
+template <typename T>
+Field field(const char* key, const T& value)
+{
+    Field f;
+    f.key = key;
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        f.type = Field::FIELD_BOOL;
+        f.b = value;
     }
-
-    String window(4, '\0');
-    for (size_t i = 0; i < fmt.size();)
+    else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value)
+    {
+        f.type = Field::FIELD_INT;
+        f.i = value;
+    }
+    else if constexpr (std::is_integral<T>::value)
+    {
+        f.type = Field::FIELD_UINT;
+        f.u = value;
+    }
+    else if constexpr (std::is_floating_point<T>::value)
+    {
+        f.type = Field::FIELD_FLOAT;
+        f.f = static_cast<double>(value);
+    }
+    else if constexpr (std::is_convertible<const T&, const char*>::value)
+    {
+        f.type = Field::FIELD_STRING;
+        const char* str = value;
+        if (str)
+            f.s = str;
+    }
+    else
     {
-        window[0] = fmt[i];
-        window[1] = i < fmt.size() - 1 ? fmt[i + 1] : '\0';
-        window[2] = i < fmt.size() - 2 ? fmt[i + 2] : '\0';
-        window[3] = i < fmt.size() - 3 ? fmt[i + 3] : '\0';
+        f.type = Field::FIELD_STRING;
+        f.s = value;
+    }
+    return f;
+}
 
-        if (window == "{{}}")
-        {
-            ss << "{}";
-            i += 4;
+namespace detail
+{
+
+/// @brief Get the buffer of the current thread that used to build the JSON of the structured event.
+inline String& threadJsonBuffer()
+{
+    thread_local String buffer;
+    return buffer;
+}
+
+/// @brief Append the quoted and escaped JSON string.
+inline void appendJsonString(String& out, std::string_view str)
+{
+    static const char* HEX = "0123456789abcdef";
+
+    out += '"';
+    size_t begin = 0;
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
             continue;
-        }
 
-        if (window[0] == '{' && window[1] == '}')
-        {
-            ss << arg;
-            return ss.str() + format(fmt.substr(i + 2), std::forward<Args>(args)...);
-        }
-        else
+        out.append(str.data() + begin, i - begin);
+        begin = i + 1;
+        switch (c)
         {
-            ss << window[0];
-            i += 1;
-            continue;
+            case '"':   out += "\\\""; break;
+            case '\\':  out += "\\\\"; break;
+            case '\n':  out += "\\n"; break;
+            case '\r':  out += "\\r"; break;
+            case '\t':  out += "\\t"; break;
+            case '\b':  out += "\\b"; break;
+            case '\f':  out += "\\f"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+                break;
         }
     }
+    out.append(str.data() + begin, str.size() - begin);
+    out += '"';
+}
 
-    return ss.str();
+inline void appendFieldText(String& out, const Field& field)
+{
+    switch (field.type)
+    {
+        case Field::FIELD_BOOL:     appendValue(out, field.b); break;
+        case Field::FIELD_INT:      appendValue(out, field.i); break;
+        case Field::FIELD_UINT:     appendValue(out, field.u); break;
+        case Field::FIELD_FLOAT:    appendValue(out, field.f); break;
+        case Field::FIELD_STRING:   out.append(field.s.data(), field.s.size()); break;
+    }
+}
+
+inline void appendFieldJson(String& out, const Field& field)
+{
+    switch (field.type)
+    {
+        case Field::FIELD_BOOL:
+            out += field.b ? "true" : "false";
+            break;
+        case Field::FIELD_FLOAT:
+            // The JSON has no the NaN and infinity.
+            if (field.f != field.f || field.f - field.f != 0.0)
+                out += "null";
+            else
+                appendValue(out, field.f);
+            break;
+        case Field::FIELD_STRING:
+            appendJsonString(out, field.s);
+            break;
+        default:
+            appendFieldText(out, field);
+            break;
+    }
 }
 
+} // namespace detail
+
 } // namespace mlog
 
 namespace mlog
@@ -223,12 +472,240 @@ private:
     TimePoint<Clock> startTime_;
 };
 
+/// @brief Allow at most N messages per period, the state is per call site (see the #MLOG_RATE_LIMITED).
+/// An allowed call within the limit costs one atomic increment, the clock is read only after the limit is reached.
+/// @note The period is checked when a message exceeds the limit, a new period starts at that message. So the
+/// messages after an idle time are counted in the old period until it's full, then the period starts again.
+class RateLimiter
+{
+public:
+    /// @brief The clock of the rate limiters, return the current time in millisecond.
+    using Clock = long long (*)();
+
+    /// @param maxCount The max number of the messages per period.
+    /// @param period The length of the period (millisecond).
+    RateLimiter(uint32_t maxCount, long long period) :
+        maxCount_(maxCount), period_(period), periodStart_(now())
+    {}
+
+    /// @brief Replace the clock of all rate limiters (e.g. a fake clock in test), nullptr to restore the default.
+    static void setClock(Clock clock) { clock_().store(clock, std::memory_order_relaxed); }
+
+    static long long now()
+    {
+        Clock clock = clock_().load(std::memory_order_relaxed);
+        if (clock)
+            return clock();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// @brief Check whether the message is allowed.
+    /// @param suppressed Set to the number of the messages suppressed since the last report
+    /// when the first message of a new period is allowed, else set to 0.
+    bool tryAcquire(uint64_t& suppressed)
+    {
+        suppressed = 0;
+        if (count_.fetch_add(1, std::memory_order_relaxed) < maxCount_)
+            return true;
+
+        if (!startPeriod_())
+            return false;
+
+        // This message is the first one of the new period, the others over the limit are suppressed.
+        uint64_t count = count_.exchange(1, std::memory_order_relaxed);
+        suppressed = count - 1 > maxCount_ ? count - 1 - maxCount_ : 0;
+        return true;
+    }
+
+    /// @brief Take the number of the messages suppressed since the last report if the period has ended,
+    /// and start a new period, so the suppressed messages are reported without waiting for the next message.
+    /// @param force Take them even if the period has not ended (e.g. at shutdown), the period is kept.
+    /// @return 0 if no message is suppressed or the period has not ended.
+    uint64_t takeSuppressed(bool force = false)
+    {
+        if (count_.load(std::memory_order_relaxed) <= maxCount_ || (!force && !startPeriod_()))
+            return 0;
+
+        uint64_t count = count_.exchange(0, std::memory_order_relaxed);
+        return count > maxCount_ ? count - maxCount_ : 0;
+    }
+
+private:
+    static std::atomic<Clock>& clock_()
+    {
+        static std::atomic<Clock> clock{nullptr};
+        return clock;
+    }
+
+    // Start a new period if the current one has ended, only one of the concurrent callers succeeds.
+    bool startPeriod_()
+    {
+        long long current = now();
+        long long start = periodStart_.load(std::memory_order_relaxed);
+        return current - start >= period_ &&
+            periodStart_.compare_exchange_strong(start, current, std::memory_order_relaxed);
+    }
+
+    const uint64_t maxCount_;
+    const long long period_;
+    std::atomic<long long> periodStart_;
+    std::atomic<uint64_t> count_{0};
+};
+
+/// @brief Allow one of every N messages, the state is per call site (see the #MLOG_SAMPLED).
+class Sampler
+{
+public:
+    explicit Sampler(uint32_t rate) : rate_(rate == 0 ? 1 : rate) {}
+
+    bool tryAcquire() { return count_.fetch_add(1, std::memory_order_relaxed) % rate_ == 0; }
+
+private:
+    const uint64_t rate_;
+    std::atomic<uint64_t> count_{0};
+};
+
+/// @brief The time of a log message.
+struct Timestamp
+{
+    // Used by the absolute timestamp.
+    std::chrono::system_clock::time_point wall;
+    // Used by the relative timestamp.
+    std::chrono::steady_clock::time_point mono;
+};
+
+/// @brief A bounded multi-producer multi-consumer queue of log records, based on the Dmitry Vyukov's design.
+/// @note The slots are preallocated, and the message buffer of a slot is reused, so the push and pop don't
+/// allocate once the buffers are warm.
+class RingBuffer
+{
+public:
+    struct Record
+    {
+        Level level = LVL_INFO;
+        Timestamp time;
+        String message;
+        // The JSON fields of the structured event, empty for the plain message.
+        String json;
+    };
+
+    /// @param capacity Will be rounded up to the power of 2.
+    explicit RingBuffer(size_t capacity)
+    {
+        size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        mask_ = cap - 1;
+        slots_.reset(new Slot[cap]);
+        for (size_t i = 0; i < cap; ++i)
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /// @return If the queue is full return false.
+    bool tryPush(Level level, const Timestamp& time, const String& message, const String& json)
+    {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true)
+        {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->record.level = level;
+        slot->record.time = time;
+        slot->record.message.assign(message);
+        slot->record.json.assign(json);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Pop the oldest record, the message buffers of the #record are swapped with the slot.
+    /// @return If the queue is empty return false.
+    bool tryPop(Record& record)
+    {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true)
+        {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        record.level = slot->record.level;
+        record.time = slot->record.time;
+        record.message.swap(slot->record.message);
+        record.json.swap(slot->record.json);
+        slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        size_t pos = dequeuePos_.load(std::memory_order_acquire);
+        size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> seq{0};
+        Record record;
+    };
+
+    // Separate the producers and the consumer position to avoid false sharing.
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+    size_t mask_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+};
+
 class Logger
 {
 public:
     Logger() = default;
 
-    ~Logger() { removeAllOs(); }
+    ~Logger()
+    {
+        disableAsync();
+        removeAllOs();
+    }
 
     Logger(const Logger& other) = delete;
 
@@ -262,8 +739,10 @@ public:
 
         OutStream* os_ = new OutStream(&os, outflag, levelFilter);
         outs_.insert({ nameid, os_ });
+        updateEnabledLevels_();
     }
 
+    /// @param filename The UTF-8 file name, on Windows it is not the ANSI code page.
     void addOs(const String& nameid, const String& filename,
         int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
     {
@@ -274,6 +753,22 @@ public:
 
         OutStream* os_ = new FileOutStream(filename, outflag, levelFilter);
         outs_.insert({ nameid, os_} );
+        updateEnabledLevels_();
+    }
+
+    /// @brief Add a buffered file stream that rotates by the size or time.
+    /// @param filename The UTF-8 file name, on Windows it is not the ANSI code page.
+    void addOs(const String& nameid, const String& filename, const RotatingFileOptions& options,
+        int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (outs_.find(nameid) != outs_.end())
+            throw std::runtime_error("The name id is already exist");
+
+        OutStream* os_ = new RotatingFileOutStream(filename, options, outflag, levelFilter);
+        outs_.insert({ nameid, os_} );
+        updateEnabledLevels_();
     }
 
     void removeOs(const String& nameid)
@@ -284,6 +779,7 @@ public:
         outs_[nameid] = nullptr;
 
         outs_.erase(nameid);
+        updateEnabledLevels_();
     }
 
     void removeAllOs()
@@ -297,6 +793,7 @@ public:
         }
 
         outs_.clear();
+        updateEnabledLevels_();
     }
 
     void setOsAttribute(const String& nameid, int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
@@ -308,89 +805,216 @@ public:
 
         outs_[nameid]->outflag = outflag;
         outs_[nameid]->levelFilter = levelFilter;
+        outs_[nameid]->updateStyle();
+        updateEnabledLevels_();
     }
 
-    template <Level level, typename T>
-    void log(const T& message)
+    /// @brief Set the global level mask, the messages of the masked out levels are discarded before formatting.
+    /// @note The effective mask is this mask and the union of the level filter of all streams.
+    void setLevelMask(int levelMask)
     {
-        String curtimeStr = currentTimeString_();
-        String levelStr = levelToString(level);
+        std::lock_guard<std::mutex> lock(mtx_);
+        levelMask_ = levelMask;
+        updateEnabledLevels_();
+    }
+
+    int levelMask() const { return levelMask_; }
 
+    /// @brief Set the precision of the fraction part of the timestamp, default is #TIMESTAMP_SECOND.
+    void setTimestampPrecision(TimestampPrecision precision)
+    {
         std::lock_guard<std::mutex> lock(mtx_);
+        precision_ = precision;
+    }
 
-        for (auto& var : outs_)
-        {
-            OutStream* os = var.second;
+    /// @brief Whether the timestamp is the monotonic seconds since the logger is created
+    /// (or since the last call of the #resetRelativeTime()), e.g. +12.345678.
+    void setRelativeTime(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        isRelativeTime_.store(enable, std::memory_order_relaxed);
+    }
 
-            if (!(level & os->levelFilter))
-                continue;
+    /// @brief Reset the start time of the relative timestamp to now.
+    void resetRelativeTime()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        relativeStart_ = std::chrono::steady_clock::now();
+    }
 
-            bool isConsole = os->os == &std::cout || os->os == &std::cerr || os->os == &std::clog;
-            bool isColorize = isConsole && (os->outflag & OUT_WITH_COLORIZE);
+    /// @brief Check whether the message of the given level will be written by any stream.
+    template <Level level>
+    bool isEnabled() const
+    {
+        if constexpr (level < MINILOG_MIN_LEVEL)
+            return false;
+        else
+            return (enabledLevels_.load(std::memory_order_relaxed) & level) != 0;
+    }
 
-            std::stringstream ss;
+    /// @brief Enable the async mode, the messages are pushed into a queue and written by a background thread.
+    /// @param capacity The max number of the queued messages.
+    /// @param policy What to do when the queue is full.
+    /// @note If already enabled, do nothing.
+    /// @attention Should be called before other threads start to log.
+    void enableAsync(size_t capacity = 8192, OverflowPolicy policy = OVERFLOW_BLOCK)
+    {
+        std::lock_guard<std::mutex> lock(asyncMtx_);
 
-            if (os->outflag & OUT_WITH_TIMESTAMP)
-            {
-                ss << (isColorize ? "\033[0m\033[1;30m" : "");
-                ss << curtimeStr;
-                ss << (isColorize ? "\033[0m" : "");
-                ss << ' ';
-            }
+        if (async_.load(std::memory_order_relaxed))
+            return;
 
-            if (os->outflag & OUT_WITH_LEVEL)
-            {
-                if (isColorize)
-                {
-                    switch (level)
-                    {
-                        case LVL_DEBUG:     // Blue
-                            ss << "\033[0m\033[34m";
-                            break;
-                        case LVL_INFO:      // Green
-                            ss << "\033[0m\033[32m";
-                            break;
-                        case LVL_WARNING:   // Yellow
-                            ss << "\033[0m\033[33m";
-                            break;
-                        case LVL_ERROR:     // Red
-                            ss << "\033[0m\033[31m";
-                            break;
-                        case LVL_FATAL:     // Purple
-                            ss << "\033[0m\033[35m";
-                            break;
-                        default:
-                            ss << "\033[0m";
-                            break;
-                    }
-                }
+        queue_.reset(new RingBuffer(capacity));
+        policy_ = policy;
+        stop_.store(false, std::memory_order_relaxed);
+        worker_ = std::thread(&Logger::consume_, this);
+        async_.store(true, std::memory_order_release);
+    }
 
-                ss << levelStr;
-                ss << (isColorize ? "\033[0m" : "");
-                ss << ' ';
-            }
+    /// @brief Disable the async mode, all queued messages are written before return.
+    /// @note Other threads may keep logging, the messages being pushed are queued and written before return,
+    /// the later messages are written synchronously. The queue is kept until the async mode is enabled again
+    /// or the logger is destroyed.
+    void disableAsync()
+    {
+        std::lock_guard<std::mutex> lock(asyncMtx_);
+
+        if (!async_.load(std::memory_order_relaxed))
+            return;
 
-            ss << message << "\n";
+        // Pairs with the #push_(), either we wait for the producer or it sees the async mode disabled.
+        async_.store(false, std::memory_order_seq_cst);
+        while (pushers_.load(std::memory_order_seq_cst) != 0)
+            std::this_thread::yield();
 
-            if (os->os)
-                *os->os << ss.str();
+        {
+            std::lock_guard<std::mutex> waitLock(waitMtx_);
+            stop_.store(true, std::memory_order_relaxed);
+        }
+        waitCv_.notify_one();
+        worker_.join();
+    }
+
+    bool isAsync() const { return async_.load(std::memory_order_acquire); }
+
+    /// @brief Wait until all queued messages are written (async mode) and flush all streams.
+    void flush()
+    {
+        if (async_.load(std::memory_order_acquire))
+        {
+            uint64_t target = enqueued_.load(std::memory_order_acquire);
+            while (processed_.load(std::memory_order_acquire) < target)
+            {
+                wakeConsumer_();
+                std::this_thread::yield();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& var : outs_)
+        {
+            if (var.second->os)
+                var.second->flush();
         }
     }
 
+    /// @brief Get the number of the messages discarded by the #OVERFLOW_DROP and #OVERFLOW_DROP_OLDEST policy.
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
     template <Level level, typename T>
-    void log(const String& message, const T& arg) { log<level>(format(message, arg)); }
+    void log(const T& message)
+    {
+        if (!isEnabled<level>())
+            return;
+
+        if constexpr (std::is_same<T, String>::value)
+        {
+            logString_(level, message);
+        }
+        else
+        {
+            String& buffer = detail::threadBuffer();
+            buffer.clear();
+            detail::appendValue(buffer, message);
+            logString_(level, buffer);
+        }
+    }
 
+    /// @note The format string is taken as the std::string_view, so a disabled call doesn't construct a String.
     template <Level level, typename T, typename... Args>
-    void log(const String& message, const T& arg, Args&&... args)
+    void log(std::string_view message, const T& arg, Args&&... args)
+    {
+        if (!isEnabled<level>())
+            return;
+
+        String& buffer = detail::threadBuffer();
+        buffer.clear();
+        detail::formatTo(buffer, message, arg, args...);
+        logString_(level, buffer);
+    }
+
+    /// @brief Log the formatted message with the given time instead of the current time,
+    /// e.g. replay the records decoded from the binary log.
+    /// @note The #Timestamp::wall is used in the absolute mode and the #Timestamp::mono in the relative mode.
+    void logAt(Level level, const Timestamp& time, const String& message)
+    {
+        if (!(enabledLevels_.load(std::memory_order_relaxed) & level))
+            return;
+
+        if (async_.load(std::memory_order_acquire) && push_(level, time, message, String()))
+            return;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        write_(level, time, message, String());
+    }
+
+    /// @brief Log a structured event with the typed fields, e.g.
+    /// `event<LVL_WARNING>("Failed to add the hotkey", { field("hotkey", kc), field("rc", rc) })`.
+    /// The text streams write "message, key: value, ...", the #OUT_AS_JSON streams write the fields as is.
+    /// @note The text or JSON is built only if any stream of that kind accepts the level.
+    template <Level level>
+    void event(const String& message, std::initializer_list<Field> fields)
     {
-        log<level>(format(message, arg, std::forward<Args>(args)...));
+        if (!isEnabled<level>())
+            return;
+
+        String& text = detail::threadBuffer();
+        text.clear();
+        if (textLevels_.load(std::memory_order_relaxed) & level)
+        {
+            text += message;
+            for (const auto& field : fields)
+            {
+                text += ", ";
+                text += field.key;
+                text += ": ";
+                detail::appendFieldText(text, field);
+            }
+        }
+
+        String& json = detail::threadJsonBuffer();
+        json.clear();
+        if (jsonLevels_.load(std::memory_order_relaxed) & level)
+        {
+            json += "\"msg\":";
+            detail::appendJsonString(json, message);
+            for (const auto& field : fields)
+            {
+                json += ',';
+                detail::appendJsonString(json, field.key);
+                json += ':';
+                detail::appendFieldJson(json, field);
+            }
+        }
+
+        logString_(level, text, json);
     }
 
     template <typename T>
     void debug(const T& message) { log<LVL_DEBUG>(message); }
 
     template <typename T, typename... Args>
-    void debug(const String& message, const T& arg, Args&&... args)
+    void debug(std::string_view message, const T& arg, Args&&... args)
     {
         log<LVL_DEBUG>(message, arg, std::forward<Args>(args)...);
     }
@@ -399,7 +1023,7 @@ public:
     void info(const T& message) { log<LVL_INFO>(message); }
 
     template <typename T, typename... Args>
-    void info(const String& message, const T& arg, Args&&... args)
+    void info(std::string_view message, const T& arg, Args&&... args)
     {
         log<LVL_INFO>(message, arg, std::forward<Args>(args)...);
     }
@@ -408,7 +1032,7 @@ public:
     void warning(const T& message) { log<LVL_WARNING>(message); }
 
     template <typename T, typename... Args>
-    void warning(const String& message, const T& arg, Args&&... args)
+    void warning(std::string_view message, const T& arg, Args&&... args)
     {
         log<LVL_WARNING>(message, arg, std::forward<Args>(args)...);
     }
@@ -417,7 +1041,7 @@ public:
     void error(const T& message) { log<LVL_ERROR>(message); }
 
     template <typename T, typename... Args>
-    void error(const String& message, const T& arg, Args&&... args)
+    void error(std::string_view message, const T& arg, Args&&... args)
     {
         log<LVL_ERROR>(message, arg, std::forward<Args>(args)...);
     }
@@ -426,7 +1050,7 @@ public:
     void fatal(const T& message) { log<LVL_FATAL>(message); }
 
     template <typename T, typename... Args>
-    void fatal(const String& message, const T& arg, Args&&... args)
+    void fatal(std::string_view message, const T& arg, Args&&... args)
     {
         log<LVL_FATAL>(message, arg, std::forward<Args>(args)...);
     }
@@ -435,20 +1059,50 @@ private:
     struct OutStream
     {
         OutStream(std::ostream* os, int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
-            : os(os), outflag(outflag), levelFilter(levelFilter)
-        {}
+            : outflag(outflag), levelFilter(levelFilter), os(os)
+        {
+            updateStyle();
+        }
 
         virtual ~OutStream() { os = nullptr; }
 
+        // Write the rendered message (include the newline).
+        virtual void write(Level, const String& text)
+        {
+            os->write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+
+        virtual void flush() { os->flush(); }
+
+        // Called periodically (by the background thread of the async mode) to do the time-based works.
+        virtual void tick() {}
+
+        // Should be called after the #outflag or #os changed.
+        void updateStyle()
+        {
+            if (outflag & OUT_AS_JSON)
+            {
+                style = JSON_STYLE_ + (outflag & (OUT_WITH_LEVEL | OUT_WITH_TIMESTAMP));
+                return;
+            }
+
+            bool isConsole = os == &std::cout || os == &std::cerr || os == &std::clog;
+            style = outflag & (OUT_WITH_LEVEL | OUT_WITH_TIMESTAMP);
+            if (isConsole && (outflag & OUT_WITH_COLORIZE))
+                style |= OUT_WITH_COLORIZE;
+        }
+
         int outflag       = OUT_WITH_ALL;
         int levelFilter   = LEVLE_FILTER_ALL;
+        // The effective #OutFlag, the streams with the same style share the rendered message.
+        int style         = OUT_WITH_NONE;
         std::ostream* os    = nullptr;
     };
 
     struct FileOutStream final : public OutStream
     {
         FileOutStream(const String& filename, int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
-            : OutStream(new std::ofstream(filename, std::ios_base::app), outflag, levelFilter)
+            : OutStream(new std::ofstream(std::filesystem::u8path(filename), std::ios_base::app), outflag, levelFilter)
         {
             if (!os || !dynamic_cast<std::ofstream*>(os)->is_open())
                 throw std::runtime_error("Failed to open the file: " + filename);
@@ -464,22 +1118,547 @@ private:
         }
     };
 
-    static String currentTimeString_()
+    // The messages are buffered and written to the file by the #RotatingFileOptions::flushPolicy,
+    // the file is rotated by the size or time.
+    struct RotatingFileOutStream final : public OutStream
+    {
+        using Clock = std::chrono::steady_clock;
+
+        RotatingFileOutStream(const String& filename, const RotatingFileOptions& options,
+            int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
+            : OutStream(nullptr, outflag, levelFilter), filename(filename), options(options)
+        {
+            buffer.reserve(options.bufferSize);
+            if (!open_())
+                throw std::runtime_error("Failed to open the file: " + filename);
+            lastFlushTime = Clock::now();
+        }
+
+        ~RotatingFileOutStream()
+        {
+            writeBuffer_();
+            ofs.close();
+            os = nullptr;
+        }
+
+        void write(Level level, const String& text) override
+        {
+            if (shouldRotate_(text.size()))
+                rotate_();
+
+            buffer += text;
+            fileSize += text.size();
+
+            bool isFlush = buffer.size() >= options.bufferSize;
+            switch (options.flushPolicy)
+            {
+                case FLUSH_EVERY_MESSAGE:
+                    isFlush = true;
+                    break;
+                case FLUSH_INTERVAL:
+                    isFlush = isFlush || isFlushIntervalElapsed_();
+                    break;
+                case FLUSH_ON_WARNING:
+                    isFlush = isFlush || level >= LVL_WARNING;
+                    break;
+            }
+
+            if (isFlush)
+                flush();
+        }
+
+        void flush() override
+        {
+            writeBuffer_();
+            ofs.flush();
+            lastFlushTime = Clock::now();
+        }
+
+        void tick() override
+        {
+            if (!buffer.empty() && options.flushPolicy == FLUSH_INTERVAL && isFlushIntervalElapsed_())
+                flush();
+        }
+
+        String filename;
+        RotatingFileOptions options;
+        std::ofstream ofs;
+        String buffer;
+        // The size of the current file, include the buffered messages.
+        size_t fileSize = 0;
+        Clock::time_point openTime;
+        Clock::time_point lastFlushTime;
+
+    private:
+        bool open_()
+        {
+            ofs.open(std::filesystem::u8path(filename), std::ios_base::app | std::ios_base::ate);
+            if (!ofs.is_open())
+                return false;
+
+            auto pos = ofs.tellp();
+            fileSize = pos > 0 ? static_cast<size_t>(pos) : 0;
+            openTime = Clock::now();
+            os = &ofs;
+            return true;
+        }
+
+        bool shouldRotate_(size_t incoming) const
+        {
+            if (options.maxFileSize != 0 && fileSize != 0 && fileSize + incoming > options.maxFileSize)
+                return true;
+
+            return options.rotateInterval != 0 &&
+                Clock::now() - openTime >= std::chrono::seconds(options.rotateInterval);
+        }
+
+        bool isFlushIntervalElapsed_() const
+        {
+            return Clock::now() - lastFlushTime >= std::chrono::milliseconds(options.flushInterval);
+        }
+
+        void writeBuffer_()
+        {
+            if (buffer.empty())
+                return;
+
+            ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+
+        // "name.N-1" -> "name.N", ..., "name" -> "name.1", the "name.#maxFiles" is removed.
+        void rotate_()
+        {
+            writeBuffer_();
+            ofs.close();
+
+            auto path = [this](size_t index)
+            { return std::filesystem::u8path(index == 0 ? filename : filename + '.' + std::to_string(index)); };
+            std::error_code ec;
+            if (options.maxFiles == 0)
+            {
+                std::filesystem::remove(path(0), ec);
+            }
+            else
+            {
+                std::filesystem::remove(path(options.maxFiles), ec);
+                for (size_t i = options.maxFiles; i > 0; --i)
+                    std::filesystem::rename(path(i - 1), path(i), ec);
+            }
+
+            // The stream is skipped if failed to reopen the file.
+            if (!open_())
+                os = nullptr;
+        }
+    };
+
+    void logString_(Level level, const String& message, const String& json = String())
+    {
+        Timestamp time;
+        if (isRelativeTime_.load(std::memory_order_relaxed))
+            time.mono = std::chrono::steady_clock::now();
+        else
+            time.wall = std::chrono::system_clock::now();
+
+        if (async_.load(std::memory_order_acquire) && push_(level, time, message, json))
+            return;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        write_(level, time, message, json);
+    }
+
+    // Must be called with the #mtx_ locked.
+    void updateEnabledLevels_()
+    {
+        int textLevels = LEVEL_FILTER_NONE;
+        int jsonLevels = LEVEL_FILTER_NONE;
+        for (const auto& var : outs_)
+        {
+            if (var.second->outflag & OUT_AS_JSON)
+                jsonLevels |= var.second->levelFilter;
+            else
+                textLevels |= var.second->levelFilter;
+        }
+        textLevels_.store(textLevels & levelMask_, std::memory_order_relaxed);
+        jsonLevels_.store(jsonLevels & levelMask_, std::memory_order_relaxed);
+        enabledLevels_.store((textLevels | jsonLevels) & levelMask_, std::memory_order_relaxed);
+    }
+
+    // Must be called with the #mtx_ locked.
+    // The message is rendered once per distinct style and the buffer is shared by the streams of that style.
+    // The #json is the fields of the structured event, empty for the plain message.
+    void write_(Level level, const Timestamp& time, const String& message, const String& json)
+    {
+        bool isRendered[STYLE_COUNT_] = {};
+        String curtimeStr;
+
+        for (auto& var : outs_)
+        {
+            OutStream* os = var.second;
+
+            if (!(level & os->levelFilter) || !os->os)
+                continue;
+
+            String& buffer = renderBuffers_[os->style];
+            if (!isRendered[os->style])
+            {
+                if ((os->style & OUT_WITH_TIMESTAMP) && curtimeStr.empty())
+                    formatTimestamp_(curtimeStr, time);
+                if (os->style >= JSON_STYLE_)
+                    renderJson_(buffer, os->style - JSON_STYLE_, level, curtimeStr, message, json);
+                else
+                    render_(buffer, os->style, level, curtimeStr, message);
+                isRendered[os->style] = true;
+            }
+
+            os->write(level, buffer);
+        }
+    }
+
+    static void render_(String& buffer, int style, Level level, const String& curtimeStr, const String& message)
+    {
+        bool isColorize = (style & OUT_WITH_COLORIZE) != 0;
+
+        buffer.clear();
+
+        if (style & OUT_WITH_TIMESTAMP)
+        {
+            if (isColorize)
+                buffer += "\033[0m\033[1;30m";
+            buffer += curtimeStr;
+            if (isColorize)
+                buffer += "\033[0m";
+            buffer += ' ';
+        }
+
+        if (style & OUT_WITH_LEVEL)
+        {
+            if (isColorize)
+            {
+                switch (level)
+                {
+                    case LVL_DEBUG:     // Blue
+                        buffer += "\033[0m\033[34m";
+                        break;
+                    case LVL_INFO:      // Green
+                        buffer += "\033[0m\033[32m";
+                        break;
+                    case LVL_WARNING:   // Yellow
+                        buffer += "\033[0m\033[33m";
+                        break;
+                    case LVL_ERROR:     // Red
+                        buffer += "\033[0m\033[31m";
+                        break;
+                    case LVL_FATAL:     // Purple
+                        buffer += "\033[0m\033[35m";
+                        break;
+                    default:
+                        buffer += "\033[0m";
+                        break;
+                }
+            }
+
+            buffer += levelToString(level);
+            if (isColorize)
+                buffer += "\033[0m";
+            buffer += ' ';
+        }
+
+        buffer += message;
+        buffer += '\n';
+    }
+
+    // One JSON object per line, e.g. {"time":"2025-01-01 12:00:00","level":"Info","msg":"..."}.
+    static void renderJson_(String& buffer, int style, Level level, const String& curtimeStr,
+        const String& message, const String& json)
+    {
+        buffer.clear();
+        buffer += '{';
+
+        if (style & OUT_WITH_TIMESTAMP)
+        {
+            buffer += "\"time\":";
+            detail::appendJsonString(buffer, curtimeStr);
+            buffer += ',';
+        }
+
+        if (style & OUT_WITH_LEVEL)
+        {
+            buffer += "\"level\":";
+            switch (level)
+            {
+                case LVL_DEBUG:     buffer += "\"Debug\","; break;
+                case LVL_INFO:      buffer += "\"Info\","; break;
+                case LVL_WARNING:   buffer += "\"Warning\","; break;
+                case LVL_ERROR:     buffer += "\"Error\","; break;
+                case LVL_FATAL:     buffer += "\"Fatal\","; break;
+                default:            buffer += "\"\","; break;
+            }
+        }
+
+        if (json.empty())
+        {
+            buffer += "\"msg\":";
+            detail::appendJsonString(buffer, message);
+        }
+        else
+        {
+            buffer += json;
+        }
+
+        buffer += "}\n";
+    }
+
+    // Return false if the async mode is disabled meanwhile, then the caller writes the message synchronously.
+    bool push_(Level level, const Timestamp& time, const String& message, const String& json)
+    {
+        // Pairs with the #disableAsync(), the queue is not touched once the async mode is seen disabled.
+        pushers_.fetch_add(1, std::memory_order_seq_cst);
+        if (!async_.load(std::memory_order_seq_cst))
+        {
+            pushers_.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        while (!queue_->tryPush(level, time, message, json))
+        {
+            if (policy_ == OVERFLOW_DROP)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                pushers_.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+
+            if (policy_ == OVERFLOW_DROP_OLDEST)
+            {
+                thread_local RingBuffer::Record discarded;
+                if (queue_->tryPop(discarded))
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    processed_.fetch_add(1, std::memory_order_release);
+                }
+                continue;
+            }
+
+            // OVERFLOW_BLOCK
+            wakeConsumer_();
+            std::this_thread::yield();
+        }
+
+        enqueued_.fetch_add(1, std::memory_order_release);
+        wakeConsumer_();
+        pushers_.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void wakeConsumer_()
+    {
+        // Pairs with the fence in the #consume_(), either the consumer sees the new record or we see it sleeping.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(waitMtx_);
+            waitCv_.notify_one();
+        }
+    }
+
+    // The background thread of the async mode.
+    void consume_()
+    {
+        RingBuffer::Record record;
+        while (true)
+        {
+            if (queue_->tryPop(record))
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                do
+                {
+                    write_(record.level, record.time, record.message, record.json);
+                    processed_.fetch_add(1, std::memory_order_release);
+                } while (queue_->tryPop(record));
+                continue;
+            }
+
+            if (stop_.load(std::memory_order_relaxed))
+                break;
+
+            std::unique_lock<std::mutex> lock(waitMtx_);
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // The timeout is a safety net, the producers wake up the consumer normally.
+            waitCv_.wait_for(lock, std::chrono::milliseconds(100), [this]()
+            { return stop_.load(std::memory_order_relaxed) || !queue_->empty(); });
+            sleeping_.store(false, std::memory_order_relaxed);
+            lock.unlock();
+
+            tick_();
+        }
+    }
+
+    void tick_()
     {
-        time_t time = 0;
-        ::time(&time);
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& var : outs_)
+        {
+            if (var.second->os)
+                var.second->tick();
+        }
+    }
+
+    static bool localTime_(time_t time, tm& lt)
+    {
+    #ifdef _WIN32
+        return ::localtime_s(&lt, &time) == 0;
+    #else
+        return ::localtime_r(&time, &lt) != nullptr;
+    #endif // _WIN32
+    }
+
+    // Append the fraction part with the given number of digits.
+    static void appendFraction_(String& out, long long value, int digits)
+    {
+        char buffer[8];
+        buffer[0] = '.';
+        for (int i = digits; i > 0; --i)
+        {
+            buffer[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        out.append(buffer, static_cast<size_t>(digits) + 1);
+    }
+
+    // Must be called with the #mtx_ locked.
+    // The date and time part is formatted once per second and cached.
+    void formatTimestamp_(String& out, const Timestamp& time)
+    {
+        using namespace std::chrono;
+
+        out.clear();
 
-        tm lt;
-        ::localtime_s(&lt, &time);
+        if (isRelativeTime_.load(std::memory_order_relaxed))
+        {
+            long long us = duration_cast<microseconds>(time.mono - relativeStart_).count();
+            if (us < 0)
+                us = 0;
+            out += '+';
+            detail::appendValue(out, us / 1000000);
+            if (precision_ == TIMESTAMP_MILLISECOND)
+                appendFraction_(out, us % 1000000 / 1000, 3);
+            else if (precision_ == TIMESTAMP_MICROSECOND)
+                appendFraction_(out, us % 1000000, 6);
+            return;
+        }
+
+        auto sinceEpoch = duration_cast<microseconds>(time.wall.time_since_epoch()).count();
+        long long seconds = sinceEpoch / 1000000;
+        long long us = sinceEpoch % 1000000;
+        if (us < 0)
+        {
+            seconds -= 1;
+            us += 1000000;
+        }
 
-        char buffer[32] = {};
-        ::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &lt);
+        if (seconds != cachedSecond_)
+        {
+            tm lt = {};
+            cachedPrefixSize_ = 0;
+            if (localTime_(static_cast<time_t>(seconds), lt))
+                cachedPrefixSize_ = ::strftime(cachedPrefix_, sizeof(cachedPrefix_), "%Y-%m-%d %H:%M:%S", &lt);
+            cachedSecond_ = seconds;
+        }
 
-        return buffer;
+        out.append(cachedPrefix_, cachedPrefixSize_);
+        if (precision_ == TIMESTAMP_MILLISECOND)
+            appendFraction_(out, us / 1000, 3);
+        else if (precision_ == TIMESTAMP_MICROSECOND)
+            appendFraction_(out, us, 6);
     }
 
+    // The text styles are [0, JSON_STYLE_), the JSON styles are JSON_STYLE_ + (#OUT_WITH_LEVEL | #OUT_WITH_TIMESTAMP).
+    static constexpr int JSON_STYLE_ = (OUT_WITH_LEVEL | OUT_WITH_TIMESTAMP | OUT_WITH_COLORIZE) + 1;
+    static constexpr int STYLE_COUNT_ = JSON_STYLE_ + (OUT_WITH_LEVEL | OUT_WITH_TIMESTAMP) + 1;
+
     std::unordered_map<String, OutStream*> outs_;
     std::mutex mtx_;
+    // The rendered message of each style, reused for each message.
+    String renderBuffers_[STYLE_COUNT_];
+
+    // Timestamp.
+    TimestampPrecision precision_ = TIMESTAMP_SECOND;
+    std::atomic<bool> isRelativeTime_{false};
+    std::chrono::steady_clock::time_point relativeStart_ = std::chrono::steady_clock::now();
+    long long cachedSecond_ = -1;
+    char cachedPrefix_[32] = {};
+    size_t cachedPrefixSize_ = 0;
+    int levelMask_ = LEVLE_FILTER_ALL;
+    // The levels that any stream accepts and not masked out, checked before formatting.
+    // The levels accepted by the text streams and the #OUT_AS_JSON streams, #enabledLevels_ is the union of them.
+    std::atomic<int> textLevels_{LEVEL_FILTER_NONE};
+    std::atomic<int> jsonLevels_{LEVEL_FILTER_NONE};
+    std::atomic<int> enabledLevels_{LEVEL_FILTER_NONE};
+
+    // Async mode.
+    std::atomic<bool> async_{false};
+    std::mutex asyncMtx_;
+    std::unique_ptr<RingBuffer> queue_;
+    OverflowPolicy policy_ = OVERFLOW_BLOCK;
+    std::thread worker_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> sleeping_{false};
+    // The number of the threads in the #push_(), #disableAsync() waits until they finish.
+    std::atomic<int> pushers_{0};
+    std::mutex waitMtx_;
+    std::condition_variable waitCv_;
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+/// @brief The #RateLimiter of a #MLOG_RATE_LIMITED call site, the sites are registered so the #reportAll()
+/// (called by the #mlog::flush()) can report the suppressed messages of the sites that don't log again.
+/// @note The sites are static and never unregistered.
+class RateLimitedSite final : public RateLimiter
+{
+public:
+    RateLimitedSite(Level level, const char* file, int line, uint32_t maxCount, long long period) :
+        RateLimiter(maxCount, period), level_(level), file_(file), line_(line),
+        next_(head_().load(std::memory_order_relaxed))
+    {
+        while (!head_().compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed))
+        {}
+    }
+
+    /// @brief Log the summary of every site whose period has ended with the suppressed messages,
+    /// to the global Logger.
+    /// @param force Also report the sites whose period has not ended, e.g. at shutdown.
+    static void reportAll(bool force = false)
+    {
+        for (RateLimitedSite* site = head_().load(std::memory_order_acquire); site; site = site->next_)
+        {
+            uint64_t suppressed = site->takeSuppressed(force);
+            if (suppressed == 0)
+                continue;
+
+            Timestamp time;
+            time.wall = std::chrono::system_clock::now();
+            time.mono = std::chrono::steady_clock::now();
+            Logger::getGlobalInstance().logAt(site->level_, time, "Suppressed " + std::to_string(suppressed) +
+                " messages of the call site " + site->file_ + ':' + std::to_string(site->line_) +
+                " since the last report");
+        }
+    }
+
+private:
+    static std::atomic<RateLimitedSite*>& head_()
+    {
+        static std::atomic<RateLimitedSite*> head{nullptr};
+        return head;
+    }
+
+    const Level level_;
+    const char* const file_;
+    const int line_;
+    RateLimitedSite* next_;
 };
 
 }
@@ -499,6 +1678,12 @@ inline void addOs(const String& nameid, const String& filename,
     Logger::getGlobalInstance().addOs(nameid, filename, outflag, levelFilter);
 }
 
+inline void addOs(const String& nameid, const String& filename, const RotatingFileOptions& options,
+    int outflag = OUT_WITH_ALL, int levelFilter = LEVLE_FILTER_ALL)
+{
+    Logger::getGlobalInstance().addOs(nameid, filename, options, outflag, levelFilter);
+}
+
 inline void removeOs(const String& nameid)
 {
     Logger::getGlobalInstance().removeOs(nameid);
@@ -514,23 +1699,71 @@ inline void setOsAttribute(const String& nameid, int outflag = OUT_WITH_ALL, int
     Logger::getGlobalInstance().setOsAttribute(nameid, outflag, levelFilter);
 }
 
-template <Level level, typename T>
-void log(const T& message) { Logger::getGlobalInstance().log<level>(message); }
+inline void setLevelMask(int levelMask)
+{
+    Logger::getGlobalInstance().setLevelMask(levelMask);
+}
+
+template <Level level>
+bool isEnabled() { return Logger::getGlobalInstance().isEnabled<level>(); }
+
+inline void setTimestampPrecision(TimestampPrecision precision)
+{
+    Logger::getGlobalInstance().setTimestampPrecision(precision);
+}
+
+inline void setRelativeTime(bool enable)
+{
+    Logger::getGlobalInstance().setRelativeTime(enable);
+}
+
+inline void resetRelativeTime()
+{
+    Logger::getGlobalInstance().resetRelativeTime();
+}
+
+inline void logAt(Level level, const Timestamp& time, const String& message)
+{
+    Logger::getGlobalInstance().logAt(level, time, message);
+}
+
+inline void enableAsync(size_t capacity = 8192, OverflowPolicy policy = OVERFLOW_BLOCK)
+{
+    Logger::getGlobalInstance().enableAsync(capacity, policy);
+}
+
+inline void disableAsync()
+{
+    Logger::getGlobalInstance().disableAsync();
+}
+
+/// @brief Report the suppressed messages of the #MLOG_RATE_LIMITED call sites and flush the global Logger.
+inline void flush()
+{
+    RateLimitedSite::reportAll();
+    Logger::getGlobalInstance().flush();
+}
 
 template <Level level, typename T>
-void log(const String& message, const T& arg) { Logger::getGlobalInstance().log<level>(message, arg); }
+void log(const T& message) { Logger::getGlobalInstance().log<level>(message); }
 
 template <Level level, typename T, typename... Args>
-void log(const String& message, const T& arg, Args&&... args)
+void log(std::string_view message, const T& arg, Args&&... args)
 {
     Logger::getGlobalInstance().log<level>(message, arg, std::forward<Args>(args)...);
 }
 
+template <Level level>
+void event(const String& message, std::initializer_list<Field> fields)
+{
+    Logger::getGlobalInstance().event<level>(message, fields);
+}
+
 template <typename T>
 void debug(const T& message) { log<LVL_DEBUG>(message); }
 
 template <typename T, typename... Args>
-void debug(const String& message, const T& arg, Args&&... args)
+void debug(std::string_view message, const T& arg, Args&&... args)
 {
     log<LVL_DEBUG>(message, arg, std::forward<Args>(args)...);
 }
@@ -539,7 +1772,7 @@ template <typename T>
 void info(const T& message) { log<LVL_INFO>(message); }
 
 template <typename T, typename... Args>
-void info(const String& message, const T& arg, Args&&... args)
+void info(std::string_view message, const T& arg, Args&&... args)
 {
     log<LVL_INFO>(message, arg, std::forward<Args>(args)...);
 }
@@ -548,7 +1781,7 @@ template <typename T>
 void warning(const T& message) { log<LVL_WARNING>(message); }
 
 template <typename T, typename... Args>
-void warning(const String& message, const T& arg, Args&&... args)
+void warning(std::string_view message, const T& arg, Args&&... args)
 {
     log<LVL_WARNING>(message, arg, std::forward<Args>(args)...);
 }
@@ -557,7 +1790,7 @@ template <typename T>
 void error(const T& message) { log<LVL_ERROR>(message); }
 
 template <typename T, typename... Args>
-void error(const String& message, const T& arg, Args&&... args)
+void error(std::string_view message, const T& arg, Args&&... args)
 {
     log<LVL_ERROR>(message, arg, std::forward<Args>(args)...);
 }
@@ -566,11 +1799,47 @@ template <typename T>
 void fatal(const T& message) { log<LVL_FATAL>(message); }
 
 template <typename T, typename... Args>
-void fatal(const String& message, const T& arg, Args&&... args)
+void fatal(std::string_view message, const T& arg, Args&&... args)
 {
     log<LVL_FATAL>(message, arg, std::forward<Args>(args)...);
 }
 
 } // namespace mlog
 
+/// @brief Log at most #maxCount messages per #period (millisecond) from this call site,
+/// the first message of the next period is preceded by a summary of the suppressed messages.
+/// If the call site doesn't log again, the #mlog::flush() reports the summary once the period has ended.
+/// @param level The #mlog::Level, should be a constant.
+/// @note The variadic is same as the arguments of the #mlog::log().
+#define MLOG_RATE_LIMITED(level, maxCount, period, ...) \
+    do \
+    { \
+        if (::mlog::isEnabled<level>()) \
+        { \
+            static ::mlog::RateLimitedSite mlogRateLimiter_(level, __FILE__, __LINE__, maxCount, period); \
+            uint64_t mlogSuppressed_ = 0; \
+            if (mlogRateLimiter_.tryAcquire(mlogSuppressed_)) \
+            { \
+                if (mlogSuppressed_ != 0) \
+                    ::mlog::log<level>("Suppressed {} messages of the call site since the last report", \
+                        mlogSuppressed_); \
+                ::mlog::log<level>(__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+/// @brief Log one of every #rate messages from this call site.
+/// @param level The #mlog::Level, should be a constant.
+/// @note The variadic is same as the arguments of the #mlog::log().
+#define MLOG_SAMPLED(level, rate, ...) \
+    do \
+    { \
+        if (::mlog::isEnabled<level>()) \
+        { \
+            static ::mlog::Sampler mlogSampler_(rate); \
+            if (mlogSampler_.tryAcquire()) \
+                ::mlog::log<level>(__VA_ARGS__); \
+        } \
+    } while (0)
+
 #endif // !MINILOG_HPP
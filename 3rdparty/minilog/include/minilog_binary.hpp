@@ -0,0 +1,664 @@
+// The binary (deferred-format) mode of the "MiniLog" library, in c++.
+//
+// Web: https://github.com/JaderoChan/MiniLog
+// You can contact me by email: c_dl_cn@outlook.com
+
+// MIT License
+//
+// Copyright (c) 2024 頔珞JaderoChan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The call site registers a static format descriptor once, each log event only writes the timestamp,
+// the descriptor id and the raw arguments into the binary log.
+// The formatting is deferred to the #mlog::bin::BinaryReader (e.g. the "mlog_decode" tool),
+// which produces the same text as the text mode of the MiniLog.
+//
+// The binary log layout (native byte order, the reader and the writer should be the same architecture):
+//   Header:        "MLOGBIN\1", int64 wall clock (ns since epoch), int64 steady clock (ns) when opened.
+//   Descriptor:    'D', uint32 id, uint8 level, uint32 format length, format, uint8 argument count, argument types.
+//   Event:         'E', uint32 id, int64 steady clock (ns), arguments.
+//   Arguments:     bool and char are 1 byte, the integers and floating points are 8 bytes,
+//                  the strings are uint32 length and the characters.
+
+#ifndef MINILOG_BINARY_HPP
+#define MINILOG_BINARY_HPP
+
+#include <cstring>          // memcpy, strlen
+#include <deque>            // deque
+#include <filesystem>       // u8path
+#include <string_view>      // string_view
+
+#include "minilog.hpp"
+
+/// @brief Log the arguments into the global #mlog::bin::BinaryLogger, the format is registered once per call site.
+/// @param level The #mlog::Level, should be a constant.
+/// @note The first argument of the variadic is the format string, it should be a string literal.
+#define MLOG_BINARY(level, ...) \
+    do \
+    { \
+        if ((level) >= MINILOG_MIN_LEVEL) \
+        { \
+            static ::mlog::bin::CallSite mlogCallSite_(level); \
+            ::mlog::bin::BinaryLogger::getGlobalInstance().log(mlogCallSite_, __VA_ARGS__); \
+        } \
+    } while (0)
+
+namespace mlog
+{
+
+namespace bin
+{
+
+/// @brief The type of the argument stored in the binary log.
+enum ArgType : char
+{
+    ARG_BOOL    = 'b',
+    ARG_CHAR    = 'c',
+    ARG_INT     = 'i',
+    ARG_UINT    = 'u',
+    ARG_FLOAT   = 'f',
+    ARG_STRING  = 's'
+};
+
+namespace detail
+{
+
+template <typename T>
+constexpr bool dependentFalse = false;
+
+template <typename T>
+constexpr ArgType argType()
+{
+    using U = typename std::decay<T>::type;
+
+    if constexpr (std::is_same<U, bool>::value)
+        return ARG_BOOL;
+    else if constexpr (std::is_same<U, char>::value || std::is_same<U, signed char>::value ||
+                       std::is_same<U, unsigned char>::value)
+        return ARG_CHAR;
+    else if constexpr (std::is_integral<U>::value && std::is_signed<U>::value)
+        return ARG_INT;
+    else if constexpr (std::is_integral<U>::value)
+        return ARG_UINT;
+    else if constexpr (std::is_enum<U>::value)
+        return ARG_INT;
+    else if constexpr (std::is_floating_point<U>::value)
+        return ARG_FLOAT;
+    else if constexpr (std::is_convertible<const U&, std::string_view>::value)
+        return ARG_STRING;
+    else
+        static_assert(dependentFalse<T>, "The argument type is not supported by the binary log");
+}
+
+template <typename T>
+void appendRaw(String& out, const T& value)
+{
+    char buffer[sizeof(T)];
+    std::memcpy(buffer, &value, sizeof(T));
+    out.append(buffer, sizeof(T));
+}
+
+template <typename T>
+void appendArg(String& out, const T& value)
+{
+    constexpr ArgType type = argType<T>();
+
+    if constexpr (type == ARG_BOOL || type == ARG_CHAR)
+    {
+        out += static_cast<char>(value);
+    }
+    else if constexpr (type == ARG_INT)
+    {
+        appendRaw(out, static_cast<int64_t>(value));
+    }
+    else if constexpr (type == ARG_UINT)
+    {
+        appendRaw(out, static_cast<uint64_t>(value));
+    }
+    else if constexpr (type == ARG_FLOAT)
+    {
+        appendRaw(out, static_cast<double>(value));
+    }
+    else
+    {
+        std::string_view str;
+        if constexpr (std::is_convertible<const T&, const char*>::value)
+        {
+            const char* cstr = value;
+            if (cstr)
+                str = cstr;
+        }
+        else
+        {
+            str = value;
+        }
+        appendRaw(out, static_cast<uint32_t>(str.size()));
+        out.append(str.data(), str.size());
+    }
+}
+
+} // namespace detail
+
+/// @brief The format descriptor of a call site.
+struct Descriptor
+{
+    uint32_t id     = 0;
+    Level level     = LVL_DEBUG;
+    String format;
+    // The #ArgType of each argument.
+    String argTypes;
+};
+
+/// @brief The process wide registry of the format descriptors, the id starts from 1.
+class Registry
+{
+public:
+    static Registry& getInstance()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    uint32_t add(Level level, const String& format, const String& argTypes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        Descriptor descriptor;
+        descriptor.id = static_cast<uint32_t>(descriptors_.size()) + 1;
+        descriptor.level = level;
+        descriptor.format = format;
+        descriptor.argTypes = argTypes;
+        descriptors_.push_back(std::move(descriptor));
+        return descriptors_.back().id;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return descriptors_.size();
+    }
+
+    /// @note The returned reference keeps valid since the descriptors are never removed.
+    const Descriptor& get(uint32_t id) const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return descriptors_.at(id - 1);
+    }
+
+private:
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    mutable std::mutex mtx_;
+    std::deque<Descriptor> descriptors_;
+};
+
+/// @brief The static state of a call site, it registers the descriptor at the first log.
+class CallSite
+{
+public:
+    explicit CallSite(Level level) : level_(level) {}
+
+    Level level() const { return level_; }
+
+    template <typename... Args>
+    uint32_t id(const char* format)
+    {
+        uint32_t id = id_.load(std::memory_order_acquire);
+        if (id != 0)
+            return id;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        id = id_.load(std::memory_order_relaxed);
+        if (id == 0)
+        {
+            const char argTypes[] = { detail::argType<Args>()..., '\0' };
+            id = Registry::getInstance().add(level_, format, argTypes);
+            id_.store(id, std::memory_order_release);
+        }
+        return id;
+    }
+
+private:
+    Level level_;
+    std::atomic<uint32_t> id_{0};
+    std::mutex mtx_;
+};
+
+constexpr char BINARY_MAGIC[8] = { 'M', 'L', 'O', 'G', 'B', 'I', 'N', '\1' };
+
+/// @brief Write the log events into a binary file, the formatting is deferred to the #BinaryReader.
+class BinaryLogger
+{
+public:
+    BinaryLogger() = default;
+
+    ~BinaryLogger() { close(); }
+
+    BinaryLogger(const BinaryLogger&) = delete;
+
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    /// @brief Get the global instance of BinaryLogger, used by the #MLOG_BINARY.
+    static BinaryLogger& getGlobalInstance()
+    {
+        static BinaryLogger globalInstance;
+        return globalInstance;
+    }
+
+    /// @brief Open (truncate) the binary log file, the previous file is closed.
+    /// @param filename The UTF-8 file name.
+    /// @param bufferSize The events are buffered and written when the buffer is full or flushed.
+    void open(const String& filename, size_t bufferSize = 64 * 1024)
+    {
+        using namespace std::chrono;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        closeFile_();
+        ofs_.open(std::filesystem::u8path(filename), std::ios_base::binary | std::ios_base::trunc);
+        if (!ofs_.is_open())
+            throw std::runtime_error("Failed to open the file: " + filename);
+
+        bufferSize_ = bufferSize;
+        buffer_.clear();
+        buffer_.reserve(bufferSize_ + 256);
+        writtenDescriptors_ = 0;
+        writtenBytes_ = 0;
+
+        buffer_.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        detail::appendRaw(buffer_, static_cast<int64_t>(
+            duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count()));
+        detail::appendRaw(buffer_, static_cast<int64_t>(
+            duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count()));
+
+        isOpen_.store(true, std::memory_order_release);
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closeFile_();
+    }
+
+    bool isOpen() const { return isOpen_.load(std::memory_order_acquire); }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (ofs_.is_open())
+        {
+            writeBuffer_();
+            ofs_.flush();
+        }
+    }
+
+    /// @brief Get the number of bytes written into the file (include the buffered bytes).
+    uint64_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return writtenBytes_ + buffer_.size();
+    }
+
+    template <typename... Args>
+    void log(CallSite& site, const char* format, const Args&... args)
+    {
+        if (!isOpen_.load(std::memory_order_relaxed))
+            return;
+
+        int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        uint32_t id = site.id<Args...>(format);
+
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (!ofs_.is_open())
+            return;
+
+        // Write the descriptors that registered since the last write, include this one.
+        if (id > writtenDescriptors_)
+            writeDescriptors_(id);
+
+        buffer_ += 'E';
+        detail::appendRaw(buffer_, id);
+        detail::appendRaw(buffer_, time);
+        (detail::appendArg(buffer_, args), ...);
+
+        if (buffer_.size() >= bufferSize_)
+            writeBuffer_();
+    }
+
+private:
+    // Must be called with the #mtx_ locked.
+    void writeDescriptors_(uint32_t id)
+    {
+        auto& registry = Registry::getInstance();
+        uint32_t last = static_cast<uint32_t>(registry.size());
+        if (last < id)
+            last = id;
+
+        for (uint32_t i = writtenDescriptors_ + 1; i <= last; ++i)
+        {
+            const Descriptor& descriptor = registry.get(i);
+            buffer_ += 'D';
+            detail::appendRaw(buffer_, descriptor.id);
+            buffer_ += static_cast<char>(descriptor.level);
+            detail::appendRaw(buffer_, static_cast<uint32_t>(descriptor.format.size()));
+            buffer_ += descriptor.format;
+            buffer_ += static_cast<char>(descriptor.argTypes.size());
+            buffer_ += descriptor.argTypes;
+        }
+        writtenDescriptors_ = last;
+    }
+
+    // Must be called with the #mtx_ locked.
+    void writeBuffer_()
+    {
+        if (buffer_.empty())
+            return;
+
+        ofs_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        writtenBytes_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    // Must be called with the #mtx_ locked.
+    void closeFile_()
+    {
+        isOpen_.store(false, std::memory_order_release);
+        if (ofs_.is_open())
+        {
+            writeBuffer_();
+            ofs_.close();
+        }
+    }
+
+    mutable std::mutex mtx_;
+    std::atomic<bool> isOpen_{false};
+    std::ofstream ofs_;
+    String buffer_;
+    size_t bufferSize_          = 0;
+    uint32_t writtenDescriptors_ = 0;
+    uint64_t writtenBytes_      = 0;
+};
+
+/// @brief Read the binary log and format the events into the text of the MiniLog.
+class BinaryReader
+{
+public:
+    /// @brief A decoded log event.
+    struct Record
+    {
+        Level level = LVL_DEBUG;
+        // The #Timestamp::wall is the reconstructed wall clock time,
+        // the #Timestamp::mono is the time since the binary log is opened.
+        Timestamp time;
+        String message;
+    };
+
+    BinaryReader() = default;
+
+    explicit BinaryReader(const String& filename) { open(filename); }
+
+    /// @param filename The UTF-8 file name.
+    void open(const String& filename)
+    {
+        ifs_.close();
+        ifs_.clear();
+        descriptors_.clear();
+        isCorrupted_ = false;
+
+        ifs_.open(std::filesystem::u8path(filename), std::ios_base::binary);
+        if (!ifs_.is_open())
+            throw std::runtime_error("Failed to open the file: " + filename);
+
+        char magic[sizeof(BINARY_MAGIC)] = {};
+        if (!readRaw_(magic) || std::memcmp(magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+            !readRaw_(wallStart_) || !readRaw_(monoStart_))
+            throw std::runtime_error("The file is not a binary log: " + filename);
+    }
+
+    /// @brief Read the next event.
+    /// @return False if reach the end of the file or the file is corrupted (e.g. truncated by a crash).
+    bool next(Record& record)
+    {
+        char tag = 0;
+        while (readRaw_(tag))
+        {
+            if (tag == 'D')
+            {
+                if (!readDescriptor_())
+                    break;
+                continue;
+            }
+
+            if (tag == 'E')
+                return readEvent_(record);
+
+            break;
+        }
+
+        isCorrupted_ = isCorrupted_ || !ifs_.eof();
+        return false;
+    }
+
+    /// @brief Whether the #next() stopped at a corrupted or truncated record.
+    bool isCorrupted() const { return isCorrupted_; }
+
+private:
+    struct Value
+    {
+        ArgType type        = ARG_INT;
+        int64_t i           = 0;
+        uint64_t u          = 0;
+        double f            = 0.0;
+        String s;
+    };
+
+    template <typename T>
+    bool readRaw_(T& value)
+    {
+        char buffer[sizeof(T)];
+        if (!ifs_.read(buffer, sizeof(T)))
+            return false;
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    bool readString_(String& str, size_t size)
+    {
+        str.resize(size);
+        if (size != 0 && !ifs_.read(&str[0], static_cast<std::streamsize>(size)))
+        {
+            isCorrupted_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool readDescriptor_()
+    {
+        Descriptor descriptor;
+        char level = 0;
+        uint32_t formatSize = 0;
+        unsigned char argCount = 0;
+        if (!readRaw_(descriptor.id) || !readRaw_(level) || !readRaw_(formatSize) ||
+            !readString_(descriptor.format, formatSize) || !readRaw_(argCount) ||
+            !readString_(descriptor.argTypes, argCount))
+        {
+            isCorrupted_ = true;
+            return false;
+        }
+
+        descriptor.level = static_cast<Level>(static_cast<unsigned char>(level));
+        descriptors_[descriptor.id] = std::move(descriptor);
+        return true;
+    }
+
+    bool readEvent_(Record& record)
+    {
+        using namespace std::chrono;
+
+        uint32_t id = 0;
+        int64_t time = 0;
+        if (!readRaw_(id) || !readRaw_(time))
+        {
+            isCorrupted_ = true;
+            return false;
+        }
+
+        auto it = descriptors_.find(id);
+        if (it == descriptors_.end())
+        {
+            isCorrupted_ = true;
+            return false;
+        }
+        const Descriptor& descriptor = it->second;
+
+        values_.resize(descriptor.argTypes.size());
+        for (size_t i = 0; i < descriptor.argTypes.size(); ++i)
+        {
+            if (!readValue_(static_cast<ArgType>(descriptor.argTypes[i]), values_[i]))
+            {
+                isCorrupted_ = true;
+                return false;
+            }
+        }
+
+        record.level = descriptor.level;
+        record.time.wall = system_clock::time_point(
+            duration_cast<system_clock::duration>(nanoseconds(wallStart_ + (time - monoStart_))));
+        record.time.mono = steady_clock::time_point(
+            duration_cast<steady_clock::duration>(nanoseconds(time - monoStart_)));
+        record.message.clear();
+        format_(record.message, descriptor.format);
+        return true;
+    }
+
+    bool readValue_(ArgType type, Value& value)
+    {
+        value.type = type;
+        switch (type)
+        {
+            case ARG_BOOL:
+            case ARG_CHAR:
+            {
+                char c = 0;
+                if (!readRaw_(c))
+                    return false;
+                value.i = c;
+                return true;
+            }
+            case ARG_INT:
+                return readRaw_(value.i);
+            case ARG_UINT:
+                return readRaw_(value.u);
+            case ARG_FLOAT:
+                return readRaw_(value.f);
+            case ARG_STRING:
+            {
+                uint32_t size = 0;
+                return readRaw_(size) && readString_(value.s, size);
+            }
+            default:
+                return false;
+        }
+    }
+
+    static void appendValue_(String& out, const Value& value)
+    {
+        switch (value.type)
+        {
+            case ARG_BOOL:
+                mlog::detail::appendValue(out, value.i != 0);
+                break;
+            case ARG_CHAR:
+                mlog::detail::appendValue(out, static_cast<char>(value.i));
+                break;
+            case ARG_INT:
+                mlog::detail::appendValue(out, value.i);
+                break;
+            case ARG_UINT:
+                mlog::detail::appendValue(out, value.u);
+                break;
+            case ARG_FLOAT:
+                mlog::detail::appendValue(out, value.f);
+                break;
+            case ARG_STRING:
+                out += value.s;
+                break;
+        }
+    }
+
+    // Same as the #mlog::detail::formatTo(), but the arguments are known at runtime.
+    void format_(String& out, const String& fmt) const
+    {
+        const char* str = fmt.data();
+        size_t len = fmt.size();
+        size_t i = 0;
+        size_t arg = 0;
+
+        while (i < len && arg < values_.size())
+        {
+            if (str[i] != '{')
+            {
+                size_t j = i + 1;
+                while (j < len && str[j] != '{')
+                    ++j;
+                out.append(str + i, j - i);
+                i = j;
+                continue;
+            }
+
+            if (i + 3 < len && str[i + 1] == '{' && str[i + 2] == '}' && str[i + 3] == '}')
+            {
+                out += "{}";
+                i += 4;
+                continue;
+            }
+
+            if (i + 1 < len && str[i + 1] == '}')
+            {
+                appendValue_(out, values_[arg++]);
+                i += 2;
+                continue;
+            }
+
+            out += '{';
+            i += 1;
+        }
+
+        out.append(fmt, i, String::npos);
+    }
+
+    std::ifstream ifs_;
+    std::unordered_map<uint32_t, Descriptor> descriptors_;
+    std::vector<Value> values_;
+    int64_t wallStart_  = 0;
+    int64_t monoStart_  = 0;
+    bool isCorrupted_   = false;
+};
+
+} // namespace bin
+
+} // namespace mlog
+
+#endif // !MINILOG_BINARY_HPP
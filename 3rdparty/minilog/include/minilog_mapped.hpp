@@ -0,0 +1,333 @@
+// The memory-mapped ring stream of the "MiniLog" library, in c++.
+//
+// Web: https://github.com/JaderoChan/MiniLog
+// You can contact me by email: c_dl_cn@outlook.com
+
+// MIT License
+//
+// Copyright (c) 2024 頔珞JaderoChan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The log messages are appended to a fixed-size circular file which mapped into the memory,
+// the data is kept by the page cache of the system even if the process is crashed or killed.
+// Use the #mlog::MappedRing::read() (e.g. the "mlog_ring" tool) to reconstruct the log in order.
+//
+// The file layout (native byte order):
+//   Header (64 bytes): "MLOGRING", uint64 capacity, uint64 head (the total reserved bytes), padding.
+//   Data (capacity bytes): the records, each record is aligned to 8 bytes and may wrap around the end.
+//   Record: uint64 commit (the logical position + 1, written last), uint32 size, uint32 magic, the text.
+
+#ifndef MINILOG_MAPPED_HPP
+#define MINILOG_MAPPED_HPP
+
+#include <algorithm>        // sort, min
+#include <cstring>          // memcpy, memcmp, memset
+#include <filesystem>       // u8path
+#include <iterator>         // istreambuf_iterator
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>          // open
+#include <sys/mman.h>       // mmap, munmap
+#include <unistd.h>         // ftruncate, close
+#endif // _WIN32
+
+#include "minilog.hpp"
+
+namespace mlog
+{
+
+/// @brief A lock-free append-only ring of text records in a memory-mapped file.
+/// It's a std::streambuf, so it can be added to the Logger by the #stream(),
+/// each message of the Logger is written as one record.
+class MappedRing final : public std::streambuf
+{
+public:
+    /// @param filename The UTF-8 file name.
+    /// @param capacity The size of the data part of the file (byte), rounded up to multiple of 8.
+    /// @note If the file is an existing ring with the same capacity, the new records are appended after the old ones.
+    MappedRing(const String& filename, size_t capacity = 1024 * 1024) :
+        os_(this)
+    {
+        capacity_ = (capacity + ALIGN_ - 1) / ALIGN_ * ALIGN_;
+        if (capacity_ < 2 * RECORD_HEADER_SIZE_)
+            capacity_ = 2 * RECORD_HEADER_SIZE_;
+        if (!map_(filename, HEADER_SIZE_ + capacity_))
+            throw std::runtime_error("Failed to map the file: " + filename);
+
+        Header* header = reinterpret_cast<Header*>(data_);
+        if (std::memcmp(header->magic, MAGIC_, sizeof(MAGIC_)) != 0 || header->capacity != capacity_)
+        {
+            std::memset(data_, 0, HEADER_SIZE_ + capacity_);
+            header->capacity = capacity_;
+            std::memcpy(header->magic, MAGIC_, sizeof(MAGIC_));
+        }
+        head_ = reinterpret_cast<std::atomic<uint64_t>*>(&header->head);
+        ring_ = data_ + HEADER_SIZE_;
+    }
+
+    ~MappedRing() { unmap_(); }
+
+    MappedRing(const MappedRing&) = delete;
+
+    MappedRing& operator=(const MappedRing&) = delete;
+
+    /// @brief Get the stream which writes to this ring, e.g. `mlog::addOs("Ring", ring.stream())`.
+    std::ostream& stream() { return os_; }
+
+    /// @brief Append a record, thread-safe and lock-free.
+    /// @return False if the record is larger than the capacity.
+    bool append(const char* text, size_t size)
+    {
+        uint64_t length = recordLength_(size);
+        if (length > capacity_)
+            return false;
+
+        uint64_t pos = head_->fetch_add(length, std::memory_order_relaxed);
+
+        uint32_t size32 = static_cast<uint32_t>(size);
+        copyIn_(pos + 8, &size32, sizeof(size32));
+        copyIn_(pos + 12, &RECORD_MAGIC_, sizeof(RECORD_MAGIC_));
+        copyIn_(pos + RECORD_HEADER_SIZE_, text, size);
+
+        // The commit word is always 8 bytes aligned and never wraps.
+        commitWord_(pos)->store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Read the records of the ring file in order, the overwritten and uncommitted records are skipped.
+    static std::vector<String> read(const String& filename)
+    {
+        std::ifstream ifs(std::filesystem::u8path(filename), std::ios_base::binary);
+        if (!ifs.is_open())
+            throw std::runtime_error("Failed to open the file: " + filename);
+
+        String content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        if (content.size() < HEADER_SIZE_)
+            throw std::runtime_error("The file is not a log ring: " + filename);
+
+        Header header;
+        std::memcpy(&header, content.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC_, sizeof(MAGIC_)) != 0 ||
+            header.capacity % ALIGN_ != 0 || content.size() < HEADER_SIZE_ + header.capacity)
+            throw std::runtime_error("The file is not a log ring: " + filename);
+
+        const char* ring = content.data() + HEADER_SIZE_;
+        uint64_t capacity = header.capacity;
+        uint64_t head = header.head;
+        uint64_t tail = head > capacity ? head - capacity : 0;
+
+        auto copyOut = [&](uint64_t pos, void* dst, size_t size)
+        {
+            for (size_t done = 0; done < size;)
+            {
+                size_t offset = static_cast<size_t>((pos + done) % capacity);
+                size_t n = (std::min)(size - done, static_cast<size_t>(capacity - offset));
+                std::memcpy(static_cast<char*>(dst) + done, ring + offset, n);
+                done += n;
+            }
+        };
+
+        // Each valid record is found by its commit word, which holds its own position,
+        // only the records entirely in the last #capacity bytes are intact.
+        std::vector<std::pair<uint64_t, String>> records;
+        for (uint64_t offset = 0; offset < capacity; offset += ALIGN_)
+        {
+            uint64_t commit = 0;
+            std::memcpy(&commit, ring + offset, sizeof(commit));
+            if (commit == 0)
+                continue;
+
+            uint64_t pos = commit - 1;
+            if (pos % capacity != offset || pos < tail || pos + RECORD_HEADER_SIZE_ > head)
+                continue;
+
+            uint32_t size = 0;
+            uint32_t magic = 0;
+            copyOut(pos + 8, &size, sizeof(size));
+            copyOut(pos + 12, &magic, sizeof(magic));
+            if (magic != RECORD_MAGIC_ || pos + recordLength_(size) > head)
+                continue;
+
+            String text(size, '\0');
+            copyOut(pos + RECORD_HEADER_SIZE_, &text[0], size);
+            records.emplace_back(pos, std::move(text));
+        }
+
+        std::sort(records.begin(), records.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+        std::vector<String> result;
+        result.reserve(records.size());
+        for (auto& record : records)
+            result.push_back(std::move(record.second));
+        return result;
+    }
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+
+        char ch = traits_type::to_char_type(c);
+        append(&ch, 1);
+        return c;
+    }
+
+private:
+    struct Header
+    {
+        char magic[8];
+        uint64_t capacity;
+        uint64_t head;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "The 64 bits atomic should be lock-free");
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "The 64 bits atomic should be 8 bytes");
+
+    static constexpr char MAGIC_[8]                 = { 'M', 'L', 'O', 'G', 'R', 'I', 'N', 'G' };
+    static constexpr uint32_t RECORD_MAGIC_         = 0x4D4C5243;
+    static constexpr size_t ALIGN_                  = 8;
+    static constexpr size_t HEADER_SIZE_            = 64;
+    static constexpr size_t RECORD_HEADER_SIZE_     = 16;
+
+    static uint64_t recordLength_(size_t size)
+    {
+        return (RECORD_HEADER_SIZE_ + size + ALIGN_ - 1) / ALIGN_ * ALIGN_;
+    }
+
+    std::atomic<uint64_t>* commitWord_(uint64_t pos)
+    {
+        return reinterpret_cast<std::atomic<uint64_t>*>(ring_ + pos % capacity_);
+    }
+
+    void copyIn_(uint64_t pos, const void* src, size_t size)
+    {
+        for (size_t done = 0; done < size;)
+        {
+            size_t offset = static_cast<size_t>((pos + done) % capacity_);
+            size_t n = (std::min)(size - done, static_cast<size_t>(capacity_ - offset));
+            std::memcpy(ring_ + offset, static_cast<const char*>(src) + done, n);
+            done += n;
+        }
+    }
+
+#ifdef _WIN32
+    bool map_(const String& filename, size_t size)
+    {
+        // The path of the std::filesystem is UTF-16 on Windows.
+        file_ = ::CreateFileW(std::filesystem::u8path(filename).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+            nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+            return false;
+
+        ULARGE_INTEGER mappingSize;
+        mappingSize.QuadPart = size;
+        mapping_ = ::CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+            mappingSize.HighPart, mappingSize.LowPart, nullptr);
+        if (!mapping_)
+        {
+            unmap_();
+            return false;
+        }
+
+        data_ = static_cast<char*>(::MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        if (!data_)
+        {
+            unmap_();
+            return false;
+        }
+
+        size_ = size;
+        return true;
+    }
+
+    void unmap_()
+    {
+        if (data_)
+            ::UnmapViewOfFile(data_);
+        if (mapping_)
+            ::CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE)
+            ::CloseHandle(file_);
+        data_ = nullptr;
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+    }
+
+    HANDLE file_        = INVALID_HANDLE_VALUE;
+    HANDLE mapping_     = nullptr;
+#else
+    bool map_(const String& filename, size_t size)
+    {
+        fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+            return false;
+
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+        {
+            unmap_();
+            return false;
+        }
+
+        void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (data == MAP_FAILED)
+        {
+            unmap_();
+            return false;
+        }
+
+        data_ = static_cast<char*>(data);
+        size_ = size;
+        return true;
+    }
+
+    void unmap_()
+    {
+        if (data_)
+            ::munmap(data_, size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+        data_ = nullptr;
+        fd_ = -1;
+    }
+
+    int fd_             = -1;
+#endif // _WIN32
+
+    std::ostream os_;
+    char* data_                         = nullptr;
+    size_t size_                        = 0;
+    char* ring_                         = nullptr;
+    uint64_t capacity_                  = 0;
+    std::atomic<uint64_t>* head_        = nullptr;
+};
+
+} // namespace mlog
+
+#endif // !MINILOG_MAPPED_HPP
@@ -1,8 +1,7 @@
 #include "about_dialog.h"
 
-#include <easy_translate.hpp>
-
 #include "config.h"
+#include "retranslator.h"
 
 AboutDialog::AboutDialog(QWidget* parent) :
     QDialog(parent)
@@ -11,18 +10,11 @@ AboutDialog::AboutDialog(QWidget* parent) :
     ui.icon->setPixmap(QPixmap(":/icon/icon.ico"));
     ui.versionLbl->setText(APP_VERSION);
     ui.copyrightLbl->setText(APP_COPYRIGHT_TEXT);
-    updateText();
-}
-
-void AboutDialog::updateText()
-{
-    setWindowTitle(EASYTR("About"));
-    ui.titleLbl->setText(EASYTR(APP_TITLE));
+    setupText_();
 }
 
-void AboutDialog::changeEvent(QEvent* event)
+void AboutDialog::setupText_()
 {
-    if (event->type() == QEvent::LanguageChange)
-        updateText();
-    QDialog::changeEvent(event);
+    Retranslator::add(this, "About", &AboutDialog::setWindowTitle);
+    Retranslator::add(ui.titleLbl, APP_TITLE, &QLabel::setText);
 }
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <qdialog.h>
-#include <qevent.h>
 
 #include "ui_about_dialog.h"
 
@@ -10,10 +9,8 @@ class AboutDialog : public QDialog
 public:
     explicit AboutDialog(QWidget* parent = nullptr);
 
-protected:
-    virtual void updateText();
-    void changeEvent(QEvent* event) override;
-
 private:
+    void setupText_();
+
     Ui::AboutDialog ui;
 };
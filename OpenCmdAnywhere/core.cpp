@@ -1,5 +1,6 @@
 #include "core.h"
 
+#include <atomic>
 #include <filesystem>
 #include <stdexcept>
 
@@ -7,6 +8,10 @@
 #include <shobjidl.h>
 #include <shlobj.h>
 
+#include "launcher.h"
+#include "standby_pool.h"
+#include "trace_recorder.h"
+
 std::wstring getWindowExePath(HWND window)
 {
     DWORD dwProcessId;
@@ -30,37 +35,51 @@ std::wstring getWindowExeDirectory(HWND window)
     return fs::path(path).parent_path().wstring();
 }
 
-std::wstring getFocusedWindowDirectory()
+WindowSystem::Window Win32WindowSystem::foregroundWindow()
 {
-    constexpr const WCHAR* EXPLORER_CLASS_NAME_1    = L"ExploreWClass";
-    constexpr const WCHAR* EXPLORER_CLASS_NAME_2    = L"CabinetWClass";
-    constexpr const WCHAR* DESKTOP_CLASS_NAME_1     = L"Progman";
-    constexpr const WCHAR* DESKTOP_CLASS_NAME_2     = L"WorkerW";
-
-    HWND focusedWindow = GetForegroundWindow();
-    if (focusedWindow == nullptr)
+    HWND window = GetForegroundWindow();
+    if (window == nullptr)
         throw std::runtime_error("Failed to GetForegroundWindow()");
+    return reinterpret_cast<Window>(window);
+}
 
+std::wstring Win32WindowSystem::windowClassName(Window window)
+{
     WCHAR classname[MAX_CLASS_NAME];
-    if (GetClassNameW(focusedWindow, classname, MAX_CLASS_NAME) == 0)
+    if (GetClassNameW(reinterpret_cast<HWND>(window), classname, MAX_CLASS_NAME) == 0)
         throw std::runtime_error("Failed to GetClassName()");
+    return std::wstring(classname);
+}
 
-    bool atExplorer1 = wcscmp(classname, EXPLORER_CLASS_NAME_1) == 0;
-    bool atExplorer2 = wcscmp(classname, EXPLORER_CLASS_NAME_2) == 0;
-    bool atDesktop1 = wcscmp(classname, DESKTOP_CLASS_NAME_1) == 0;
-    bool atDesktop2 = wcscmp(classname, DESKTOP_CLASS_NAME_2) == 0;
+uint32_t Win32WindowSystem::windowProcessId(Window window)
+{
+    DWORD processId = 0;
+    if (GetWindowThreadProcessId(reinterpret_cast<HWND>(window), &processId) == 0)
+        throw std::runtime_error("Failed to GetWindowThreadProcessId()");
+    return static_cast<uint32_t>(processId);
+}
 
-    if (!atExplorer1 && !atExplorer2 && !atDesktop1 && !atDesktop2)
-        return getWindowExeDirectory(focusedWindow);
+std::wstring Win32WindowSystem::windowExePath(Window window)
+{
+    return getWindowExePath(reinterpret_cast<HWND>(window));
+}
 
-    if (atDesktop1 || atDesktop2)
-    {
-        wchar_t path[MAX_PATH] = {0};
-        if (!SUCCEEDED(SHGetFolderPathW(NULL, CSIDL_DESKTOP, NULL, SHGFP_TYPE_CURRENT, path)))
-            throw std::runtime_error("Failed to SHGetFolderPath()");
-        return std::wstring(path);
-    }
+std::wstring Win32WindowSystem::windowExeDirectory(Window window)
+{
+    return getWindowExeDirectory(reinterpret_cast<HWND>(window));
+}
 
+std::wstring Win32WindowSystem::desktopDirectory()
+{
+    wchar_t path[MAX_PATH] = {0};
+    if (!SUCCEEDED(SHGetFolderPathW(NULL, CSIDL_DESKTOP, NULL, SHGFP_TYPE_CURRENT, path)))
+        throw std::runtime_error("Failed to SHGetFolderPath()");
+    return std::wstring(path);
+}
+
+std::wstring Win32WindowSystem::explorerDirectory(Window window)
+{
+    HWND focusedWindow = reinterpret_cast<HWND>(window);
     IShellWindows* psw = nullptr;
     if (!SUCCEEDED(CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE)))
         throw std::runtime_error("Failed to CoInitializeEx()");
@@ -198,7 +217,7 @@ std::wstring getFocusedWindowDirectory()
             pdisp->Release();
             psw->Release();
             CoUninitialize();
-            return getWindowExeDirectory(focusedWindow);
+            return L"";
         }
 
         psi->Release();
@@ -215,23 +234,108 @@ std::wstring getFocusedWindowDirectory()
     CoUninitialize();
 
     if (path)
-        return std::wstring(path);
+    {
+        std::wstring result(path);
+        CoTaskMemFree(path);
+        return result;
+    }
     throw std::runtime_error("Failed to get valid explorer window");
 }
 
+std::wstring getFocusedWindowDirectory(std::wstring* exePath)
+{
+    static Win32WindowSystem windowSystem;
+    static ExeDirectoryCache cache;
+    return resolveFocusedWindowDirectory(windowSystem, &cache, exePath);
+}
+
+static HWINEVENTHOOK foregroundHook = nullptr;
+
+static void CALLBACK onForegroundChanged(HWINEVENTHOOK, DWORD event, HWND window, LONG idObject, LONG, DWORD, DWORD)
+{
+    if (event != EVENT_SYSTEM_FOREGROUND || idObject != OBJID_WINDOW || window == nullptr)
+        return;
+
+    try
+    {
+        Win32WindowSystem windowSystem;
+        auto handle = reinterpret_cast<WindowSystem::Window>(window);
+        trace::Recorder::recordForeground(handle, windowSystem.windowProcessId(handle),
+            windowSystem.windowClassName(handle), [&]()
+            {
+                // 无权限打开的进程（如以管理员身份运行的）记录为空目录。
+                try
+                {
+                    return windowSystem.windowExeDirectory(handle);
+                } catch (std::exception&)
+                {
+                    return std::wstring();
+                }
+            });
+    } catch (std::exception&)
+    {
+        // 窗口可能已被销毁，忽略此次切换。
+    }
+}
+
+bool installForegroundRecorder()
+{
+    if (foregroundHook)
+        return true;
+    foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr,
+        onForegroundChanged, 0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+    return foregroundHook != nullptr;
+}
+
+void uninstallForegroundRecorder()
+{
+    if (foregroundHook)
+        UnhookWinEvent(foregroundHook);
+    foregroundHook = nullptr;
+}
+
+static std::atomic<bool> directLaunch{true};
+
+void setDirectLaunch(bool enabled)
+{
+    directLaunch.store(enabled, std::memory_order_relaxed);
+}
+
+static StandbyPool& standbyPool()
+{
+    static StandbyPool pool;
+    return pool;
+}
+
+void setStandbyPool(size_t size, int idleExpirySeconds, int memoryLimitMB,
+                    const std::wstring& exeFilename, const std::wstring& parameter)
+{
+    StandbyPool::Options options;
+    options.size = size;
+    options.idleExpiry = std::chrono::seconds(idleExpirySeconds > 0 ? idleExpirySeconds : 1);
+    options.memoryLimit = memoryLimitMB > 0 ? static_cast<uint64_t>(memoryLimitMB) << 20 : 0;
+    standbyPool().setExecutable(exeFilename, parameter);
+    standbyPool().setOptions(options);
+}
+
+void stopStandbyPool()
+{
+    standbyPool().setOptions(StandbyPool::Options());
+}
+
 bool runExecutable(
     const std::wstring& exeFilename,
     const std::wstring& workDirectory,
     const std::wstring& parameter,
-    bool isAdmin)
-{
-    SHELLEXECUTEINFOW sei = {0};
-    sei.cbSize = sizeof(sei);
-    sei.fMask = SEE_MASK_DOENVSUBST;
-    sei.lpVerb = isAdmin ? L"runas" : L"open";
-    sei.lpFile = exeFilename.c_str();
-    sei.lpParameters = parameter.c_str();
-    sei.lpDirectory = workDirectory.c_str();
-    sei.nShow = SW_SHOW;
-    return ShellExecuteExW(&sei);
+    bool isAdmin,
+    bool useStandby)
+{
+    if (!isAdmin && useStandby && standbyPool().acquire(exeFilename, parameter, workDirectory))
+        return true;
+
+    static FallbackLauncher direct(std::make_unique<CreateProcessLauncher>(), std::make_unique<ShellExecuteLauncher>());
+    static ShellExecuteLauncher shell;
+
+    ProcessLauncher& launcher = directLaunch.load(std::memory_order_relaxed) ? static_cast<ProcessLauncher&>(direct) : shell;
+    return launcher.launch(exeFilename, workDirectory, parameter, isAdmin);
 }
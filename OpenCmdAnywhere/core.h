@@ -4,15 +4,46 @@
 
 #include <windows.h>
 
+#include "resolver.h"
+
+class Win32WindowSystem : public WindowSystem
+{
+public:
+    Window foregroundWindow() override;
+    std::wstring windowClassName(Window window) override;
+    uint32_t windowProcessId(Window window) override;
+    std::wstring windowExePath(Window window) override;
+    std::wstring windowExeDirectory(Window window) override;
+    std::wstring desktopDirectory() override;
+    // 通过IShellWindows查询与窗口对应的资源管理器视图。
+    std::wstring explorerDirectory(Window window) override;
+};
+
 std::wstring getWindowExePath(HWND window);
 
 std::wstring getWindowExeDirectory(HWND window);
 
-std::wstring getFocusedWindowDirectory();
+// exePath不为空时同时获取焦点窗口所属进程的可执行文件路径。
+std::wstring getFocusedWindowDirectory(std::wstring* exePath = nullptr);
+
+// 将前台窗口的切换写入追踪记录（trace::Recorder）。需在有消息循环的线程（GUI线程）中调用。
+bool installForegroundRecorder();
+void uninstallForegroundRecorder();
+
+// 开启时（默认），以用户身份运行.exe文件时直接创建进程，否则（及以管理员身份运行时）使用ShellExecuteExW。
+void setDirectLaunch(bool enabled);
+
+// 以用户身份运行时使用的待命实例池，size为0时关闭并终止所有待命实例。
+void setStandbyPool(size_t size, int idleExpirySeconds, int memoryLimitMB,
+                    const std::wstring& exeFilename, const std::wstring& parameter);
+// 终止所有待命实例，需在程序退出前调用，否则隐藏的控制台窗口会残留。
+void stopStandbyPool();
 
+// useStandby为false时（如参数与目录相关）不使用待命实例。
 bool runExecutable(
     const std::wstring& exeFilename,
     const std::wstring& workDirectory,
     const std::wstring& parameter,
-    bool isAdmin
+    bool isAdmin,
+    bool useStandby = true
 );
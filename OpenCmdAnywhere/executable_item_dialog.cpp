@@ -4,9 +4,9 @@
 #include <qfiledialog.h>
 #include <qmessagebox.h>
 
-#include <easy_translate.hpp>
-
 #include "config.h"
+#include "language.h"
+#include "retranslator.h"
 #include "settings.h"
 
 ExecutableItemDialog::ExecutableItemDialog(QWidget* parent) :
@@ -18,7 +18,7 @@ ExecutableItemDialog::ExecutableItemDialog(QWidget* parent) :
     connect(ui.confirmBtn, &QPushButton::clicked, this, &ExecutableItemDialog::onConfirmBtnClicked);
     connect(ui.cancelBtn, &QPushButton::clicked, this, &ExecutableItemDialog::onCancelBtnClicked);
 
-    updateText();
+    setupText_();
 }
 
 ExecutableItemDialog::ExecutableItemDialog(const std::pair<QString, QString>& defaultValue, QWidget* parent) :
@@ -34,32 +34,13 @@ std::pair<QString, QString> ExecutableItemDialog::data()
     return {ui.displayNameEdit->text(), ui.executableFileEdit->text()};
 }
 
-void ExecutableItemDialog::updateText()
-{
-    setWindowTitle(EASYTR("Edit Executable Item"));
-    ui.displayNameLbl->setText(EASYTR("Display Name"));
-    ui.executableFileLbl->setText(EASYTR("Executable Filename"));
-    ui.displayNameEdit->setPlaceholderText(EASYTR("Input the display name"));
-    ui.executableFileEdit->setPlaceholderText(EASYTR("Input the executable filename"));
-    ui.selectFileBtn->setText(EASYTR("Select File"));
-    ui.confirmBtn->setText(EASYTR("Confirm"));
-    ui.cancelBtn->setText(EASYTR("Cancel"));
-}
-
-void ExecutableItemDialog::changeEvent(QEvent* event)
-{
-    if (event->type() == QEvent::LanguageChange)
-        updateText();
-    QDialog::changeEvent(event);
-}
-
 void ExecutableItemDialog::onSelectFileBtnClicked()
 {
     QString filename = QFileDialog::getOpenFileName(
         this,
-        EASYTR("Select a executable file"),
+        QEASYTR("Select a executable file"),
         QDir::rootPath(),
-        QString(EASYTR("Executable File")) + " (*.exe)"
+        QEASYTR("Executable File") + " (*.exe)"
     );
     if (!filename.isEmpty())
         ui.executableFileEdit->setText(filename);
@@ -71,8 +52,8 @@ void ExecutableItemDialog::onConfirmBtnClicked()
     {
         QMessageBox msgBox(
             QMessageBox::Warning,
-            EASYTR("Warning"),
-            EASYTR("Please input the valid data"),
+            QEASYTR("Warning"),
+            QEASYTR("Please input the valid data"),
             QMessageBox::NoButton,
             this
         );
@@ -85,8 +66,8 @@ void ExecutableItemDialog::onConfirmBtnClicked()
         {
             QMessageBox msgBox(
                 QMessageBox::Warning,
-                EASYTR("Warning"),
-                EASYTR("The given display name is exists"),
+                QEASYTR("Warning"),
+                QEASYTR("The given display name is exists"),
                 QMessageBox::NoButton,
                 this
             );
@@ -107,3 +88,15 @@ void ExecutableItemDialog::onCancelBtnClicked()
 {
     reject();
 }
+
+void ExecutableItemDialog::setupText_()
+{
+    Retranslator::add(this, "Edit Executable Item", &ExecutableItemDialog::setWindowTitle);
+    Retranslator::add(ui.displayNameLbl, "Display Name", &QLabel::setText);
+    Retranslator::add(ui.executableFileLbl, "Executable Filename", &QLabel::setText);
+    Retranslator::add(ui.displayNameEdit, "Input the display name", &QLineEdit::setPlaceholderText);
+    Retranslator::add(ui.executableFileEdit, "Input the executable filename", &QLineEdit::setPlaceholderText);
+    Retranslator::add(ui.selectFileBtn, "Select File", &QPushButton::setText);
+    Retranslator::add(ui.confirmBtn, "Confirm", &QPushButton::setText);
+    Retranslator::add(ui.cancelBtn, "Cancel", &QPushButton::setText);
+}
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <qdialog.h>
-#include <qevent.h>
 
 #include "ui_executable_item_dialog.h"
 
@@ -14,14 +13,13 @@ public:
     std::pair<QString, QString> data();
 
 protected:
-    virtual void updateText();
-    void changeEvent(QEvent* event) override;
-
     void onSelectFileBtnClicked();
     void onConfirmBtnClicked();
     void onCancelBtnClicked();
 
 private:
+    void setupText_();
+
     Ui::ExecutableItemDialog ui;
     std::pair<QString, QString> defaultValue_;
 };
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+// 系统热键的注册接口，使HotkeyHandler可在没有真实按键的环境中（如负载测试）运行。
+// 热键以gbhk::KeyCombination::toString()的字符串表示，返回值为gbhk的返回码（0表示成功）。
+class HotkeyBackend
+{
+public:
+    using Callback = std::function<void()>;
+
+    virtual ~HotkeyBackend() = default;
+
+    virtual int initialize() = 0;
+    virtual int uninitialize() = 0;
+    virtual int add(const std::string& hotkey, Callback callback) = 0;
+    virtual int remove(const std::string& hotkey) = 0;
+    virtual int replace(const std::string& oldHotkey, const std::string& newHotkey) = 0;
+    virtual std::string returnCodeMessage(int rc) const = 0;
+};
+
+// 测试替身，不注册系统热键，由trigger()在调用线程中直接调用回调（与gbhk在其工作线程中调用回调相同）。
+class FakeHotkeyBackend : public HotkeyBackend
+{
+public:
+    static constexpr int RC_SUCCESS         = 0;
+    static constexpr int RC_NOT_INITIALIZED = 1;
+    static constexpr int RC_EXISTS          = 2;
+    static constexpr int RC_NOT_FOUND       = 3;
+
+    int initialize() override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        initialized_ = true;
+        return RC_SUCCESS;
+    }
+
+    int uninitialize() override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        initialized_ = false;
+        callbacks_.clear();
+        return RC_SUCCESS;
+    }
+
+    int add(const std::string& hotkey, Callback callback) override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!initialized_)
+            return RC_NOT_INITIALIZED;
+        if (callbacks_.find(hotkey) != callbacks_.end())
+            return RC_EXISTS;
+        callbacks_[hotkey] = std::move(callback);
+        return RC_SUCCESS;
+    }
+
+    int remove(const std::string& hotkey) override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!initialized_)
+            return RC_NOT_INITIALIZED;
+        return callbacks_.erase(hotkey) != 0 ? RC_SUCCESS : RC_NOT_FOUND;
+    }
+
+    int replace(const std::string& oldHotkey, const std::string& newHotkey) override
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!initialized_)
+            return RC_NOT_INITIALIZED;
+        auto it = callbacks_.find(oldHotkey);
+        if (it == callbacks_.end())
+            return RC_NOT_FOUND;
+        if (callbacks_.find(newHotkey) != callbacks_.end())
+            return RC_EXISTS;
+        Callback callback = std::move(it->second);
+        callbacks_.erase(it);
+        callbacks_[newHotkey] = std::move(callback);
+        return RC_SUCCESS;
+    }
+
+    std::string returnCodeMessage(int rc) const override
+    {
+        switch (rc)
+        {
+            case RC_SUCCESS:            return "Success";
+            case RC_NOT_INITIALIZED:    return "The backend is not initialized";
+            case RC_EXISTS:             return "The hotkey already exists";
+            case RC_NOT_FOUND:          return "The hotkey does not exist";
+            default:                    return "Unknown error";
+        }
+    }
+
+    // 模拟按下热键。返回false表示此热键未注册。
+    bool trigger(const std::string& hotkey)
+    {
+        Callback callback;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = callbacks_.find(hotkey);
+            if (it == callbacks_.end())
+                return false;
+            callback = it->second;
+        }
+        callback();
+        return true;
+    }
+
+private:
+    std::mutex mtx_;
+    bool initialized_ = false;
+    std::map<std::string, Callback> callbacks_;
+};
@@ -1,25 +1,70 @@
 #include "hotkey_handler.h"
 
-#include <thread>
-
 #include <minilog.hpp>
 
 #include "settings.h"
 #include "core.h"
+#include "metrics.h"
+
+// 使用gbhk注册系统热键。
+class GbhkHotkeyBackend : public HotkeyBackend
+{
+public:
+    GbhkHotkeyBackend() :
+        ghm_(gbhk::RegisterGlobalHotkeyManager::getInstance())
+    {}
+
+    int initialize() override { return ghm_.initialize(); }
+    int uninitialize() override { return ghm_.uninitialize(); }
+
+    int add(const std::string& hotkey, Callback callback) override
+    {
+        return ghm_.add(gbhk::KeyCombination::fromString(hotkey), std::move(callback));
+    }
+
+    int remove(const std::string& hotkey) override
+    {
+        return ghm_.remove(gbhk::KeyCombination::fromString(hotkey));
+    }
+
+    int replace(const std::string& oldHotkey, const std::string& newHotkey) override
+    {
+        return ghm_.replace(gbhk::KeyCombination::fromString(oldHotkey), gbhk::KeyCombination::fromString(newHotkey));
+    }
+
+    std::string returnCodeMessage(int rc) const override { return gbhk::getReturnCodeMsg(rc); }
+
+private:
+    gbhk::GlobalHotkeyManager& ghm_;
+};
 
 HotkeyHandler::HotkeyHandler() :
-    ghm_(gbhk::RegisterGlobalHotkeyManager::getInstance())
+    backend_(new GbhkHotkeyBackend()),
+    pipeline_(
+        []()
+        {
+            return LaunchPipeline::Config{
+                Settings::getCurrentExecutable().second.toStdWString(),
+                Settings::getParameterTemplate(),
+                Settings::getLaunchProfiles()
+            };
+        },
+        getFocusedWindowDirectory,
+        runExecutable
+    )
 {
-    int rc = ghm_.initialize();
+    int rc = backend_->initialize();
     if (rc != gbhk::RC_SUCCESS)
-        mlog::warning("Failed to initialize the Global Hotkey Manager, message: {}", gbhk::getReturnCodeMsg(rc));
+        mlog::event<mlog::LVL_WARNING>("Failed to initialize the Global Hotkey Manager",
+            { mlog::field("rc", rc), mlog::field("message", backend_->returnCodeMessage(rc)) });
 }
 
 HotkeyHandler::~HotkeyHandler()
 {
-    int rc = ghm_.uninitialize();
+    int rc = backend_->uninitialize();
     if (rc != gbhk::RC_SUCCESS)
-        mlog::warning("Failed to uninitialize the Global Hotkey Manager, message: {}", gbhk::getReturnCodeMsg(rc));
+        mlog::event<mlog::LVL_WARNING>("Failed to uninitialize the Global Hotkey Manager",
+            { mlog::field("rc", rc), mlog::field("message", backend_->returnCodeMessage(rc)) });
 }
 
 HotkeyHandler& HotkeyHandler::getInstance()
@@ -28,6 +73,13 @@ HotkeyHandler& HotkeyHandler::getInstance()
     return instance;
 }
 
+// 按操作与结果统计热键的注册情况。
+static void countHotkeyOperation(const char* op, int rc)
+{
+    Metrics::counter("ocaw_hotkey_operations_total", "The number of the hotkey add, replace and remove operations.",
+        std::string("op=\"") + op + "\",result=\"" + (rc == gbhk::RC_SUCCESS ? "success" : "failure") + "\"").increment();
+}
+
 gbhk::KeyCombination HotkeyHandler::setHotkey(const gbhk::KeyCombination& kc, bool isAdmin)
 {
     auto& instance = getInstance();
@@ -39,10 +91,12 @@ gbhk::KeyCombination HotkeyHandler::setHotkey(const gbhk::KeyCombination& kc, bo
         if (hotkey.isValid())
         {
             mlog::info("Due to the original hotkey is valid and the setHotkey() got a invalid hotkey so remove the original hotkey");
-            int rc = instance.ghm_.remove(hotkey);
-            hotkey = {};
+            int rc = instance.backend_->remove(hotkey.toString());
+            countHotkeyOperation("remove", rc);
             if (rc != gbhk::RC_SUCCESS)
-                mlog::warning("Failed to remove the hotkey, message: {}", gbhk::getReturnCodeMsg(rc));
+                mlog::event<mlog::LVL_WARNING>("Failed to remove the hotkey", { mlog::field("hotkey", hotkey.toString()),
+                    mlog::field("admin", isAdmin), mlog::field("rc", rc), mlog::field("message", instance.backend_->returnCodeMessage(rc)) });
+            hotkey = {};
         }
     }
     else
@@ -51,22 +105,26 @@ gbhk::KeyCombination HotkeyHandler::setHotkey(const gbhk::KeyCombination& kc, bo
         if (hotkey.isValid())
         {
             mlog::info("Due to the original hotkey is valid and setHotkey() got a valid hotkey so replace the original hotkey to the new hotkey");
-            int rc = instance.ghm_.replace(hotkey, kc);
+            int rc = instance.backend_->replace(hotkey.toString(), kc.toString());
+            countHotkeyOperation("replace", rc);
             if (rc != gbhk::RC_SUCCESS)
                 hotkey = {};
             else
                 hotkey = kc;
             if (rc != gbhk::RC_SUCCESS)
-                mlog::warning("Failed to replace the hotkey, message: {}", gbhk::getReturnCodeMsg(rc));
+                mlog::event<mlog::LVL_WARNING>("Failed to replace the hotkey", { mlog::field("hotkey", kc.toString()),
+                    mlog::field("admin", isAdmin), mlog::field("rc", rc), mlog::field("message", instance.backend_->returnCodeMessage(rc)) });
         }
         else
         {
             mlog::info("Due to the original hotkey is invalid and setHotkey() got a valid hotkey so add the new hotkey");
-            int rc = instance.ghm_.add(kc, [=]() { hotkeyTriggered(isAdmin); });
+            int rc = instance.backend_->add(kc.toString(), [=]() { hotkeyTriggered(isAdmin); });
+            countHotkeyOperation("add", rc);
             if (rc == gbhk::RC_SUCCESS)
                 hotkey = kc;
             if (rc != gbhk::RC_SUCCESS)
-                mlog::warning("Failed to add the hotkey, message: {}", gbhk::getReturnCodeMsg(rc));
+                mlog::event<mlog::LVL_WARNING>("Failed to add the hotkey", { mlog::field("hotkey", kc.toString()),
+                    mlog::field("admin", isAdmin), mlog::field("rc", rc), mlog::field("message", instance.backend_->returnCodeMessage(rc)) });
         }
     }
 
@@ -75,25 +133,5 @@ gbhk::KeyCombination HotkeyHandler::setHotkey(const gbhk::KeyCombination& kc, bo
 
 void HotkeyHandler::hotkeyTriggered(bool isAdmin)
 {
-    std::thread th([=]()
-    {
-        auto executable = Settings::getCurrentExecutable().second.toStdWString();
-        auto parameter = Settings::getParameter().toStdWString();
-        if (executable.empty())
-        {
-            mlog::info("The executable filename is empty");
-            return;
-        }
-
-        try
-        {
-            auto path = getFocusedWindowDirectory();
-            if (!runExecutable(executable, path, parameter, isAdmin))
-                throw std::runtime_error("Failed to run the executable");
-        } catch (std::exception& e)
-        {
-            mlog::warning("Error occurred when run the getFocusedWindowDirectory() and runExecutable(), exception: {}", e.what());
-        }
-    });
-    th.detach();
+    getInstance().pipeline_.trigger(isAdmin);
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <memory>
+
 #include <global_hotkey/global_hotkey.hpp>
 
+#include "hotkey_backend.h"
+#include "launch_pipeline.h"
+
 // Singleton
 class HotkeyHandler
 {
@@ -20,7 +25,8 @@ private:
     HotkeyHandler(const HotkeyHandler&) = delete;
     HotkeyHandler& operator=(const HotkeyHandler&) = delete;
 
-    gbhk::GlobalHotkeyManager& ghm_;
+    std::unique_ptr<HotkeyBackend> backend_;
+    LaunchPipeline pipeline_;
     gbhk::KeyCombination hotkeyAsUserRun_;
     gbhk::KeyCombination hotkeyAsAdminRun_;
 };
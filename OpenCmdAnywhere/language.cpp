@@ -1,13 +1,17 @@
 #include "language.h"
 
-#include <qapplication.h>
-#include <qevent.h>
+#include <qbytearray.h>
+#include <qhash.h>
 #include <qstring>
 
 #include <easy_translate.hpp>
 #include <minilog.hpp>
 
 #include "config.h"
+#include "retranslator.h"
+
+// {Translation ID : Translation text} of the current language.
+static QHash<QByteArray, QString> translationCache;
 
 QString setLanguage(const QString& langId)
 {
@@ -42,8 +46,27 @@ QString setLanguage(const QString& langId)
         }
     }
 
-    QEvent event(QEvent::Type::LanguageChange);
-    qApp->sendEvent(qApp, &event);
+    for (const auto& layer : easytr::fallbackStatistics())
+        mlog::info("The language layer {} supplied {} translations", layer.first.c_str(), layer.second);
+
+    translationCache.clear();
+    Retranslator::retranslate();
 
     return easytr::currentLanguage();
 }
+
+QString translate(const char* tranId)
+{
+    // 以原始数据构造查找键，命中缓存时不产生任何分配。
+    auto it = translationCache.constFind(QByteArray::fromRawData(tranId, qstrlen(tranId)));
+    if (it != translationCache.constEnd())
+        return it.value();
+    QString text = QString::fromUtf8(EASYTR(tranId));
+    translationCache.insert(QByteArray(tranId), text);
+    return text;
+}
+
+QString translate(const std::string& tranId)
+{
+    return translate(tranId.c_str());
+}
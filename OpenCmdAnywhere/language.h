@@ -1,5 +1,16 @@
 #pragma once
 
+#include <string>
+
 #include <qstring.h>
 
+// Usage: QEASYTR("Translation ID")
+// Same as the EASYTR() but return a implicitly shared QString, see translate().
+#define QEASYTR(x) ::translate(x)
+
 QString setLanguage(const QString& langId);
+
+// 获取当前语言下的翻译文本。结果按翻译ID缓存，重复获取时仅复制共享的QString，不再进行UTF-8解码；切换语言时缓存失效。
+// 仅可在GUI线程中调用。
+QString translate(const char* tranId);
+QString translate(const std::string& tranId);
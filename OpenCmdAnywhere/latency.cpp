@@ -0,0 +1,192 @@
+#include "latency.h"
+
+#include <cmath>
+#include <cstdio>
+
+void LatencyHistogram::record(uint64_t us)
+{
+    buckets_[bucketIndex_(us)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t curMax = max_.load(std::memory_order_relaxed);
+    while (us > curMax && !max_.compare_exchange_weak(curMax, us, std::memory_order_relaxed))
+        ;
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_)
+        total += bucket.load(std::memory_order_relaxed);
+    return total;
+}
+
+double LatencyHistogram::mean() const
+{
+    uint64_t total = count();
+    return total == 0 ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / total;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const
+{
+    uint64_t counts[BUCKET_COUNT];
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0)
+        return 0;
+
+    percentile = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total));
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        cumulative += counts[i];
+        if (cumulative >= rank)
+        {
+            uint64_t upper = bucketUpperBound_(i);
+            uint64_t curMax = max();
+            return upper < curMax ? upper : curMax;
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::bucketIndex_(uint64_t us)
+{
+    if (us < SUB_BUCKET_COUNT)
+        return static_cast<size_t>(us);
+
+    int msb = SUB_BUCKET_BITS;
+    while (msb < 63 && (us >> (msb + 1)) != 0)
+        ++msb;
+
+    int shift = msb - SUB_BUCKET_BITS;
+    if (shift > MAX_SHIFT)
+        return BUCKET_COUNT - 1;
+
+    // us >> shift 位于[SUB_BUCKET_COUNT, 2 * SUB_BUCKET_COUNT)。
+    return static_cast<size_t>(SUB_BUCKET_COUNT * (shift + 1) + ((us >> shift) - SUB_BUCKET_COUNT));
+}
+
+uint64_t LatencyHistogram::bucketUpperBound_(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT)
+        return index;
+
+    int shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+    uint64_t sub = index % SUB_BUCKET_COUNT;
+    return ((SUB_BUCKET_COUNT + sub + 1) << shift) - 1;
+}
+
+LatencyStats& LatencyStats::getInstance()
+{
+    static LatencyStats instance;
+    return instance;
+}
+
+void LatencyStats::record(bool isAdmin, Stage stage, TimePoint start, TimePoint end)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    getInstance().histograms_[isAdmin ? 1 : 0][stage].record(us > 0 ? static_cast<uint64_t>(us) : 0);
+}
+
+const LatencyHistogram& LatencyStats::histogram(bool isAdmin, Stage stage)
+{
+    return getInstance().histograms_[isAdmin ? 1 : 0][stage];
+}
+
+void LatencyStats::reset()
+{
+    for (auto& histograms : getInstance().histograms_)
+    {
+        for (auto& hist : histograms)
+            hist.reset();
+    }
+}
+
+std::string LatencyStats::report()
+{
+    std::string text;
+    char line[160];
+    for (int admin = 0; admin < 2; ++admin)
+    {
+        text += admin ? "Run As Admin Hotkey (us)\n" : "Run As User Hotkey (us)\n";
+        for (int i = 0; i < STAGE_COUNT; ++i)
+        {
+            const auto& hist = histogram(admin != 0, static_cast<Stage>(i));
+            std::snprintf(line, sizeof(line),
+                "  %-9s count %-6llu p50 %-8llu p90 %-8llu p99 %-8llu max %llu\n",
+                stageName(static_cast<Stage>(i)),
+                static_cast<unsigned long long>(hist.count()),
+                static_cast<unsigned long long>(hist.percentile(50)),
+                static_cast<unsigned long long>(hist.percentile(90)),
+                static_cast<unsigned long long>(hist.percentile(99)),
+                static_cast<unsigned long long>(hist.max()));
+            text += line;
+        }
+    }
+    return text;
+}
+
+std::string LatencyStats::metrics()
+{
+    static const double QUANTILES[] = { 0.5, 0.9, 0.99, 1.0 };
+
+    std::string text;
+    char line[200];
+    text += "# HELP ocaw_hotkey_latency_microseconds The latency of each stage from the hotkey triggered to the executable started.\n";
+    text += "# TYPE ocaw_hotkey_latency_microseconds summary\n";
+    for (int admin = 0; admin < 2; ++admin)
+    {
+        const char* hotkey = admin ? "admin" : "user";
+        for (int i = 0; i < STAGE_COUNT; ++i)
+        {
+            const auto& hist = histogram(admin != 0, static_cast<Stage>(i));
+            const char* stage = stageName(static_cast<Stage>(i));
+            uint64_t count = hist.count();
+            for (double q : QUANTILES)
+            {
+                std::snprintf(line, sizeof(line),
+                    "ocaw_hotkey_latency_microseconds{hotkey=\"%s\",stage=\"%s\",quantile=\"%g\"} %llu\n",
+                    hotkey, stage, q, static_cast<unsigned long long>(hist.percentile(q * 100)));
+                text += line;
+            }
+            std::snprintf(line, sizeof(line),
+                "ocaw_hotkey_latency_microseconds_sum{hotkey=\"%s\",stage=\"%s\"} %llu\n",
+                hotkey, stage, static_cast<unsigned long long>(hist.sum()));
+            text += line;
+            std::snprintf(line, sizeof(line),
+                "ocaw_hotkey_latency_microseconds_count{hotkey=\"%s\",stage=\"%s\"} %llu\n",
+                hotkey, stage, static_cast<unsigned long long>(count));
+            text += line;
+        }
+    }
+    return text;
+}
+
+const char* LatencyStats::stageName(Stage stage)
+{
+    switch (stage)
+    {
+        case STAGE_SETTINGS:    return "settings";
+        case STAGE_RESOLVE:     return "resolve";
+        case STAGE_LAUNCH:      return "launch";
+        case STAGE_TOTAL:       return "total";
+        default:                return "";
+    }
+}
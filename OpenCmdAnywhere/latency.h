@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// 对数-线性分桶的延迟直方图（HDR风格），相对误差约3%。
+// 记录只需原子操作，不加锁，可在任意线程中使用。
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // 单位为微秒。
+    void record(uint64_t us);
+
+    uint64_t count() const;
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+    // percentile的范围为[0, 100]。返回所在桶的上界，即不小于真实值的估计。
+    uint64_t percentile(double percentile) const;
+    // 与record()并发时结果不精确。
+    void reset();
+
+private:
+    // 每个2的幂区间划分为2^SUB_BUCKET_BITS个线性子桶。
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    // 超出的值记入最后一个桶（约19小时）。
+    static constexpr int MAX_SHIFT = 31;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT * (MAX_SHIFT + 2);
+
+    static size_t bucketIndex_(uint64_t us);
+    static uint64_t bucketUpperBound_(size_t index);
+
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Singleton
+// 热键从回调触发到可执行文件启动完成的各阶段延迟，按热键（以用户/管理员身份运行）分别统计。
+class LatencyStats
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    enum Stage
+    {
+        // 热键回调 -> 读取设置完成（包含工作线程的启动）。
+        STAGE_SETTINGS,
+        // 解析焦点窗口所在目录。
+        STAGE_RESOLVE,
+        // 启动可执行文件。
+        STAGE_LAUNCH,
+        // 热键回调 -> 启动可执行文件完成。
+        STAGE_TOTAL,
+        STAGE_COUNT
+    };
+
+    static LatencyStats& getInstance();
+
+    static void record(bool isAdmin, Stage stage, TimePoint start, TimePoint end);
+    static const LatencyHistogram& histogram(bool isAdmin, Stage stage);
+    // 清空所有直方图，如负载测试的各场景之间。
+    static void reset();
+
+    // 可读的百分位数报告，用于诊断对话框。
+    static std::string report();
+    // Prometheus文本格式（summary）的百分位数，用于写出指标文件。
+    static std::string metrics();
+
+    static const char* stageName(Stage stage);
+
+private:
+    LatencyStats() = default;
+    ~LatencyStats() = default;
+    LatencyStats(const LatencyStats&) = delete;
+    LatencyStats& operator=(const LatencyStats&) = delete;
+
+    LatencyHistogram histograms_[2][STAGE_COUNT];
+};
@@ -0,0 +1,180 @@
+#include "launch_pipeline.h"
+
+#include <stdexcept>
+#include <thread>
+
+#include <minilog.hpp>
+#include <minilog_binary.hpp>
+
+#include "metrics.h"
+#include "trace_recorder.h"
+
+LaunchPipeline::LaunchPipeline(ConfigSource configSource, Resolver resolver, Launcher launcher) :
+    state_(std::make_shared<State>())
+{
+    state_->configSource = std::move(configSource);
+    state_->resolver = std::move(resolver);
+    state_->launcher = std::move(launcher);
+    state_->now = LatencyStats::Clock::now;
+}
+
+LaunchPipeline::~LaunchPipeline()
+{
+    if (waitIdleFor(exitTimeout_))
+        return;
+
+    uint64_t activeWorkers = 0;
+    {
+        std::lock_guard<std::mutex> lock(state_->workerMtx);
+        activeWorkers = state_->activeWorkers;
+    }
+    mlog::warning("Abandoned {} unfinished worker threads after waiting {} ms", activeWorkers, exitTimeout_.count());
+}
+
+void LaunchPipeline::trigger(bool isAdmin)
+{
+    static auto& threadsSpawned = Metrics::counter("ocaw_threads_spawned_total",
+        "The number of the detached worker threads spawned.", "site=\"hotkey\"");
+    static auto& triggersCoalesced = Metrics::counter("ocaw_triggers_coalesced_total",
+        "The number of the hotkey triggers ignored due to the previous trigger was not finished.");
+
+    auto callbackTime = state_->now();
+    triggered_.fetch_add(1, std::memory_order_relaxed);
+
+    if (coalescing_.load(std::memory_order_relaxed) &&
+        state_->inFlight[isAdmin ? 1 : 0].exchange(true, std::memory_order_acq_rel))
+    {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+        triggersCoalesced.increment();
+        trace::Recorder::recordHotkey(isAdmin, true);
+        return;
+    }
+    trace::Recorder::recordHotkey(isAdmin, false);
+
+    {
+        std::lock_guard<std::mutex> lock(state_->workerMtx);
+        ++state_->activeWorkers;
+        if (state_->activeWorkers > state_->peakWorkers)
+            state_->peakWorkers = state_->activeWorkers;
+    }
+
+    auto work = [state = state_, isAdmin, callbackTime]()
+    {
+        run_(*state, isAdmin, callbackTime);
+        state->inFlight[isAdmin ? 1 : 0].store(false, std::memory_order_release);
+        workerExited_(*state);
+    };
+    if (executor_)
+    {
+        executor_(work);
+        return;
+    }
+
+    threadsSpawned.increment();
+    std::thread th(work);
+    th.detach();
+}
+
+void LaunchPipeline::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(state_->workerMtx);
+    state_->workerCv.wait(lock, [this]() { return state_->activeWorkers == 0; });
+}
+
+bool LaunchPipeline::waitIdleFor(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(state_->workerMtx);
+    return state_->workerCv.wait_for(lock, timeout, [this]() { return state_->activeWorkers == 0; });
+}
+
+LaunchPipeline::Stats LaunchPipeline::stats() const
+{
+    Stats stats;
+    stats.triggered = triggered_.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+    stats.launched = state_->launched.load(std::memory_order_relaxed);
+    stats.failed = state_->failed.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(state_->workerMtx);
+    stats.peakWorkers = state_->peakWorkers;
+    return stats;
+}
+
+void LaunchPipeline::run_(State& state, bool isAdmin, LatencyStats::TimePoint callbackTime)
+{
+    Config config = state.configSource();
+    auto settingsEnd = state.now();
+    LatencyStats::record(isAdmin, LatencyStats::STAGE_SETTINGS, callbackTime, settingsEnd);
+    if (config.executable.empty() && (!config.profiles || config.profiles->empty()))
+    {
+        mlog::info("The executable filename is empty");
+        return;
+    }
+
+    try
+    {
+        // 各阶段的耗时由追踪日志的时间戳得出。
+        MLOG_BINARY(mlog::LVL_DEBUG, "Start to resolve the focused window directory, admin: {}", isAdmin);
+        auto resolveStart = state.now();
+        bool usesExe = (config.parameter && config.parameter->usesExe()) ||
+                       (config.profiles && config.profiles->usesExe());
+        std::wstring exePath;
+        auto path = state.resolver(usesExe ? &exePath : nullptr);
+        auto resolveEnd = state.now();
+        LatencyStats::record(isAdmin, LatencyStats::STAGE_RESOLVE, resolveStart, resolveEnd);
+        MLOG_BINARY(mlog::LVL_DEBUG, "Resolved the directory, length: {}", path.size());
+
+        auto launchStart = state.now();
+        const std::wstring* executable = &config.executable;
+        const ParameterTemplate* parameterTemplate = config.parameter.get();
+        const LaunchProfile* profile = config.profiles ? config.profiles->match(path) : nullptr;
+        if (profile)
+        {
+            executable = &profile->executable;
+            parameterTemplate = profile->parameter.get();
+        }
+        // 与目录相关的参数与按目录匹配的启动配置无法预先启动，均由本次读取的设置判断。
+        bool useStandby = !profile && (!parameterTemplate || parameterTemplate->isContextFree());
+        if (executable->empty())
+        {
+            mlog::info("The executable filename is empty");
+            return;
+        }
+
+        std::wstring parameter;
+        if (parameterTemplate)
+            parameterTemplate->expand({ path, exePath }, parameter);
+        bool ok = state.launcher(*executable, path, parameter, isAdmin, useStandby);
+        auto launchEnd = state.now();
+        LatencyStats::record(isAdmin, LatencyStats::STAGE_LAUNCH, launchStart, launchEnd);
+        LatencyStats::record(isAdmin, LatencyStats::STAGE_TOTAL, callbackTime, launchEnd);
+        MLOG_BINARY(mlog::LVL_DEBUG, "Ran the executable, success: {}", ok);
+        if (!ok)
+            throw std::runtime_error("Failed to run the executable");
+        if (trace::Recorder::isOpen())
+        {
+            auto us = [](LatencyStats::TimePoint start, LatencyStats::TimePoint end)
+            {
+                auto count = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+                return count > 0 ? static_cast<uint64_t>(count) : 0;
+            };
+            trace::Recorder::recordStages(isAdmin, us(callbackTime, settingsEnd), us(resolveStart, resolveEnd),
+                us(launchStart, launchEnd), us(callbackTime, launchEnd));
+        }
+        state.launched.fetch_add(1, std::memory_order_relaxed);
+    } catch (std::exception& e)
+    {
+        state.failed.fetch_add(1, std::memory_order_relaxed);
+        MLOG_BINARY(mlog::LVL_WARNING, "Failed to resolve or run, exception: {}", e.what());
+        // 按住热键或窗口接口持续失败时会重复触发，限制每秒的日志数量。
+        MLOG_RATE_LIMITED(mlog::LVL_WARNING, 5, 1000,
+            "Error occurred when run the getFocusedWindowDirectory() and runExecutable(), exception: {}", e.what());
+    }
+}
+
+void LaunchPipeline::workerExited_(State& state)
+{
+    std::lock_guard<std::mutex> lock(state.workerMtx);
+    --state.activeWorkers;
+    // 在持有锁时通知，保证waitIdle()返回后不再访问状态（本对象析构后状态由工作线程持有的引用保持有效）。
+    state.workerCv.notify_all();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "latency.h"
+#include "launch_profile.h"
+#include "parameter_template.h"
+
+// 热键触发后的 读取设置 -> 解析目录 -> 启动可执行文件 流程。
+// 各步骤通过函数注入，不依赖Qt与Windows，可使用伪造的实现在无界面的环境中运行（如负载测试工具）。
+class LaunchPipeline
+{
+public:
+    struct Config
+    {
+        // 为空且没有匹配的启动配置时不启动。
+        std::wstring executable;
+        // 编译的参数模板，为空时参数为空。
+        std::shared_ptr<const ParameterTemplate> parameter;
+        // 按解析的目录匹配，匹配时替换以上的可执行文件与参数，可为空。
+        std::shared_ptr<const LaunchProfiles> profiles;
+    };
+
+    struct Stats
+    {
+        uint64_t triggered  = 0;
+        // 由于同一热键的上一次触发尚未完成而被合并（忽略）的触发次数。
+        uint64_t coalesced  = 0;
+        uint64_t launched   = 0;
+        // 解析目录或启动失败的次数。
+        uint64_t failed     = 0;
+        // 同时存在的工作线程的最大数量。
+        uint64_t peakWorkers = 0;
+    };
+
+    using ConfigSource = std::function<Config()>;
+    // 返回焦点窗口所在目录，失败时抛出异常。exePath不为空时同时返回焦点窗口所属进程的可执行文件路径。
+    using Resolver = std::function<std::wstring(std::wstring* exePath)>;
+    // 参数依次为可执行文件、工作目录、展开的参数、是否以管理员身份运行与是否可使用预先启动的实例
+    // （参数模板与目录无关且没有匹配的启动配置）。
+    using Launcher = std::function<bool(const std::wstring&, const std::wstring&, const std::wstring&, bool, bool)>;
+    using Now = std::function<LatencyStats::TimePoint()>;
+    // 执行一次触发的流程，默认为在新的分离线程中执行。
+    using Executor = std::function<void(std::function<void()>)>;
+
+    LaunchPipeline(ConfigSource configSource, Resolver resolver, Launcher launcher);
+    // 最多等待setExitTimeout()指定的时间，超时仍未结束的工作线程（如解析目录时挂起）被放弃，不阻塞进程退出。
+    // 被放弃的工作线程持有共享的内部状态，但仍可能调用注入的步骤，直至进程结束。
+    ~LaunchPipeline();
+    LaunchPipeline(const LaunchPipeline&) = delete;
+    LaunchPipeline& operator=(const LaunchPipeline&) = delete;
+
+    // 在新的工作线程中执行流程，不阻塞调用线程（热键回调线程）。
+    void trigger(bool isAdmin);
+
+    // 以下设置需在第一次trigger()前完成。
+    // 替换计时使用的时钟（默认为LatencyStats::Clock），如模拟中的虚拟时钟。
+    void setClock(Now now) { state_->now = std::move(now); }
+    // 替换执行方式，如模拟中在调用线程中同步执行，以保证结果可复现。
+    void setExecutor(Executor executor) { executor_ = std::move(executor); }
+    // 析构时等待工作线程结束的最长时间，默认为DEFAULT_EXIT_TIMEOUT。
+    void setExitTimeout(std::chrono::milliseconds timeout) { exitTimeout_ = timeout; }
+
+    // 开启时，同一热键在上一次触发完成前的再次触发（如按住热键时的重复）被忽略。默认关闭，与原有行为一致，
+    // 由负载测试（ocaw_harness）开启以评估效果。
+    void setCoalescing(bool enabled) { coalescing_.store(enabled, std::memory_order_relaxed); }
+    // 阻塞直到所有工作线程结束。
+    void waitIdle();
+    // 最多阻塞timeout，返回是否所有工作线程均已结束。
+    bool waitIdleFor(std::chrono::milliseconds timeout);
+    Stats stats() const;
+
+    static constexpr std::chrono::milliseconds DEFAULT_EXIT_TIMEOUT{2000};
+
+private:
+    // 工作线程访问的全部状态，由本对象与各工作线程共享，被放弃的工作线程结束前保持有效。
+    struct State
+    {
+        ConfigSource configSource;
+        Resolver resolver;
+        Launcher launcher;
+        Now now;
+
+        // 按热键（以用户/管理员身份运行）区分是否有未完成的触发。
+        std::atomic<bool> inFlight[2] = {};
+
+        std::atomic<uint64_t> launched{0};
+        std::atomic<uint64_t> failed{0};
+
+        mutable std::mutex workerMtx;
+        std::condition_variable workerCv;
+        uint64_t activeWorkers = 0;
+        uint64_t peakWorkers = 0;
+    };
+
+    static void run_(State& state, bool isAdmin, LatencyStats::TimePoint callbackTime);
+    static void workerExited_(State& state);
+
+    std::shared_ptr<State> state_;
+    Executor executor_;
+    std::chrono::milliseconds exitTimeout_ = DEFAULT_EXIT_TIMEOUT;
+
+    std::atomic<bool> coalescing_{false};
+    std::atomic<uint64_t> triggered_{0};
+    std::atomic<uint64_t> coalesced_{0};
+};
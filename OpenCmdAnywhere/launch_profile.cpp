@@ -0,0 +1,98 @@
+#include "launch_profile.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <map>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+LaunchProfiles::LaunchProfiles() :
+    nodes_({ { 0, 0, -1 } })
+{}
+
+LaunchProfiles::LaunchProfiles(std::vector<LaunchProfile> profiles)
+{
+    // 先以有序映射构建，再展平为连续的数组，匹配时每个字符只需在子节点中二分查找。
+    std::vector<std::map<wchar_t, uint32_t>> children(1);
+    std::vector<int32_t> nodeProfiles(1, -1);
+
+    for (auto& profile : profiles)
+    {
+        std::wstring_view directory = profile.directory;
+        // 去掉末尾的分隔符，但保留只由分隔符组成的根目录（如"/"）。
+        auto end = directory.find_last_not_of(L"\\/");
+        if (end != std::wstring_view::npos)
+            directory = directory.substr(0, end + 1);
+        if (directory.empty())
+            continue;
+
+        uint32_t node = 0;
+        for (wchar_t ch : directory)
+        {
+            auto result = children[node].emplace(fold_(ch), static_cast<uint32_t>(children.size()));
+            if (result.second)
+            {
+                children.emplace_back();
+                nodeProfiles.push_back(-1);
+            }
+            node = result.first->second;
+        }
+        if (nodeProfiles[node] >= 0)
+            continue;
+
+        nodeProfiles[node] = static_cast<int32_t>(profiles_.size());
+        usesExe_ = usesExe_ || (profile.parameter && profile.parameter->usesExe());
+        profiles_.push_back(std::move(profile));
+    }
+
+    nodes_.reserve(children.size());
+    edges_.reserve(children.size() - 1);
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        nodes_.push_back({ static_cast<uint32_t>(edges_.size()), static_cast<uint32_t>(children[i].size()),
+            nodeProfiles[i] });
+        for (const auto& child : children[i])
+            edges_.push_back({ child.first, child.second });
+    }
+}
+
+const LaunchProfile* LaunchProfiles::match(std::wstring_view directory) const
+{
+    const LaunchProfile* matched = nullptr;
+    uint32_t node = 0;
+    for (size_t i = 0;; ++i)
+    {
+        const auto& current = nodes_[node];
+        // 规则在路径的末尾、分隔符前或以分隔符结束（根目录）时匹配。
+        if (current.profile >= 0 &&
+            (i == directory.size() || isSeparator_(directory[i]) || isSeparator_(directory[i - 1])))
+            matched = &profiles_[current.profile];
+        if (i == directory.size() || current.edgeCount == 0)
+            break;
+
+        auto first = edges_.begin() + current.firstEdge;
+        auto last = first + current.edgeCount;
+        wchar_t ch = fold_(directory[i]);
+        auto edge = std::lower_bound(first, last, ch, [](const Edge& e, wchar_t c) { return e.ch < c; });
+        if (edge == last || edge->ch != ch)
+            break;
+        node = edge->node;
+    }
+    return matched;
+}
+
+wchar_t LaunchProfiles::fold_(wchar_t ch)
+{
+    if (ch == L'/')
+        return L'\\';
+    if (ch < 0x80)
+        return ch >= L'A' && ch <= L'Z' ? ch - L'A' + L'a' : ch;
+#ifdef _WIN32
+    // 不受C运行库的区域设置影响。
+    return static_cast<wchar_t>(reinterpret_cast<ULONG_PTR>(CharLowerW(reinterpret_cast<LPWSTR>(static_cast<ULONG_PTR>(ch)))));
+#else
+    return static_cast<wchar_t>(std::towlower(static_cast<wint_t>(ch)));
+#endif
+}
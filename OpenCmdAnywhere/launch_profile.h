@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parameter_template.h"
+
+// 按目录前缀选择的可执行文件与参数，如D:\repos下使用Git Bash。
+struct LaunchProfile
+{
+    // 目录前缀，不区分大小写，'/'与'\\'等同，末尾的分隔符可省略。
+    std::wstring directory;
+    std::wstring executable;
+    // 为空时参数为空。
+    std::shared_ptr<const ParameterTemplate> parameter;
+};
+
+// 启动配置的集合，在设置改变时构建为不区分大小写的路径前缀树（字典树），
+// 匹配的耗时与目录的长度成正比，与规则的数量无关。构建后只读，可被多个线程同时使用。
+class LaunchProfiles
+{
+public:
+    LaunchProfiles();
+    // 目录为空的规则被忽略，目录相同的规则只保留第一条。
+    explicit LaunchProfiles(std::vector<LaunchProfile> profiles);
+
+    size_t size() const { return profiles_.size(); }
+    bool empty() const { return profiles_.empty(); }
+    // 是否有规则的参数需要获取焦点窗口所属进程的可执行文件路径。
+    bool usesExe() const { return usesExe_; }
+
+    // 目录所在的最长（最具体）的规则，前缀只在路径的分隔处匹配（D:\repos不匹配D:\repos2），没有时返回空指针。
+    const LaunchProfile* match(std::wstring_view directory) const;
+
+private:
+    struct Edge
+    {
+        wchar_t ch;
+        uint32_t node;
+    };
+
+    struct Node
+    {
+        // 子节点在edges_中的范围，按字符排序。
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        // 在此结束的规则在profiles_中的序号，没有时为-1。
+        int32_t profile;
+    };
+
+    static bool isSeparator_(wchar_t ch) { return ch == L'\\' || ch == L'/'; }
+    // 统一分隔符并折叠大小写。
+    static wchar_t fold_(wchar_t ch);
+
+    std::vector<LaunchProfile> profiles_;
+    std::vector<Node> nodes_;
+    std::vector<Edge> edges_;
+    bool usesExe_ = false;
+};
@@ -0,0 +1,235 @@
+#include "launcher.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <filesystem>
+
+#include <windows.h>
+#include <shellapi.h>
+#else
+#include <cerrno>
+
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "trace_recorder.h"
+
+extern char** environ;
+#endif
+
+#include "metrics.h"
+
+#ifdef _WIN32
+
+int ProcessLauncher::waitProcess(Process process)
+{
+    if (process == INVALID_PROCESS)
+        return -1;
+    HANDLE handle = reinterpret_cast<HANDLE>(process);
+    DWORD exitCode = 0;
+    bool ok = WaitForSingleObject(handle, INFINITE) == WAIT_OBJECT_0 && GetExitCodeProcess(handle, &exitCode);
+    CloseHandle(handle);
+    return ok ? static_cast<int>(exitCode) : -1;
+}
+
+// 展开字符串中的环境变量（%NAME%），失败时返回原字符串。
+static std::wstring expandEnvironment(const std::wstring& str)
+{
+    if (str.find(L'%') == std::wstring::npos)
+        return str;
+    DWORD size = ExpandEnvironmentStringsW(str.c_str(), nullptr, 0);
+    if (size == 0)
+        return str;
+    std::wstring result(size, L'\0');
+    size = ExpandEnvironmentStringsW(str.c_str(), result.data(), size);
+    if (size == 0)
+        return str;
+    result.resize(size - 1);
+    return result;
+}
+
+bool ShellExecuteLauncher::launch(const std::wstring& executable, const std::wstring& workDirectory,
+                                  const std::wstring& parameter, bool isAdmin, Process* process)
+{
+    // 只展开可执行文件。SEE_MASK_DOENVSUBST也会展开工作目录，而解析的目录中的%是字面字符。
+    auto exe = expandEnvironment(executable);
+    SHELLEXECUTEINFOW sei = {0};
+    sei.cbSize = sizeof(sei);
+    sei.fMask = process ? SEE_MASK_NOCLOSEPROCESS : 0;
+    sei.lpVerb = isAdmin ? L"runas" : L"open";
+    sei.lpFile = exe.c_str();
+    sei.lpParameters = parameter.c_str();
+    sei.lpDirectory = workDirectory.c_str();
+    sei.nShow = SW_SHOW;
+    if (!ShellExecuteExW(&sei))
+        return false;
+    if (process)
+        *process = sei.hProcess ? reinterpret_cast<Process>(sei.hProcess) : INVALID_PROCESS;
+    return true;
+}
+
+bool CreateProcessLauncher::launch(const std::wstring& executable, const std::wstring& workDirectory,
+                                   const std::wstring& parameter, bool isAdmin, Process* process)
+{
+    if (isAdmin)
+        return false;
+
+    auto exe = expandEnvironment(executable);
+    if (_wcsicmp(std::filesystem::path(exe).extension().c_str(), L".exe") != 0)
+        return false;
+
+    // 不指定lpApplicationName，使仅有文件名的可执行文件（如cmd.exe）按与ShellExecute相同的方式在PATH中查找。
+    std::wstring commandLine = L"\"" + exe + L"\"";
+    // 参数由ParameterTemplate在编译时展开，其中目录等的值可能含有字面的%，不再展开。
+    if (!parameter.empty())
+        commandLine += L" " + parameter;
+
+    STARTUPINFOW si = {0};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESHOWWINDOW;
+    si.wShowWindow = hidden_ ? SW_HIDE : SW_SHOW;
+    PROCESS_INFORMATION pi = {0};
+    // 本程序没有控制台，控制台程序（如cmd.exe）需要新的控制台窗口。
+    if (!CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, FALSE,
+            CREATE_NEW_CONSOLE | CREATE_DEFAULT_ERROR_MODE, nullptr,
+            workDirectory.empty() ? nullptr : workDirectory.c_str(), &si, &pi))
+        return false;
+
+    CloseHandle(pi.hThread);
+    if (process)
+        *process = reinterpret_cast<Process>(pi.hProcess);
+    else
+        CloseHandle(pi.hProcess);
+    return true;
+}
+
+#else
+
+int ProcessLauncher::waitProcess(Process process)
+{
+    if (process == INVALID_PROCESS)
+        return -1;
+    int status = 0;
+    pid_t ret;
+    do
+    {
+        ret = waitpid(static_cast<pid_t>(process), &status, 0);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0 || !WIFEXITED(status))
+        return -1;
+    return WEXITSTATUS(status);
+}
+
+SpawnLauncher::~SpawnLauncher()
+{
+    for (auto child : children_)
+        waitProcess(child);
+}
+
+std::vector<std::string> SpawnLauncher::splitParameter(const std::string& parameter)
+{
+    std::vector<std::string> args;
+    std::string arg;
+    bool inArg = false, inQuote = false;
+    for (size_t i = 0; i < parameter.size(); ++i)
+    {
+        char ch = parameter[i];
+        if (ch == '\\' && i + 1 < parameter.size() && parameter[i + 1] == '"')
+        {
+            arg += '"';
+            inArg = true;
+            ++i;
+        }
+        else if (ch == '"')
+        {
+            inQuote = !inQuote;
+            inArg = true;
+        }
+        else if ((ch == ' ' || ch == '\t') && !inQuote)
+        {
+            if (inArg)
+                args.push_back(std::move(arg));
+            arg.clear();
+            inArg = false;
+        }
+        else
+        {
+            arg += ch;
+            inArg = true;
+        }
+    }
+    if (inArg)
+        args.push_back(std::move(arg));
+    return args;
+}
+
+bool SpawnLauncher::launch(const std::wstring& executable, const std::wstring& workDirectory,
+                           const std::wstring& parameter, bool isAdmin, Process* process)
+{
+    if (isAdmin || executable.empty())
+        return false;
+
+    reapChildren_();
+
+    auto exe = trace::toUtf8(executable);
+    auto args = splitParameter(trace::toUtf8(parameter));
+    std::vector<char*> argv;
+    argv.push_back(exe.data());
+    for (auto& arg : args)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    auto directory = trace::toUtf8(workDirectory);
+    if (!directory.empty())
+        posix_spawn_file_actions_addchdir_np(&actions, directory.c_str());
+
+    pid_t pid;
+    int rc = posix_spawnp(&pid, exe.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0)
+        return false;
+
+    if (process)
+    {
+        *process = pid;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        children_.push_back(pid);
+    }
+    return true;
+}
+
+void SpawnLauncher::reapChildren_()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    children_.erase(std::remove_if(children_.begin(), children_.end(), [](Process child)
+        {
+            int status;
+            return waitpid(static_cast<pid_t>(child), &status, WNOHANG) != 0;
+        }), children_.end());
+}
+
+#endif
+
+FallbackLauncher::FallbackLauncher(std::unique_ptr<ProcessLauncher> primary, std::unique_ptr<ProcessLauncher> fallback) :
+    primary_(std::move(primary)),
+    fallback_(std::move(fallback))
+{}
+
+bool FallbackLauncher::launch(const std::wstring& executable, const std::wstring& workDirectory,
+                              const std::wstring& parameter, bool isAdmin, Process* process)
+{
+    static auto& fallbacks = Metrics::counter("ocaw_launch_fallbacks_total",
+        "The number of the launches not handled by the direct process creation.");
+
+    if (primary_->launch(executable, workDirectory, parameter, isAdmin, process))
+        return true;
+    fallbacks.increment();
+    return fallback_->launch(executable, workDirectory, parameter, isAdmin, process);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 启动可执行文件的方式。
+class ProcessLauncher
+{
+public:
+    // Windows上为进程的HANDLE，POSIX上为进程ID。
+    using Process = intptr_t;
+    static constexpr Process INVALID_PROCESS = -1;
+
+    virtual ~ProcessLauncher() = default;
+
+    virtual const char* name() const = 0;
+
+    // 参数依次为可执行文件、工作目录（为空时继承当前目录）、参数与是否以管理员身份运行。失败或不支持时返回false。
+    // process不为空时返回启动的进程（可能为INVALID_PROCESS，如由已有实例打开），调用者需以waitProcess()等待其结束。
+    virtual bool launch(const std::wstring& executable, const std::wstring& workDirectory,
+                        const std::wstring& parameter, bool isAdmin, Process* process = nullptr) = 0;
+
+    // 等待进程结束并释放其资源，返回退出码，失败时返回-1。
+    static int waitProcess(Process process);
+};
+
+#ifdef _WIN32
+
+// ShellExecuteExW：支持以管理员身份运行（runas）与文件关联（如快捷方式与脚本），但会加载外壳扩展。
+// 可执行文件中的环境变量（%NAME%）会被展开，参数与工作目录不展开。
+class ShellExecuteLauncher : public ProcessLauncher
+{
+public:
+    const char* name() const override { return "shell_execute"; }
+    bool launch(const std::wstring& executable, const std::wstring& workDirectory,
+                const std::wstring& parameter, bool isAdmin, Process* process = nullptr) override;
+};
+
+// CreateProcessW：直接创建进程，不经过外壳。与ShellExecuteLauncher一致，只展开可执行文件中的环境变量（%NAME%）。
+// 不支持以管理员身份运行与非.exe文件，此时返回false。
+class CreateProcessLauncher : public ProcessLauncher
+{
+public:
+    // hidden为true时隐藏新进程的窗口（如待命实例）。
+    explicit CreateProcessLauncher(bool hidden = false) : hidden_(hidden) {}
+
+    const char* name() const override { return "create_process"; }
+    bool launch(const std::wstring& executable, const std::wstring& workDirectory,
+                const std::wstring& parameter, bool isAdmin, Process* process = nullptr) override;
+
+private:
+    bool hidden_;
+};
+
+#else
+
+// posix_spawnp：用于在Linux上运行负载测试与基准测试。
+// 参数按空白拆分，双引号内的空白不拆分，\"表示引号本身。不支持以管理员身份运行。线程安全。
+class SpawnLauncher : public ProcessLauncher
+{
+public:
+    // 等待所有未由调用者接管的子进程结束。
+    ~SpawnLauncher() override;
+
+    const char* name() const override { return "posix_spawn"; }
+    bool launch(const std::wstring& executable, const std::wstring& workDirectory,
+                const std::wstring& parameter, bool isAdmin, Process* process = nullptr) override;
+
+    static std::vector<std::string> splitParameter(const std::string& parameter);
+
+private:
+    // 回收已结束的未接管子进程，避免产生僵尸进程。
+    void reapChildren_();
+
+    std::mutex mtx_;
+    std::vector<Process> children_;
+};
+
+#endif
+
+// 先使用primary启动，其失败或不支持时（如以管理员身份运行）使用fallback。
+class FallbackLauncher : public ProcessLauncher
+{
+public:
+    FallbackLauncher(std::unique_ptr<ProcessLauncher> primary, std::unique_ptr<ProcessLauncher> fallback);
+
+    const char* name() const override { return "fallback"; }
+    bool launch(const std::wstring& executable, const std::wstring& workDirectory,
+                const std::wstring& parameter, bool isAdmin, Process* process = nullptr) override;
+
+private:
+    std::unique_ptr<ProcessLauncher> primary_;
+    std::unique_ptr<ProcessLauncher> fallback_;
+};
@@ -4,12 +4,17 @@
 
 #include <easy_translate.hpp>
 #include <minilog.hpp>
+#include <minilog_binary.hpp>
+#include <minilog_mapped.hpp>
 
 #include "config.h"
+#include "core.h"
 #include "hotkey_handler.h"
 #include "language.h"
+#include "metrics.h"
 #include "settings.h"
 #include "systemtray.h"
+#include "trace_recorder.h"
 
 int main(int argc, char* argv[])
 {
@@ -18,9 +23,60 @@ int main(int argc, char* argv[])
         return 0;
 
 #ifdef OCAW_OUTLOG
+    // 需在全局Logger创建前声明，以保证日志环在Logger析构后才被销毁。
+    static std::unique_ptr<mlog::MappedRing> logRing;
     mlog::addOs("Deafult", std::clog);
+    try
+    {
+        // 日志环位于内存映射文件中，进程崩溃后仍保留最近的日志，使用mlog_ring工具读取。
+        logRing.reset(new mlog::MappedRing(QDir::temp().absoluteFilePath(APP_RING_FILENAME).toStdString(),
+            256 * 1024));
+        mlog::addOs("Ring", logRing->stream(), mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    } catch (std::exception& e)
+    {
+        mlog::warning("Failed to map the log ring, exception: {}", e.what());
+    }
+    try
+    {
+        // 常驻进程的日志文件按大小轮转，只保留最近的几个文件。
+        mlog::RotatingFileOptions logFileOptions;
+        logFileOptions.maxFileSize = 1024 * 1024;
+        logFileOptions.maxFiles = 3;
+        mlog::addOs("File", QDir::temp().absoluteFilePath(APP_LOG_FILENAME).toStdString(),
+            logFileOptions, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    } catch (std::exception& e)
+    {
+        mlog::warning("Failed to open the log file, exception: {}", e.what());
+    }
+    try
+    {
+        // 结构化事件以JSON Lines格式输出，便于日志管线直接解析字段。
+        mlog::RotatingFileOptions eventFileOptions;
+        eventFileOptions.maxFileSize = 1024 * 1024;
+        eventFileOptions.maxFiles = 3;
+        mlog::addOs("Event", QDir::temp().absoluteFilePath(APP_EVENT_FILENAME).toStdString(),
+            eventFileOptions, mlog::OUT_AS_JSON | mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    } catch (std::exception& e)
+    {
+        mlog::warning("Failed to open the event file, exception: {}", e.what());
+    }
+    mlog::setTimestampPrecision(mlog::TIMESTAMP_MILLISECOND);
+    // 日志由后台线程写出，避免缓慢的输出流阻塞热键线程和GUI线程。
+    mlog::enableAsync(4096, mlog::OVERFLOW_DROP_OLDEST);
 #endif // OCAW_OUTLOG
 
+#ifdef OCAW_BINLOG
+    // 热键路径的追踪日志，使用mlog_decode工具转换为文本日志。
+    try
+    {
+        mlog::bin::BinaryLogger::getGlobalInstance().open(
+            QDir::temp().absoluteFilePath(APP_TRACE_FILENAME).toStdString());
+    } catch (std::exception& e)
+    {
+        mlog::warning("Failed to open the binary trace log, exception: {}", e.what());
+    }
+#endif // OCAW_BINLOG
+
     QApplication a(argc, argv);
     a.setOrganizationName(APP_ORGANIZATION);
     a.setApplicationName(APP_TITLE);
@@ -30,6 +86,10 @@ int main(int argc, char* argv[])
     langId = setLanguage(langId);
     Settings::setLanguage(langId);
 
+    setDirectLaunch(Settings::getIsDirectLaunch());
+    setStandbyPool(Settings::getStandbyPoolSize(), Settings::getStandbyIdleExpiry(), Settings::getStandbyMemoryLimit(),
+        Settings::getCurrentExecutable().second.toStdWString(), Settings::getParameterTemplate()->expand({}));
+
     auto runAsUserKc = Settings::getKeyCombination(false);
     auto runAsAdminKc = Settings::getKeyCombination(true);
     runAsUserKc = HotkeyHandler::setHotkey(runAsUserKc, false);
@@ -37,13 +97,51 @@ int main(int argc, char* argv[])
     Settings::setKeyCombination(runAsUserKc, false);
     Settings::setKeyCombination(runAsAdminKc, true);
 
+#ifdef OCAW_OUTLOG
+    Metrics::counterCallback("ocaw_log_messages_dropped_total", "The number of the log messages dropped by the async queue.",
+        "", []() { return mlog::Logger::getGlobalInstance().droppedCount(); });
+#endif // OCAW_OUTLOG
+    // 指标文件供node exporter的textfile收集器读取，未配置路径时不导出。
+    auto metricsFile = Settings::getMetricsFile();
+    if (!metricsFile.isEmpty())
+        Metrics::startExport(metricsFile.toStdString(), Settings::getMetricsInterval());
+
+    // 追踪记录用于离线重放（ocaw_replay工具），包含窗口类名与目录，仅在配置了路径时开启。
+    auto traceFile = Settings::getTraceFile();
+    if (!traceFile.isEmpty())
+    {
+        try
+        {
+            trace::Recorder::open(traceFile.toStdString());
+            if (!installForegroundRecorder())
+                mlog::warning("Failed to install the foreground window hook");
+        } catch (std::exception& e)
+        {
+            mlog::warning("Failed to open the trace file, exception: {}", e.what());
+        }
+    }
+
     SystemTray st;
     st.show();
-    a.installEventFilter(&st);
 
     int ret = a.exec();
 
+    Metrics::stopExport();
+    stopStandbyPool();
+    uninstallForegroundRecorder();
+    trace::Recorder::close();
+
     easytr::updateTranslationsFiles();
 
+#ifdef OCAW_OUTLOG
+    // 报告限流调用点尚未输出的抑制数量，再写出所有排队中的日志，此后的日志（如单例析构时）同步写出。
+    mlog::RateLimitedSite::reportAll(true);
+    mlog::disableAsync();
+#endif // OCAW_OUTLOG
+
+#ifdef OCAW_BINLOG
+    mlog::bin::BinaryLogger::getGlobalInstance().close();
+#endif // OCAW_BINLOG
+
     return ret;
 }
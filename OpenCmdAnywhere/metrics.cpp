@@ -0,0 +1,203 @@
+#include "metrics.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "latency.h"
+
+uint64_t Counter::value() const
+{
+    uint64_t total = 0;
+    for (const auto& shard : shards_)
+        total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t Counter::shardIndex_()
+{
+    // 线程按创建顺序轮流分配分片，线程数不超过SHARD_COUNT时互不竞争。
+    static std::atomic<size_t> nextIndex{0};
+    thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return index;
+}
+
+Metrics& Metrics::getInstance()
+{
+    static Metrics instance;
+    return instance;
+}
+
+Metrics::~Metrics()
+{
+    stopExport();
+}
+
+Counter& Metrics::counter(const std::string& name, const std::string& help, const std::string& labels)
+{
+    auto& entry = getInstance().entry_(name, help, labels, TYPE_COUNTER);
+    return *entry.counter;
+}
+
+Gauge& Metrics::gauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+    auto& entry = getInstance().entry_(name, help, labels, TYPE_GAUGE);
+    return *entry.gauge;
+}
+
+void Metrics::counterCallback(const std::string& name, const std::string& help, const std::string& labels,
+                              std::function<uint64_t()> callback)
+{
+    auto& instance = getInstance();
+    auto& entry = instance.entry_(name, help, labels, TYPE_COUNTER);
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    entry.counterCallback = std::move(callback);
+}
+
+void Metrics::gaugeCallback(const std::string& name, const std::string& help, const std::string& labels,
+                            std::function<int64_t()> callback)
+{
+    auto& instance = getInstance();
+    auto& entry = instance.entry_(name, help, labels, TYPE_GAUGE);
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    entry.gaugeCallback = std::move(callback);
+}
+
+std::string Metrics::exposition()
+{
+    auto& instance = getInstance();
+
+    std::string text;
+    char value[32];
+    {
+        std::lock_guard<std::mutex> lock(instance.mtx_);
+        // 同名指标的不同标签需连续输出，且HELP与TYPE只输出一次。
+        std::vector<bool> written(instance.entries_.size(), false);
+        for (size_t i = 0; i < instance.entries_.size(); ++i)
+        {
+            if (written[i])
+                continue;
+
+            const auto& first = instance.entries_[i];
+            text += "# HELP " + first.name + " " + first.help + "\n";
+            text += "# TYPE " + first.name + (first.type == TYPE_COUNTER ? " counter\n" : " gauge\n");
+            for (size_t j = i; j < instance.entries_.size(); ++j)
+            {
+                const auto& entry = instance.entries_[j];
+                if (written[j] || entry.name != first.name)
+                    continue;
+                written[j] = true;
+
+                if (entry.type == TYPE_COUNTER)
+                {
+                    uint64_t v = entry.counterCallback ? entry.counterCallback() : entry.counter->value();
+                    std::snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(v));
+                }
+                else
+                {
+                    int64_t v = entry.gaugeCallback ? entry.gaugeCallback() : entry.gauge->value();
+                    std::snprintf(value, sizeof(value), "%lld", static_cast<long long>(v));
+                }
+
+                text += entry.name;
+                if (!entry.labels.empty())
+                    text += "{" + entry.labels + "}";
+                text += " ";
+                text += value;
+                text += "\n";
+            }
+        }
+    }
+
+    text += LatencyStats::metrics();
+    return text;
+}
+
+bool Metrics::writeFile(const std::string& filename)
+{
+    namespace fs = std::filesystem;
+
+    std::string text = exposition();
+    fs::path path = fs::u8path(filename);
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream ofs(tmpPath, std::ios_base::binary | std::ios_base::trunc);
+        if (!ofs.is_open())
+            return false;
+        ofs.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!ofs)
+            return false;
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+void Metrics::startExport(const std::string& filename, int intervalSeconds)
+{
+    stopExport();
+
+    auto& instance = getInstance();
+    {
+        std::lock_guard<std::mutex> lock(instance.exportMtx_);
+        instance.exportStop_ = false;
+    }
+    instance.exportThread_ = std::thread(&Metrics::exportLoop_, &instance, filename,
+        intervalSeconds > 0 ? intervalSeconds : 1);
+}
+
+void Metrics::stopExport()
+{
+    auto& instance = getInstance();
+    if (!instance.exportThread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(instance.exportMtx_);
+        instance.exportStop_ = true;
+    }
+    instance.exportCv_.notify_all();
+    instance.exportThread_.join();
+}
+
+Metrics::Entry& Metrics::entry_(const std::string& name, const std::string& help, const std::string& labels, Type type)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& entry : entries_)
+    {
+        if (entry.name == name && entry.labels == labels)
+            return entry;
+    }
+
+    entries_.emplace_back();
+    auto& entry = entries_.back();
+    entry.name = name;
+    entry.help = help;
+    entry.labels = labels;
+    entry.type = type;
+    if (type == TYPE_COUNTER)
+        entry.counter.reset(new Counter());
+    else
+        entry.gauge.reset(new Gauge());
+    return entry;
+}
+
+void Metrics::exportLoop_(std::string filename, int intervalSeconds)
+{
+    std::unique_lock<std::mutex> lock(exportMtx_);
+    while (true)
+    {
+        bool stop = exportCv_.wait_for(lock, std::chrono::seconds(intervalSeconds), [this]() { return exportStop_; });
+        lock.unlock();
+        writeFile(filename);
+        lock.lock();
+        if (stop)
+            break;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 分片计数器，每个线程固定写入其中一个独占缓存行的分片，读取时合并所有分片。
+// 递增只需一次无竞争的原子加法，不加锁，可在任意线程中使用。
+class Counter
+{
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    void increment(uint64_t n = 1) { shards_[shardIndex_()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+    static size_t shardIndex_();
+
+    Shard shards_[SHARD_COUNT];
+};
+
+class Gauge
+{
+public:
+    Gauge() = default;
+    Gauge(const Gauge&) = delete;
+    Gauge& operator=(const Gauge&) = delete;
+
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Singleton
+// 进程内的指标注册表，以Prometheus文本格式导出，并可周期性地写出到文件（供node exporter的textfile收集器读取）。
+class Metrics
+{
+public:
+    static Metrics& getInstance();
+
+    // 注册或获取已注册的指标（以name与labels区分），返回的引用在程序运行期间始终有效。
+    // labels为Prometheus的标签列表，如 site="hotkey"，可为空。
+    // 注册需加锁，热点路径中应以静态局部引用缓存返回值：
+    // static auto& counter = Metrics::counter("ocaw_threads_spawned_total", "...", "site=\"hotkey\"");
+    static Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    static Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    // 导出时才求值的指标，用于已由其他模块统计的值（如日志的丢弃数）。
+    static void counterCallback(const std::string& name, const std::string& help, const std::string& labels,
+                                std::function<uint64_t()> callback);
+    static void gaugeCallback(const std::string& name, const std::string& help, const std::string& labels,
+                              std::function<int64_t()> callback);
+
+    // 所有指标（包括热键延迟）的Prometheus文本格式。
+    static std::string exposition();
+    // 先写出临时文件再重命名，保证读取方不会读到不完整的文件。filename为UTF-8编码。
+    static bool writeFile(const std::string& filename);
+
+    // 在后台线程中每隔intervalSeconds秒写出一次指标文件，重复调用会替换之前的设置。
+    static void startExport(const std::string& filename, int intervalSeconds);
+    // 停止后台线程，并最后写出一次指标文件。
+    static void stopExport();
+
+private:
+    Metrics() = default;
+    ~Metrics();
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    enum Type
+    {
+        TYPE_COUNTER,
+        TYPE_GAUGE
+    };
+
+    struct Entry
+    {
+        std::string name;
+        std::string help;
+        std::string labels;
+        Type type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::function<uint64_t()> counterCallback;
+        std::function<int64_t()> gaugeCallback;
+    };
+
+    Entry& entry_(const std::string& name, const std::string& help, const std::string& labels, Type type);
+    void exportLoop_(std::string filename, int intervalSeconds);
+
+    std::mutex mtx_;
+    // deque的元素地址在尾部插入时保持不变。
+    std::deque<Entry> entries_;
+
+    std::mutex exportMtx_;
+    std::condition_variable exportCv_;
+    bool exportStop_ = false;
+    std::thread exportThread_;
+};
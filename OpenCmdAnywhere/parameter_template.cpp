@@ -0,0 +1,233 @@
+#include "parameter_template.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include "trace_recorder.h"
+#endif
+
+// 读取环境变量，不存在时返回false。
+static bool environmentVariable(const std::wstring& name, std::wstring& value)
+{
+#ifdef _WIN32
+    const wchar_t* str = _wgetenv(name.c_str());
+    if (!str)
+        return false;
+    value = str;
+#else
+    const char* str = std::getenv(trace::toUtf8(name).c_str());
+    if (!str)
+        return false;
+    value = trace::fromUtf8(str);
+#endif
+    return true;
+}
+
+ParameterTemplate::ParameterTemplate(const std::wstring& text) :
+    text_(text)
+{
+    static const std::wstring_view ENV_PREFIX = L"env:";
+
+    // 两个占位符之间的原始文本，在遇到占位符或结束时展开其中的%NAME%。
+    std::wstring literal;
+    std::wstring_view rest = text_;
+    while (!rest.empty())
+    {
+        auto open = rest.find(L'{');
+        if (open == std::wstring_view::npos)
+        {
+            literal.append(rest);
+            break;
+        }
+        literal.append(rest.substr(0, open));
+        rest.remove_prefix(open);
+
+        auto close = rest.find(L'}');
+        auto name = close == std::wstring_view::npos ? std::wstring_view() : rest.substr(1, close - 1);
+        TokenType type = TOKEN_LITERAL;
+        if (name == L"dir")
+            type = TOKEN_DIR;
+        else if (name == L"dir_quoted")
+            type = TOKEN_DIR_QUOTED;
+        else if (name == L"exe")
+            type = TOKEN_EXE;
+        else if (name == L"exe_dir")
+            type = TOKEN_EXE_DIR;
+        else if (name.size() > ENV_PREFIX.size() && name.substr(0, ENV_PREFIX.size()) == ENV_PREFIX &&
+                 name.find(L'{') == std::wstring_view::npos)
+        {
+            // 变量的值原样保留，不再展开其中的%NAME%。
+            std::wstring value;
+            environmentVariable(std::wstring(name.substr(ENV_PREFIX.size())), value);
+            appendExpanded_(literal);
+            literal.clear();
+            appendLiteral_(value);
+            rest.remove_prefix(close + 1);
+            continue;
+        }
+        else
+        {
+            // 不是占位符，花括号作为字面字符，从其后继续查找。
+            literal += rest[0];
+            rest.remove_prefix(1);
+            continue;
+        }
+
+        appendExpanded_(literal);
+        literal.clear();
+        tokens_.push_back({ type, 0, 0 });
+        usesExe_ = usesExe_ || type == TOKEN_EXE || type == TOKEN_EXE_DIR;
+        contextFree_ = false;
+        rest.remove_prefix(close + 1);
+    }
+    appendExpanded_(literal);
+}
+
+void ParameterTemplate::appendExpanded_(std::wstring_view literal)
+{
+    while (!literal.empty())
+    {
+        auto open = literal.find(L'%');
+        auto close = open == std::wstring_view::npos ? open : literal.find(L'%', open + 1);
+        if (close == std::wstring_view::npos)
+        {
+            appendLiteral_(literal);
+            return;
+        }
+
+        std::wstring value;
+        if (close > open + 1 && environmentVariable(std::wstring(literal.substr(open + 1, close - open - 1)), value))
+        {
+            appendLiteral_(literal.substr(0, open));
+            appendLiteral_(value);
+            literal.remove_prefix(close + 1);
+        }
+        else
+        {
+            // 未定义的变量保持原样，结束的%可作为下一个变量的开始。
+            appendLiteral_(literal.substr(0, close));
+            literal.remove_prefix(close);
+        }
+    }
+}
+
+void ParameterTemplate::appendLiteral_(std::wstring_view literal)
+{
+    if (literal.empty())
+        return;
+    // 合并相邻的字面片段。
+    if (!tokens_.empty() && tokens_.back().type == TOKEN_LITERAL)
+    {
+        tokens_.back().length += literal.size();
+    }
+    else
+    {
+        tokens_.push_back({ TOKEN_LITERAL, literals_.size(), literal.size() });
+    }
+    literals_.append(literal);
+}
+
+void ParameterTemplate::expand(const Context& context, std::wstring& output) const
+{
+    auto exeDirectory = parentDirectory(context.exePath);
+    auto value = [&](const Token& token)
+    {
+        switch (token.type)
+        {
+        case TOKEN_LITERAL: return std::wstring_view(literals_).substr(token.offset, token.length);
+        case TOKEN_DIR:     return context.directory;
+        case TOKEN_EXE:     return context.exePath;
+        case TOKEN_EXE_DIR: return exeDirectory;
+        default:            return std::wstring_view();
+        }
+    };
+
+    size_t length = 0;
+    for (const auto& token : tokens_)
+        length += token.type == TOKEN_DIR_QUOTED ? quotedLength_(context.directory) : value(token).size();
+
+    output.resize(length);
+    wchar_t* dest = output.data();
+    for (const auto& token : tokens_)
+    {
+        if (token.type == TOKEN_DIR_QUOTED)
+        {
+            dest = writeQuoted_(context.directory, dest);
+            continue;
+        }
+        auto str = value(token);
+        dest = std::copy(str.begin(), str.end(), dest);
+    }
+}
+
+std::wstring ParameterTemplate::expand(const Context& context) const
+{
+    std::wstring output;
+    expand(context, output);
+    return output;
+}
+
+std::wstring ParameterTemplate::quote(std::wstring_view argument)
+{
+    std::wstring output(quotedLength_(argument), L'\0');
+    writeQuoted_(argument, output.data());
+    return output;
+}
+
+std::wstring_view ParameterTemplate::parentDirectory(std::wstring_view path)
+{
+    auto pos = path.find_last_of(L"\\/");
+    if (pos == std::wstring_view::npos)
+        return std::wstring_view();
+    // 根目录保留分隔符，如"C:\\"与"/"。
+    if (pos == 0 || (pos == 2 && path[1] == L':'))
+        return path.substr(0, pos + 1);
+    return path.substr(0, pos);
+}
+
+// 引号前与末尾（结束的引号前）的反斜杠需要加倍，引号需转义为\"。
+size_t ParameterTemplate::quotedLength_(std::wstring_view argument)
+{
+    size_t length = 2;
+    size_t backslashes = 0;
+    for (wchar_t ch : argument)
+    {
+        if (ch == L'\\')
+        {
+            ++backslashes;
+            continue;
+        }
+        length += ch == L'"' ? backslashes * 2 + 2 : backslashes + 1;
+        backslashes = 0;
+    }
+    return length + backslashes * 2;
+}
+
+wchar_t* ParameterTemplate::writeQuoted_(std::wstring_view argument, wchar_t* dest)
+{
+    *dest++ = L'"';
+    size_t backslashes = 0;
+    for (wchar_t ch : argument)
+    {
+        if (ch == L'\\')
+        {
+            ++backslashes;
+            continue;
+        }
+        if (ch == L'"')
+        {
+            dest = std::fill_n(dest, backslashes * 2 + 1, L'\\');
+            *dest++ = L'"';
+        }
+        else
+        {
+            dest = std::fill_n(dest, backslashes, L'\\');
+            *dest++ = ch;
+        }
+        backslashes = 0;
+    }
+    dest = std::fill_n(dest, backslashes * 2, L'\\');
+    *dest++ = L'"';
+    return dest;
+}
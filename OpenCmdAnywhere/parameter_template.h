@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 启动参数的模板，在保存参数时编译为片段列表，每次启动时只需一次线性的填充。
+// 占位符：
+//   {dir}          解析的目录
+//   {dir_quoted}   加引号的目录，按CommandLineToArgvW()的规则转义（如末尾的反斜杠）
+//   {exe}          焦点窗口所属进程的可执行文件路径
+//   {exe_dir}      焦点窗口所属进程的可执行文件所在目录
+//   {env:NAME}     环境变量，在编译时读取（本进程的环境变量在启动后不会改变），不存在时为空
+// 其它花括号（如PowerShell的脚本块）保持不变，因此不含占位符的参数与原来相同。
+// 模板文本中的%NAME%在编译时按ExpandEnvironmentStringsW()的规则展开（未定义的保持原样）；
+// 占位符的值（如含%的目录）不展开，启动时也不再展开参数。
+class ParameterTemplate
+{
+public:
+    struct Context
+    {
+        std::wstring_view directory;
+        // 为空时{exe}与{exe_dir}为空。
+        std::wstring_view exePath;
+    };
+
+    ParameterTemplate() = default;
+    explicit ParameterTemplate(const std::wstring& text);
+
+    const std::wstring& text() const { return text_; }
+    // 是否需要获取焦点窗口所属进程的可执行文件路径。
+    bool usesExe() const { return usesExe_; }
+    // 展开的结果是否与目录及焦点窗口无关。
+    bool isContextFree() const { return contextFree_; }
+
+    // 展开到output，复用其容量，计算长度后只分配一次。
+    void expand(const Context& context, std::wstring& output) const;
+    std::wstring expand(const Context& context) const;
+
+    // 按CommandLineToArgvW()的规则加引号并转义的参数。
+    static std::wstring quote(std::wstring_view argument);
+    // 可执行文件路径的所在目录，如"C:\\Windows\\System32\\cmd.exe"为"C:\\Windows\\System32"，"C:\\a.exe"为"C:\\"。
+    static std::wstring_view parentDirectory(std::wstring_view path);
+
+private:
+    enum TokenType
+    {
+        TOKEN_LITERAL,
+        TOKEN_DIR,
+        TOKEN_DIR_QUOTED,
+        TOKEN_EXE,
+        TOKEN_EXE_DIR
+    };
+
+    struct Token
+    {
+        TokenType type;
+        // 字面片段在literals_中的范围。
+        size_t offset;
+        size_t length;
+    };
+
+    static size_t quotedLength_(std::wstring_view argument);
+    static wchar_t* writeQuoted_(std::wstring_view argument, wchar_t* dest);
+    void appendLiteral_(std::wstring_view literal);
+    // 展开literal中的%NAME%后追加。
+    void appendExpanded_(std::wstring_view literal);
+
+    std::wstring text_;
+    std::wstring literals_;
+    std::vector<Token> tokens_;
+    bool usesExe_ = false;
+    bool contextFree_ = true;
+};
@@ -0,0 +1,125 @@
+#include "resolver.h"
+
+#include "metrics.h"
+#include "trace_recorder.h"
+
+bool ExeDirectoryCache::find(WindowSystem::Window window, uint32_t processId, std::wstring& directory)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(Key{ window, processId });
+    if (it == entries_.end())
+        return false;
+    directory = it->second;
+    return true;
+}
+
+void ExeDirectoryCache::insert(WindowSystem::Window window, uint32_t processId, const std::wstring& directory)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Key key{ window, processId };
+    if (!entries_.emplace(key, directory).second)
+        return;
+
+    order_.push_back(key);
+    if (order_.size() > capacity_)
+    {
+        entries_.erase(order_.front());
+        order_.pop_front();
+    }
+}
+
+void ExeDirectoryCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    entries_.clear();
+    order_.clear();
+}
+
+size_t ExeDirectoryCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return entries_.size();
+}
+
+// 从缓存中获取，未命中时查询并插入缓存。
+static std::wstring cachedExeDirectory(WindowSystem& windowSystem, WindowSystem::Window window,
+                                       ExeDirectoryCache* cache)
+{
+    static auto& cacheHits = Metrics::counter("ocaw_exe_directory_cache_total",
+        "The number of the executable directory cache lookups.", "result=\"hit\"");
+    static auto& cacheMisses = Metrics::counter("ocaw_exe_directory_cache_total",
+        "The number of the executable directory cache lookups.", "result=\"miss\"");
+
+    if (!cache)
+        return windowSystem.windowExeDirectory(window);
+
+    uint32_t processId = windowSystem.windowProcessId(window);
+    std::wstring directory;
+    if (cache->find(window, processId, directory))
+    {
+        cacheHits.increment();
+        return directory;
+    }
+
+    cacheMisses.increment();
+    directory = windowSystem.windowExeDirectory(window);
+    cache->insert(window, processId, directory);
+    return directory;
+}
+
+std::wstring resolveFocusedWindowDirectory(WindowSystem& windowSystem, ExeDirectoryCache* cache, std::wstring* exePath)
+{
+    static const wchar_t* EXPLORER_CLASS_NAME_1    = L"ExploreWClass";
+    static const wchar_t* EXPLORER_CLASS_NAME_2    = L"CabinetWClass";
+    static const wchar_t* DESKTOP_CLASS_NAME_1     = L"Progman";
+    static const wchar_t* DESKTOP_CLASS_NAME_2     = L"WorkerW";
+
+    static auto& resolveByExecutable = Metrics::counter("ocaw_resolve_total",
+        "The number of the directory resolved by each strategy.", "strategy=\"executable\"");
+    static auto& resolveByDesktop = Metrics::counter("ocaw_resolve_total",
+        "The number of the directory resolved by each strategy.", "strategy=\"desktop\"");
+    static auto& resolveByExplorer = Metrics::counter("ocaw_resolve_total",
+        "The number of the directory resolved by each strategy.", "strategy=\"explorer\"");
+
+    auto focusedWindow = windowSystem.foregroundWindow();
+    auto classname = windowSystem.windowClassName(focusedWindow);
+
+    if (exePath)
+    {
+        // 无权限打开的进程（如以管理员身份运行的）不影响目录的解析。
+        try
+        {
+            *exePath = windowSystem.windowExePath(focusedWindow);
+        } catch (std::exception&)
+        {
+            exePath->clear();
+        }
+    }
+
+    bool atExplorer = classname == EXPLORER_CLASS_NAME_1 || classname == EXPLORER_CLASS_NAME_2;
+    bool atDesktop = classname == DESKTOP_CLASS_NAME_1 || classname == DESKTOP_CLASS_NAME_2;
+
+    if (atDesktop)
+    {
+        resolveByDesktop.increment();
+        auto path = windowSystem.desktopDirectory();
+        trace::Recorder::recordResolve(focusedWindow, classname, trace::STRATEGY_DESKTOP, path);
+        return path;
+    }
+
+    if (atExplorer)
+    {
+        auto path = windowSystem.explorerDirectory(focusedWindow);
+        if (!path.empty())
+        {
+            resolveByExplorer.increment();
+            trace::Recorder::recordResolve(focusedWindow, classname, trace::STRATEGY_EXPLORER, path);
+            return path;
+        }
+    }
+
+    resolveByExecutable.increment();
+    auto path = cachedExeDirectory(windowSystem, focusedWindow, cache);
+    trace::Recorder::recordResolve(focusedWindow, classname, trace::STRATEGY_EXECUTABLE, path);
+    return path;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 解析焦点窗口所在目录所需的窗口系统操作。
+// 真实实现为core.h中的Win32WindowSystem，模拟中可使用伪造的实现（如脚本化的前台窗口切换与无响应窗口）。
+class WindowSystem
+{
+public:
+    using Window = uintptr_t;
+
+    virtual ~WindowSystem() = default;
+
+    // 以下操作失败时抛出std::runtime_error。
+    virtual Window foregroundWindow() = 0;
+    virtual std::wstring windowClassName(Window window) = 0;
+    virtual uint32_t windowProcessId(Window window) = 0;
+    // 窗口所属进程的可执行文件路径。
+    virtual std::wstring windowExePath(Window window) = 0;
+    // 窗口所属进程的可执行文件所在目录。
+    virtual std::wstring windowExeDirectory(Window window) = 0;
+    virtual std::wstring desktopDirectory() = 0;
+    // 资源管理器窗口当前浏览的目录。如果浏览的不是文件系统目录（如"此电脑"）则返回空字符串。
+    virtual std::wstring explorerDirectory(Window window) = 0;
+};
+
+// 窗口所属进程的可执行文件所在目录的缓存，避免每次打开进程并查询其模块路径。
+// 以窗口与进程ID为键，窗口句柄或进程ID被复用时不会命中旧的结果。容量满时淘汰最早插入的项。线程安全。
+class ExeDirectoryCache
+{
+public:
+    explicit ExeDirectoryCache(size_t capacity = 64) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    // 未命中时返回false。
+    bool find(WindowSystem::Window window, uint32_t processId, std::wstring& directory);
+    void insert(WindowSystem::Window window, uint32_t processId, const std::wstring& directory);
+    void clear();
+    size_t size() const;
+
+private:
+    struct Key
+    {
+        WindowSystem::Window window;
+        uint32_t processId;
+
+        bool operator==(const Key& other) const { return window == other.window && processId == other.processId; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return std::hash<uint64_t>()(static_cast<uint64_t>(key.window) * 0x9E3779B97F4A7C15ULL ^ key.processId);
+        }
+    };
+
+    size_t capacity_;
+    mutable std::mutex mtx_;
+    std::unordered_map<Key, std::wstring, KeyHash> entries_;
+    std::deque<Key> order_;
+};
+
+// 焦点窗口为资源管理器时返回其浏览的目录，为桌面时返回桌面目录，否则返回窗口所属进程的可执行文件所在目录。
+// cache不为空时，可执行文件所在目录从缓存中获取。
+// exePath不为空时同时获取焦点窗口所属进程的可执行文件路径（如参数模板的{exe}），失败时为空。
+std::wstring resolveFocusedWindowDirectory(WindowSystem& windowSystem, ExeDirectoryCache* cache = nullptr,
+                                           std::wstring* exePath = nullptr);
@@ -0,0 +1,51 @@
+#include "retranslator.h"
+
+#include <qset.h>
+#include <qwidget.h>
+
+#include "language.h"
+
+Retranslator& Retranslator::getInstance()
+{
+    static Retranslator instance;
+    return instance;
+}
+
+void Retranslator::add(QObject* owner, const char* tranId, const Setter& setter)
+{
+    auto& entries = getInstance().entries_;
+    if (!entries.contains(owner))
+        QObject::connect(owner, &QObject::destroyed, [owner]() { remove(owner); });
+    entries[owner].append({QByteArray(tranId), setter});
+    setter(QEASYTR(tranId));
+}
+
+void Retranslator::remove(QObject* owner)
+{
+    getInstance().entries_.remove(owner);
+}
+
+void Retranslator::retranslate()
+{
+    const auto& entries = getInstance().entries_;
+
+    // 更新期间暂停所涉及窗口的重绘，全部更新完毕后每个窗口只重绘一次。
+    QSet<QWidget*> windows;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it)
+    {
+        auto widget = qobject_cast<QWidget*>(it.key());
+        if (widget && widget->window()->updatesEnabled())
+            windows.insert(widget->window());
+    }
+    for (auto window : windows)
+        window->setUpdatesEnabled(false);
+
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it)
+    {
+        for (const auto& entry : it.value())
+            entry.setter(QEASYTR(entry.tranId.constData()));
+    }
+
+    for (auto window : windows)
+        window->setUpdatesEnabled(true);
+}
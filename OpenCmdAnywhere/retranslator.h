@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qstring.h>
+
+// Singleton
+// 可翻译组件在此注册其所需的（翻译ID，设置函数）对；切换语言时只批量更新这些属性，无需过滤应用程序的全部事件。
+// 仅可在GUI线程中使用。
+class Retranslator
+{
+public:
+    using Setter = std::function<void(const QString&)>;
+
+    static Retranslator& getInstance();
+
+    // 注册一个翻译ID及其设置函数，注册时立即以当前语言调用一次设置函数。owner被销毁时自动注销其所有条目。
+    static void add(QObject* owner, const char* tranId, const Setter& setter);
+
+    // 便捷重载，以obj作为owner。例如：Retranslator::add(ui.titleLbl, "Title", &QLabel::setText);
+    template <typename T, typename U>
+    static void add(T* obj, const char* tranId, void (U::*setter)(const QString&))
+    {
+        add(obj, tranId, [=](const QString& text) { (obj->*setter)(text); });
+    }
+
+    static void remove(QObject* owner);
+
+    // 以当前语言批量更新所有已注册的属性。
+    static void retranslate();
+
+private:
+    Retranslator() = default;
+    ~Retranslator() = default;
+    Retranslator(const Retranslator&) = delete;
+    Retranslator& operator=(const Retranslator&) = delete;
+
+    struct Entry
+    {
+        QByteArray tranId;
+        Setter setter;
+    };
+
+    QHash<QObject*, QList<Entry>> entries_;
+};
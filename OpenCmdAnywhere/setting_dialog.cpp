@@ -2,10 +2,9 @@
 
 #include <qheaderview.h>
 
-#include <easy_translate.hpp>
-
 #include "config.h"
 #include "hotkey_handler.h"
+#include "retranslator.h"
 #include "settings.h"
 #include "executable_item_dialog.h"
 
@@ -33,29 +32,7 @@ SettingDialog::SettingDialog(QWidget* parent) :
     connect(ui.removeExeBtn, &QPushButton::clicked, this, &SettingDialog::onRemoveExeBtnClicked);
 
     updateExecutablesTable();
-    updatetText();
-}
-
-void SettingDialog::updatetText()
-{
-    setWindowTitle(EASYTR("Setting"));
-    ui.parameterLbl->setText(EASYTR("Startup Parameter"));
-    ui.parameterEdit->setPlaceholderText(EASYTR("No Parameter"));
-    ui.runAsUserHotkeyLbl->setText(EASYTR("Run As User Hotkey"));
-    ui.runAsUserHotkeyEdit->setToolTip(EASYTR("Keying the 'ESC' to cancel and keying the 'Delete' to remove hotkey"));
-    ui.runAsAdminHotkeyLbl->setText(EASYTR("Run As Admin Hotkey"));
-    ui.runAsAdminHotkeyEdit->setToolTip(EASYTR("Keying the 'ESC' to cancel and keying the 'Delete' to remove hotkey"));
-    ui.addExeBtn->setText(EASYTR("Add Executable"));
-    ui.editExeBtn->setText(EASYTR("Edit Executable"));
-    ui.removeExeBtn->setText(EASYTR("Remove Executable"));
-    ui.executableTable->setHorizontalHeaderLabels({EASYTR("Display Name"), EASYTR("Executable Filename")});
-}
-
-void SettingDialog::changeEvent(QEvent* event)
-{
-    if (event->type() == QEvent::LanguageChange)
-        updatetText();
-    QDialog::changeEvent(event);
+    setupText_();
 }
 
 void SettingDialog::updateExecutablesTable()
@@ -139,6 +116,27 @@ void SettingDialog::onRemoveExeBtnClicked()
     emit executablesChanged();
 }
 
+void SettingDialog::setupText_()
+{
+    Retranslator::add(this, "Setting", &SettingDialog::setWindowTitle);
+    Retranslator::add(ui.parameterLbl, "Startup Parameter", &QLabel::setText);
+    Retranslator::add(ui.parameterEdit, "No Parameter", &QTextEdit::setPlaceholderText);
+    Retranslator::add(ui.runAsUserHotkeyLbl, "Run As User Hotkey", &QLabel::setText);
+    Retranslator::add(ui.runAsUserHotkeyEdit,
+        "Keying the 'ESC' to cancel and keying the 'Delete' to remove hotkey", &QWidget::setToolTip);
+    Retranslator::add(ui.runAsAdminHotkeyLbl, "Run As Admin Hotkey", &QLabel::setText);
+    Retranslator::add(ui.runAsAdminHotkeyEdit,
+        "Keying the 'ESC' to cancel and keying the 'Delete' to remove hotkey", &QWidget::setToolTip);
+    Retranslator::add(ui.addExeBtn, "Add Executable", &QPushButton::setText);
+    Retranslator::add(ui.editExeBtn, "Edit Executable", &QPushButton::setText);
+    Retranslator::add(ui.removeExeBtn, "Remove Executable", &QPushButton::setText);
+    ui.executableTable->setHorizontalHeaderLabels({"", ""});
+    Retranslator::add(this, "Display Name", [=](const QString& text)
+    { ui.executableTable->horizontalHeaderItem(0)->setText(text); });
+    Retranslator::add(this, "Executable Filename", [=](const QString& text)
+    { ui.executableTable->horizontalHeaderItem(1)->setText(text); });
+}
+
 int SettingDialog::getSelectedRow_()
 {
     auto items = ui.executableTable->selectedItems();
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <qdialog.h>
-#include <qevent.h>
 
 #include "ui_setting_dialog.h"
 
@@ -16,9 +15,6 @@ signals:
     void executablesChanged();
 
 protected:
-    virtual void updatetText();
-    void changeEvent(QEvent* event) override;
-
     void updateExecutablesTable();
 
     void onParameterTextChanged();
@@ -28,6 +24,8 @@ protected:
     void onRemoveExeBtnClicked();
 
 private:
+    void setupText_();
+
     // 获取当前选中的行索引，若未选中行则返回-1；
     int getSelectedRow_();
 
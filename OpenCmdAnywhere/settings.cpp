@@ -1,12 +1,12 @@
 #include "settings.h"
 
-#include <qapplication.h>
+#include <qcoreapplication.h>
 #include <qlocale.h>
 
 #include "config.h"
 
 Settings::Settings()
-    : sm_(QApplication::organizationName(), QApplication::applicationName())
+    : sm_(QCoreApplication::organizationName(), QCoreApplication::applicationName())
 {
     executables_ = sm_.readSetting(
         "Executables",
@@ -45,6 +45,49 @@ QString Settings::getParameter()
     return getInstance().sm_.readSetting("Parameter", "").toString();
 }
 
+std::shared_ptr<const ParameterTemplate> Settings::getParameterTemplate()
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.parameterTemplateMtx_);
+    if (!instance.parameterTemplate_)
+        instance.parameterTemplate_ = std::make_shared<const ParameterTemplate>(getParameter().toStdWString());
+    return instance.parameterTemplate_;
+}
+
+QVariantList Settings::getLaunchProfileRules()
+{
+    return getInstance().sm_.readSetting("LaunchProfiles", QVariantList()).toList();
+}
+
+// 按规则与可执行文件构建启动配置。
+static std::shared_ptr<const LaunchProfiles> buildLaunchProfiles()
+{
+    const auto& executables = Settings::getAllExecutables();
+    std::vector<LaunchProfile> profiles;
+    for (const auto& rule : Settings::getLaunchProfileRules())
+    {
+        const auto& map = rule.toMap();
+        QString displayName = map.value("Executable").toString();
+        if (!executables.contains(displayName))
+            continue;
+        profiles.push_back({
+            map.value("Directory").toString().toStdWString(),
+            executables[displayName].toString().toStdWString(),
+            std::make_shared<const ParameterTemplate>(map.value("Parameter").toString().toStdWString())
+        });
+    }
+    return std::make_shared<const LaunchProfiles>(std::move(profiles));
+}
+
+std::shared_ptr<const LaunchProfiles> Settings::getLaunchProfiles()
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.launchProfilesMtx_);
+    if (!instance.launchProfiles_)
+        instance.launchProfiles_ = buildLaunchProfiles();
+    return instance.launchProfiles_;
+}
+
 gbhk::KeyCombination Settings::getKeyCombination(bool isAdmin)
 {
     if (isAdmin)
@@ -66,6 +109,41 @@ bool Settings::getIsRunOnStartup()
     return getInstance().sm_.readSetting("RunOnStartup", false).toBool();
 }
 
+QString Settings::getMetricsFile()
+{
+    return getInstance().sm_.readSetting("MetricsFile", "").toString();
+}
+
+int Settings::getMetricsInterval()
+{
+    return getInstance().sm_.readSetting("MetricsInterval", 15).toInt();
+}
+
+QString Settings::getTraceFile()
+{
+    return getInstance().sm_.readSetting("TraceFile", "").toString();
+}
+
+bool Settings::getIsDirectLaunch()
+{
+    return getInstance().sm_.readSetting("DirectLaunch", true).toBool();
+}
+
+int Settings::getStandbyPoolSize()
+{
+    return getInstance().sm_.readSetting("StandbyPoolSize", 0).toInt();
+}
+
+int Settings::getStandbyIdleExpiry()
+{
+    return getInstance().sm_.readSetting("StandbyIdleExpiry", 600).toInt();
+}
+
+int Settings::getStandbyMemoryLimit()
+{
+    return getInstance().sm_.readSetting("StandbyMemoryLimit", 128).toInt();
+}
+
 void Settings::setLanguage(const QString& value)
 {
     getInstance().sm_.writeSetting("Language", value);
@@ -82,6 +160,23 @@ void Settings::setParameter(const QString& value)
         getInstance().sm_.removeSetting("Parameter");
     else
         getInstance().sm_.writeSetting("Parameter", value);
+
+    auto parameterTemplate = std::make_shared<const ParameterTemplate>(value.toStdWString());
+    std::lock_guard<std::mutex> lock(getInstance().parameterTemplateMtx_);
+    getInstance().parameterTemplate_ = std::move(parameterTemplate);
+}
+
+void Settings::setLaunchProfileRules(const QVariantList& value)
+{
+    if (value.isEmpty())
+        getInstance().sm_.removeSetting("LaunchProfiles");
+    else
+        getInstance().sm_.writeSetting("LaunchProfiles", value);
+
+    // 在设置改变时构建，热键触发时只需匹配。
+    auto profiles = buildLaunchProfiles();
+    std::lock_guard<std::mutex> lock(getInstance().launchProfilesMtx_);
+    getInstance().launchProfiles_ = std::move(profiles);
 }
 
 void Settings::setKeyCombination(const gbhk::KeyCombination& value, bool isAdmin)
@@ -108,12 +203,21 @@ void Settings::addExecutable(const QString& displayName, const QString& filename
 {
     getInstance().executables_[displayName] = filename;
     getInstance().sm_.writeSetting("Executables", getInstance().executables_);
+    // 启动配置按显示名称引用可执行文件，需重新构建。
+    auto profiles = buildLaunchProfiles();
+    std::lock_guard<std::mutex> lock(getInstance().launchProfilesMtx_);
+    getInstance().launchProfiles_ = std::move(profiles);
 }
 
 void Settings::removeExecutable(const QString& displayName)
 {
     getInstance().executables_.remove(displayName);
     getInstance().sm_.writeSetting("Executables", getInstance().executables_);
+    {
+        auto profiles = buildLaunchProfiles();
+        std::lock_guard<std::mutex> lock(getInstance().launchProfilesMtx_);
+        getInstance().launchProfiles_ = std::move(profiles);
+    }
     // 如果删除的是当前Executable，则尝试回退当前Executable
     if (getCurrentExecutable().first == displayName)
     {
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include <qmap.h>
 #include <qstring.h>
 
 #include <global_hotkey/key_combination.hpp>
 
+#include "launch_profile.h"
+#include "parameter_template.h"
 #include "settings_manager.h"
 
 // Singleton, hungry run
@@ -18,12 +23,36 @@ public:
     static std::pair<QString, QString> getCurrentExecutable();
     // The return value may be empty.
     static QString getParameter();
+    // The compiled template of the parameter, compiled once when the parameter is read first or changed.
+    static std::shared_ptr<const ParameterTemplate> getParameterTemplate();
+    // The rules of the launch profiles chosen by the directory prefix, each rule is a map of the
+    // "Directory", the "Executable" (display name of the executables) and the "Parameter".
+    static QVariantList getLaunchProfileRules();
+    // The launch profiles built from the rules, built when read first and rebuilt when the rules or the executables
+    // are changed, so the hotkey only matches the directory.
+    // The rules with an empty directory or an unknown executable are ignored.
+    static std::shared_ptr<const LaunchProfiles> getLaunchProfiles();
     static gbhk::KeyCombination getKeyCombination(bool isAdmin);
     static bool getIsRunOnStartup();
+    // The path of the Prometheus text file of the metrics, empty means not export.
+    static QString getMetricsFile();
+    // The export interval of the metrics file (second).
+    static int getMetricsInterval();
+    // The path of the focus and hotkey trace file, empty means not record.
+    static QString getTraceFile();
+    // Create the process directly instead of the ShellExecuteExW for the non-admin launch.
+    static bool getIsDirectLaunch();
+    // The number of the hidden standby instances of the current executable, 0 means disabled.
+    static int getStandbyPoolSize();
+    // The standby instance older than it is replaced (second).
+    static int getStandbyIdleExpiry();
+    // The memory limit of all standby instances (MB), 0 means unlimited.
+    static int getStandbyMemoryLimit();
 
     static void setLanguage(const QString& value);
     static void setCurrentExecutable(const QString& value);
     static void setParameter(const QString& value);
+    static void setLaunchProfileRules(const QVariantList& value);
     static void setKeyCombination(const gbhk::KeyCombination& value, bool isAdmin);
     static void setIsRunOnStartup(bool value);
 
@@ -40,4 +69,9 @@ private:
 
     SettingsManager sm_;
     QVariantMap executables_;
+    // Read by the hotkey worker threads.
+    std::mutex parameterTemplateMtx_;
+    std::shared_ptr<const ParameterTemplate> parameterTemplate_;
+    std::mutex launchProfilesMtx_;
+    std::shared_ptr<const LaunchProfiles> launchProfiles_;
 };
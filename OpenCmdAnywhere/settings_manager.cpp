@@ -1,5 +1,14 @@
 #include "settings_manager.h"
 
+#include "metrics.h"
+
+// 每次写入设置后都会同步到注册表。
+static Counter& settingsFlushes()
+{
+    static auto& counter = Metrics::counter("ocaw_settings_flushes_total", "The number of the settings synchronized to the storage.");
+    return counter;
+}
+
 SettingsManager::SettingsManager(const QString& organization, const QString& application, QObject* parent) :
     QObject(parent)
 {
@@ -16,6 +25,7 @@ void SettingsManager::writeSetting(const QString& key, const QVariant& value)
 {
     settings_->setValue(key, value);
     settings_->sync();
+    settingsFlushes().increment();
 }
 
 void SettingsManager::writeSettings(const QVariantMap& settings)
@@ -27,6 +37,7 @@ void SettingsManager::writeSettings(const QVariantMap& settings)
         settings_->setValue(it.key(), it.value());
     }
     settings_->sync();
+    settingsFlushes().increment();
 }
 
 QVariant SettingsManager::readSetting(const QString& key, const QVariant& defaultValue)
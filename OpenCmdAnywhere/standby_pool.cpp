@@ -0,0 +1,455 @@
+#include "standby_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <filesystem>
+
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cerrno>
+#include <fstream>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "trace_recorder.h"
+
+extern char** environ;
+#endif
+
+#include "launcher.h"
+#include "metrics.h"
+
+#ifdef _WIN32
+
+// 以隐藏的控制台窗口启动的命令行程序，激活时通过AttachConsole()向其控制台输入切换目录的命令。
+// 仅支持由控制台主机（conhost）显示的控制台，默认终端为Windows Terminal时窗口无法显示。
+class ConsoleStandbyInstance : public StandbyInstance
+{
+public:
+    ConsoleStandbyInstance(const std::wstring& executable, const std::wstring& parameter, bool isPowerShell) :
+        isPowerShell_(isPowerShell)
+    {
+        CreateProcessLauncher launcher(true);
+        ProcessLauncher::Process process;
+        if (!launcher.launch(executable, L"", parameter, false, &process))
+            throw std::runtime_error("Failed to CreateProcessW()");
+        process_ = reinterpret_cast<HANDLE>(process);
+    }
+
+    ~ConsoleStandbyInstance() override
+    {
+        if (!activated_)
+            TerminateProcess(process_, 0);
+        CloseHandle(process_);
+    }
+
+    bool isAlive() override { return WaitForSingleObject(process_, 0) == WAIT_TIMEOUT; }
+
+    uint64_t memoryUsage() override
+    {
+        PROCESS_MEMORY_COUNTERS pmc = {0};
+        if (!GetProcessMemoryInfo(process_, &pmc, sizeof(pmc)))
+            return 0;
+        return pmc.WorkingSetSize;
+    }
+
+    bool activate(const std::wstring& directory) override
+    {
+        std::wstring command;
+        if (isPowerShell_)
+        {
+            std::wstring quoted;
+            for (wchar_t ch : directory)
+                quoted += ch == L'\'' ? std::wstring(L"''") : std::wstring(1, ch);
+            command = L"Set-Location -LiteralPath '" + quoted + L"'; Clear-Host";
+        }
+        else
+        {
+            // 交互式的cmd.exe在引号内同样展开%NAME%，且无法转义，此时失败以回退到正常启动。
+            if (directory.find(L'%') != std::wstring::npos)
+                return false;
+            command = L"cd /d \"" + directory + L"\" & cls";
+        }
+
+        std::vector<INPUT_RECORD> records;
+        for (wchar_t ch : command + L"\r")
+        {
+            INPUT_RECORD record = {0};
+            record.EventType = KEY_EVENT;
+            record.Event.KeyEvent.bKeyDown = TRUE;
+            record.Event.KeyEvent.wRepeatCount = 1;
+            record.Event.KeyEvent.wVirtualKeyCode = ch == L'\r' ? VK_RETURN : 0;
+            record.Event.KeyEvent.uChar.UnicodeChar = ch;
+            records.push_back(record);
+            record.Event.KeyEvent.bKeyDown = FALSE;
+            records.push_back(record);
+        }
+
+        // 一个进程同时只能连接一个控制台。
+        static std::mutex consoleMtx;
+        std::lock_guard<std::mutex> lock(consoleMtx);
+        FreeConsole();
+        if (!AttachConsole(GetProcessId(process_)))
+            return false;
+
+        bool ok = false;
+        HWND window = GetConsoleWindow();
+        HANDLE input = CreateFileW(L"CONIN$", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_EXISTING, 0, nullptr);
+        if (input != INVALID_HANDLE_VALUE)
+        {
+            DWORD written = 0;
+            ok = WriteConsoleInputW(input, records.data(), static_cast<DWORD>(records.size()), &written)
+                && written == records.size();
+            CloseHandle(input);
+        }
+        FreeConsole();
+        if (!ok || window == nullptr)
+            return false;
+
+        activated_ = true;
+        ShowWindow(window, SW_SHOW);
+        SetForegroundWindow(window);
+        return true;
+    }
+
+private:
+    bool isPowerShell_;
+    HANDLE process_ = nullptr;
+    bool activated_ = false;
+};
+
+std::unique_ptr<StandbyInstance> createStandbyInstance(const std::wstring& executable, const std::wstring& parameter)
+{
+    auto filename = std::filesystem::path(executable).filename().wstring();
+    bool isCmd = _wcsicmp(filename.c_str(), L"cmd.exe") == 0;
+    bool isPowerShell = _wcsicmp(filename.c_str(), L"powershell.exe") == 0 || _wcsicmp(filename.c_str(), L"pwsh.exe") == 0;
+    if (!isCmd && !isPowerShell)
+        return nullptr;
+    return std::make_unique<ConsoleStandbyInstance>(executable, parameter, isPowerShell);
+}
+
+#else
+
+// 启动的程序从标准输入（socket）读取一行目录并切换，相当于Windows上由命令行程序执行切换目录的命令。
+class PipeStandbyInstance : public StandbyInstance
+{
+public:
+    PipeStandbyInstance(const std::wstring& executable, const std::wstring& parameter)
+    {
+        int fds[2];
+        // 使用socket而不是管道，以在子进程退出后写入时不产生SIGPIPE（MSG_NOSIGNAL）。
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+            throw std::runtime_error("Failed to socketpair()");
+
+        auto exe = trace::toUtf8(executable);
+        auto args = SpawnLauncher::splitParameter(trace::toUtf8(parameter));
+        std::vector<char*> argv;
+        argv.push_back(exe.data());
+        for (auto& arg : args)
+            argv.push_back(arg.data());
+        argv.push_back(nullptr);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDIN_FILENO);
+        int rc = posix_spawnp(&pid_, exe.c_str(), &actions, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fds[1]);
+        if (rc != 0)
+        {
+            close(fds[0]);
+            throw std::runtime_error("Failed to posix_spawnp()");
+        }
+        input_ = fds[0];
+    }
+
+    ~PipeStandbyInstance() override
+    {
+        if (input_ >= 0)
+            close(input_);
+        if (!exited_ && !activated_)
+        {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, nullptr, 0);
+        }
+    }
+
+    bool isAlive() override
+    {
+        if (!exited_ && waitpid(pid_, nullptr, WNOHANG) != 0)
+            exited_ = true;
+        return !exited_;
+    }
+
+    uint64_t memoryUsage() override
+    {
+        std::ifstream ifs("/proc/" + std::to_string(pid_) + "/statm");
+        uint64_t size = 0, resident = 0;
+        if (!(ifs >> size >> resident))
+            return 0;
+        return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    bool activate(const std::wstring& directory) override
+    {
+        auto line = trace::toUtf8(directory) + "\n";
+        size_t offset = 0;
+        while (offset < line.size())
+        {
+            ssize_t n = send(input_, line.data() + offset, line.size() - offset, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            offset += static_cast<size_t>(n);
+        }
+        close(input_);
+        input_ = -1;
+        activated_ = true;
+        return true;
+    }
+
+private:
+    pid_t pid_ = -1;
+    int input_ = -1;
+    bool exited_ = false;
+    bool activated_ = false;
+};
+
+std::unique_ptr<StandbyInstance> createStandbyInstance(const std::wstring& executable, const std::wstring& parameter)
+{
+    return std::make_unique<PipeStandbyInstance>(executable, parameter);
+}
+
+#endif
+
+StandbyPool::StandbyPool(Factory factory) :
+    factory_(std::move(factory)),
+    thread_(&StandbyPool::run_, this)
+{}
+
+StandbyPool::~StandbyPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void StandbyPool::setOptions(const Options& options)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    options_ = options;
+    resetLocked_();
+    cv_.notify_all();
+}
+
+void StandbyPool::setExecutable(const std::wstring& executable, const std::wstring& parameter)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (executable == executable_ && parameter == parameter_)
+        return;
+    executable_ = executable;
+    parameter_ = parameter;
+    resetLocked_();
+    cv_.notify_all();
+}
+
+bool StandbyPool::acquire(const std::wstring& executable, const std::wstring& parameter, const std::wstring& directory)
+{
+    static auto& hits = Metrics::counter("ocaw_standby_acquire_total",
+        "The number of the launches by the standby instances.", "result=\"hit\"");
+    static auto& misses = Metrics::counter("ocaw_standby_acquire_total",
+        "The number of the launches by the standby instances.", "result=\"miss\"");
+
+    std::unique_ptr<StandbyInstance> instance;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (options_.size == 0)
+            return false;
+        if (executable != executable_ || parameter != parameter_)
+        {
+            executable_ = executable;
+            parameter_ = parameter;
+            resetLocked_();
+        }
+
+        // 最早启动的实例最先被使用，其余实例的待命时间更短。
+        while (!ready_.empty() && !instance)
+        {
+            instance = std::move(ready_.front().instance);
+            ready_.pop_front();
+            if (!instance->isAlive())
+            {
+                ++stats_.died;
+                instance.reset();
+            }
+        }
+        replenishAfter_ = Clock::now() + REPLENISH_DELAY;
+        cv_.notify_all();
+    }
+
+    bool ok = instance && instance->activate(directory);
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (ok)
+    {
+        ++stats_.hits;
+        hits.increment();
+        activated_.push_back(std::move(instance));
+    }
+    else
+    {
+        ++stats_.misses;
+        misses.increment();
+    }
+    return ok;
+}
+
+bool StandbyPool::waitReady(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    return readyCv_.wait_for(lock, timeout, [this]()
+        {
+            return ready_.size() >= targetSize_();
+        });
+}
+
+StandbyPool::Stats StandbyPool::stats() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    Stats stats = stats_;
+    stats.ready = ready_.size();
+    return stats;
+}
+
+void StandbyPool::run_()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    auto nextCheck = Clock::now();
+    while (!stopping_)
+    {
+        auto now = Clock::now();
+        bool expired = !ready_.empty() && now - ready_.front().since >= options_.idleExpiry;
+        if (now >= nextCheck || expired)
+        {
+            checkLocked_(now);
+            nextCheck = now + CHECK_INTERVAL;
+        }
+
+        if (ready_.size() < targetSize_() && now >= replenishAfter_)
+        {
+            // 启动较慢，不持有锁，期间改变的设置由generation_判断。
+            auto generation = generation_;
+            auto executable = executable_;
+            auto parameter = parameter_;
+            lock.unlock();
+            std::unique_ptr<StandbyInstance> instance;
+            bool supported = true;
+            try
+            {
+                instance = factory_(executable, parameter);
+                supported = instance != nullptr;
+            } catch (std::exception&)
+            {
+            }
+            lock.lock();
+
+            if (generation != generation_)
+                continue;
+            if (!supported)
+            {
+                supported_ = false;
+                readyCv_.notify_all();
+                continue;
+            }
+            if (!instance)
+            {
+                ++spawnFailures_;
+                readyCv_.notify_all();
+                continue;
+            }
+
+            spawnFailures_ = 0;
+            ++stats_.spawned;
+            ready_.push_back({ std::move(instance), Clock::now() });
+            // 新实例的内存需在启动完成后才稳定，此处只排除已超出上限的情况。
+            checkLocked_(Clock::now());
+            readyCv_.notify_all();
+            continue;
+        }
+
+        // 等待到下一次检查、最早的实例过期或可以补充实例。
+        auto wakeUp = nextCheck;
+        if (!ready_.empty())
+            wakeUp = std::min(wakeUp, ready_.front().since + options_.idleExpiry);
+        if (ready_.size() < targetSize_())
+            wakeUp = std::min(wakeUp, replenishAfter_);
+        cv_.wait_until(lock, wakeUp);
+    }
+
+    ready_.clear();
+    activated_.clear();
+}
+
+size_t StandbyPool::targetSize_() const
+{
+    if (!supported_ || spawnFailures_ >= MAX_SPAWN_FAILURES || executable_.empty())
+        return 0;
+    return std::min(options_.size, memoryCap_);
+}
+
+void StandbyPool::resetLocked_()
+{
+    ++generation_;
+    supported_ = true;
+    spawnFailures_ = 0;
+    memoryCap_ = SIZE_MAX;
+    ready_.clear();
+    stats_.memory = 0;
+}
+
+void StandbyPool::checkLocked_(Clock::time_point now)
+{
+    // 替换过期的实例。
+    while (!ready_.empty() && now - ready_.front().since >= options_.idleExpiry)
+    {
+        ++stats_.expired;
+        ready_.pop_front();
+    }
+
+    uint64_t memory = 0;
+    for (auto it = ready_.begin(); it != ready_.end();)
+    {
+        if (!it->instance->isAlive())
+        {
+            ++stats_.died;
+            it = ready_.erase(it);
+            continue;
+        }
+        memory += it->instance->memoryUsage();
+        ++it;
+    }
+
+    // 超出内存上限时终止最新的实例，并不再补充到原来的数量。
+    while (options_.memoryLimit > 0 && memory > options_.memoryLimit && !ready_.empty())
+    {
+        memory -= std::min(memory, ready_.back().instance->memoryUsage());
+        ready_.pop_back();
+        ++stats_.overBudget;
+        memoryCap_ = ready_.size();
+    }
+    stats_.memory = memory;
+
+    activated_.erase(std::remove_if(activated_.begin(), activated_.end(),
+        [](const std::unique_ptr<StandbyInstance>& instance) { return !instance->isAlive(); }), activated_.end());
+}
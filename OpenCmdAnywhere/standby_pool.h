@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 预先启动并隐藏（或等待）的可执行文件实例，激活时切换到指定目录并显示。
+class StandbyInstance
+{
+public:
+    // 未激活的实例在析构时被终止。
+    virtual ~StandbyInstance() = default;
+
+    virtual bool isAlive() = 0;
+    // 占用的内存（字节），未知时返回0。
+    virtual uint64_t memoryUsage() = 0;
+    // 切换到directory并显示，之后进程交由用户，析构时不再终止。失败时返回false。
+    virtual bool activate(const std::wstring& directory) = 0;
+};
+
+// 当前平台的待命实例：
+//   Windows上以隐藏的控制台窗口启动cmd.exe、powershell.exe或pwsh.exe，激活时向其控制台输入切换目录的命令并显示窗口；
+//   其它平台上启动的程序需从标准输入读取一行目录并切换（用于在Linux上以简单的子程序测试）。
+// 不支持的可执行文件返回空指针，启动失败时抛出std::runtime_error。
+std::unique_ptr<StandbyInstance> createStandbyInstance(const std::wstring& executable, const std::wstring& parameter);
+
+// 可选开启的待命实例池，热键触发时直接激活一个待命实例，并在后台线程中补充新的实例。
+// 仅用于以用户身份运行，以管理员身份运行每次都需要确认。线程安全。
+class StandbyPool
+{
+public:
+    struct Options
+    {
+        // 为0时关闭，终止所有待命实例。
+        size_t size = 0;
+        // 待命超过此时间的实例被替换，避免其环境（如环境变量）过旧。
+        std::chrono::milliseconds idleExpiry{std::chrono::minutes(10)};
+        // 所有待命实例占用内存的上限（字节），超出时减少实例数量，为0时不限制。
+        uint64_t memoryLimit = 0;
+    };
+
+    struct Stats
+    {
+        uint64_t hits       = 0;
+        // 没有可用的实例或激活失败。
+        uint64_t misses     = 0;
+        uint64_t spawned    = 0;
+        uint64_t expired    = 0;
+        // 待命期间意外退出的实例。
+        uint64_t died       = 0;
+        // 因超出内存上限被终止的实例。
+        uint64_t overBudget = 0;
+        size_t ready        = 0;
+        uint64_t memory     = 0;
+    };
+
+    // 参数依次为可执行文件与参数，不支持时返回空指针。
+    using Factory = std::function<std::unique_ptr<StandbyInstance>(const std::wstring&, const std::wstring&)>;
+
+    explicit StandbyPool(Factory factory = createStandbyInstance);
+    // 终止所有待命实例。
+    ~StandbyPool();
+    StandbyPool(const StandbyPool&) = delete;
+    StandbyPool& operator=(const StandbyPool&) = delete;
+
+    void setOptions(const Options& options);
+    // 设置待命实例的可执行文件与参数，与当前不同时终止已有的实例。
+    void setExecutable(const std::wstring& executable, const std::wstring& parameter);
+
+    // 以待命实例在directory中打开，没有可用的实例时返回false，调用者应正常启动。
+    // 可执行文件或参数与待命实例不同时，以新的可执行文件与参数重新启动待命实例并返回false。
+    bool acquire(const std::wstring& executable, const std::wstring& parameter, const std::wstring& directory);
+
+    // 阻塞直到待命实例的数量达到目标（可能因内存上限小于设置），超时返回false。
+    bool waitReady(std::chrono::milliseconds timeout);
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Ready
+    {
+        std::unique_ptr<StandbyInstance> instance;
+        Clock::time_point since;
+    };
+
+    // 连续启动失败达到此次数时停止补充，直到可执行文件或设置改变。
+    static constexpr int MAX_SPAWN_FAILURES = 3;
+    // 检查实例是否退出与占用内存的间隔。
+    static constexpr std::chrono::seconds CHECK_INTERVAL{1};
+    // 激活实例后延迟补充，避免新实例的启动与被激活的实例争用CPU。
+    static constexpr std::chrono::milliseconds REPLENISH_DELAY{200};
+
+    void run_();
+    // 以下函数需在持有mtx_时调用。
+    size_t targetSize_() const;
+    void resetLocked_();
+    void checkLocked_(Clock::time_point now);
+
+    Factory factory_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::condition_variable readyCv_;
+    Options options_;
+    std::wstring executable_;
+    std::wstring parameter_;
+    // 每次改变可执行文件或设置时递增，丢弃以旧设置启动的实例。
+    uint64_t generation_ = 0;
+    bool supported_ = true;
+    int spawnFailures_ = 0;
+    // 因内存上限而减少后的实例数量上限。
+    size_t memoryCap_ = SIZE_MAX;
+    std::deque<Ready> ready_;
+    Clock::time_point replenishAfter_;
+    // 已激活的实例，保留到其退出（POSIX上需回收子进程）。
+    std::vector<std::unique_ptr<StandbyInstance>> activated_;
+    Stats stats_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
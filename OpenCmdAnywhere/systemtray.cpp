@@ -1,12 +1,20 @@
 #include "systemtray.h"
 
 #include <qapplication.h>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfiledialog.h>
+#include <qfontdatabase.h>
+#include <qmessagebox.h>
 
 #include <easy_translate.hpp>
 #include <minilog.hpp>
 
 #include "config.h"
 #include "language.h"
+#include "latency.h"
+#include "metrics.h"
+#include "retranslator.h"
 #include "settings.h"
 #include "utility.h"
 
@@ -36,6 +44,9 @@ SystemTray::SystemTray(QObject* parent) :
     setting_ = new QAction(menu_);
     menu_->addAction(setting_);
 
+    diagnostics_ = new QAction(menu_);
+    menu_->addAction(diagnostics_);
+
     about_ = new QAction(menu_);
     menu_->addAction(about_);
     menu_->addSeparator();
@@ -46,10 +57,11 @@ SystemTray::SystemTray(QObject* parent) :
     connect(this, &QSystemTrayIcon::activated, this, &SystemTray::onActivated);
     connect(runOnStartup_, &QAction::triggered, this, &SystemTray::onRunOnStartupTriggered);
     connect(setting_, &QAction::triggered, this, &SystemTray::onSettingTriggered);
+    connect(diagnostics_, &QAction::triggered, this, &SystemTray::onDiagnosticsTriggered);
     connect(about_, &QAction::triggered, this, &SystemTray::onAboutTriggered);
     connect(exitApp_, &QAction::triggered, this, &SystemTray::onExitAppTriggered);
 
-    updateText();
+    setupText_();
 }
 
 SystemTray::~SystemTray()
@@ -58,27 +70,6 @@ SystemTray::~SystemTray()
     menu_ = nullptr;
 }
 
-void SystemTray::updateText()
-{
-    setToolTip(EASYTR(APP_TITLE));
-    languageMenu_->setTitle(EASYTR("Language"));
-    executableMenu_->setTitle(EASYTR("Run With"));
-    for (int i = 0; i < languageMenu_->actions().size(); ++i)
-        languageMenu_->actions()[i]->setText(EASYTR(easytr::languages().getIds()[i]));
-    runOnStartup_->setText(EASYTR("Run on Startup"));
-    setting_->setText(EASYTR("Setting"));
-    about_->setText(EASYTR("About"));
-    exitApp_->setText(EASYTR("Exit"));
-}
-
-bool SystemTray::eventFilter(QObject* obj, QEvent* event)
-{
-    Q_UNUSED(obj);
-    if (event->type() == QEvent::LanguageChange)
-        updateText();
-    return QSystemTrayIcon::eventFilter(obj, event);
-}
-
 void SystemTray::onActivated(ActivationReason reason)
 {
     switch (reason)
@@ -106,6 +97,47 @@ void SystemTray::onSettingTriggered()
     dlg.exec();
 }
 
+void SystemTray::onDiagnosticsTriggered()
+{
+    QMessageBox msgBox(
+        QMessageBox::Information,
+        QEASYTR("Diagnostics"),
+        QString::fromStdString(LatencyStats::report()),
+        QMessageBox::NoButton
+    );
+    // 使用等宽字体以对齐各列。
+    msgBox.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    auto saveBtn = msgBox.addButton(QEASYTR("Save Metrics"), QMessageBox::ActionRole);
+    msgBox.addButton(QEASYTR("Confirm"), QMessageBox::AcceptRole);
+    msgBox.exec();
+    if (msgBox.clickedButton() != saveBtn)
+        return;
+
+    QString filename = QFileDialog::getSaveFileName(
+        nullptr,
+        QEASYTR("Save Metrics"),
+        QDir::home().absoluteFilePath("ocaw_latency.prom"),
+        QEASYTR("Metrics File") + " (*.prom *.txt)"
+    );
+    if (filename.isEmpty())
+        return;
+
+    // 以二进制模式写出，Prometheus文本格式要求使用LF换行。
+    QFile file(filename);
+    QByteArray metrics = QByteArray::fromStdString(LatencyStats::metrics());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(metrics) != metrics.size())
+    {
+        mlog::warning("Failed to save the metrics file: {}", filename.toStdString());
+        QMessageBox warnBox(
+            QMessageBox::Warning,
+            QEASYTR("Warning"),
+            QEASYTR("Failed to save the metrics file"),
+            QMessageBox::NoButton
+        );
+        warnBox.exec();
+    }
+}
+
 void SystemTray::onAboutTriggered()
 {
     AboutDialog dlg = AboutDialog();
@@ -161,6 +193,18 @@ void SystemTray::updateExecutableMenu()
     }
 }
 
+void SystemTray::setupText_()
+{
+    Retranslator::add(this, APP_TITLE, &SystemTray::setToolTip);
+    Retranslator::add(languageMenu_, "Language", &QMenu::setTitle);
+    Retranslator::add(executableMenu_, "Run With", &QMenu::setTitle);
+    Retranslator::add(runOnStartup_, "Run on Startup", &QAction::setText);
+    Retranslator::add(setting_, "Setting", &QAction::setText);
+    Retranslator::add(diagnostics_, "Diagnostics", &QAction::setText);
+    Retranslator::add(about_, "About", &QAction::setText);
+    Retranslator::add(exitApp_, "Exit", &QAction::setText);
+}
+
 void SystemTray::setupLanguageMenu_()
 {
     languageMenu_ = new QMenu(menu_);
@@ -179,6 +223,7 @@ void SystemTray::setupLanguageMenu_()
             action->setChecked(true);
         languageGroup->addAction(action);
         languageMenu_->addAction(action);
+        Retranslator::add(action, id.c_str(), &QAction::setText);
 
         connect(action, &QAction::triggered, this, [=]()
         {
@@ -196,6 +241,10 @@ void SystemTray::setupExecutableMenu_()
 
 void SystemTray::setExecutableMenuIcon_(const QString& exePath)
 {
+    static auto& threadsSpawned = Metrics::counter("ocaw_threads_spawned_total",
+        "The number of the detached worker threads spawned.", "site=\"icon\"");
+
+    threadsSpawned.increment();
     std::thread th([=]()
     {
         QIcon icon = getExecutableIcon(exePath);
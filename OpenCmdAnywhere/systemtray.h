@@ -2,7 +2,6 @@
 
 #include <qaction.h>
 #include <qactiongroup.h>
-#include <qevent.h>
 #include <qmenu.h>
 #include <qsystemtrayicon.h>
 
@@ -14,20 +13,18 @@ public:
     explicit SystemTray(QObject* parent = nullptr);
     ~SystemTray();
 
-protected:
-    virtual void updateText();
-    bool eventFilter(QObject* obj, QEvent* event) override;
-
 protected:
     void onActivated(ActivationReason reason);
     void onRunOnStartupTriggered();
     void onSettingTriggered();
+    void onDiagnosticsTriggered();
     void onAboutTriggered();
     void onExitAppTriggered();
 
     void updateExecutableMenu();
 
 private:
+    void setupText_();
     void setupLanguageMenu_();
     void setupExecutableMenu_();
     void setExecutableMenuIcon_(const QString& exePath);
@@ -39,6 +36,7 @@ private:
     QActionGroup* executableGroup_ = nullptr;
     QAction* runOnStartup_ = nullptr;
     QAction* setting_ = nullptr;
+    QAction* diagnostics_ = nullptr;
     QAction* about_ = nullptr;
     QAction* exitApp_ = nullptr;
 };
@@ -0,0 +1,418 @@
+#include "trace_recorder.h"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace trace
+{
+
+static const char MAGIC[8] = { 'O', 'C', 'A', 'W', 'T', 'R', 'C', 1 };
+
+std::string toUtf8(const std::wstring& str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        uint32_t cp = static_cast<uint32_t>(str[i]);
+        // wchar_t为UTF-16（Windows）时合并代理对。
+        if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDBFF && i + 1 < str.size())
+        {
+            uint32_t low = static_cast<uint32_t>(str[i + 1]);
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                ++i;
+            }
+        }
+
+        if (cp < 0x80)
+        {
+            result += static_cast<char>(cp);
+        }
+        else if (cp < 0x800)
+        {
+            result += static_cast<char>(0xC0 | (cp >> 6));
+            result += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            result += static_cast<char>(0xE0 | (cp >> 12));
+            result += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            result += static_cast<char>(0xF0 | (cp >> 18));
+            result += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    return result;
+}
+
+std::wstring fromUtf8(const std::string& str)
+{
+    std::wstring result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size();)
+    {
+        unsigned char ch = static_cast<unsigned char>(str[i]);
+        size_t length = ch < 0x80 ? 1 : (ch >> 5) == 0x6 ? 2 : (ch >> 4) == 0xE ? 3 : (ch >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > str.size())
+        {
+            // 无效的字节替换为U+FFFD。
+            result += static_cast<wchar_t>(0xFFFD);
+            ++i;
+            continue;
+        }
+
+        uint32_t cp = length == 1 ? ch : ch & (0xFF >> (length + 1));
+        for (size_t j = 1; j < length; ++j)
+            cp = (cp << 6) | (static_cast<unsigned char>(str[i + j]) & 0x3F);
+        i += length;
+
+        if (sizeof(wchar_t) == 2 && cp >= 0x10000)
+        {
+            cp -= 0x10000;
+            result += static_cast<wchar_t>(0xD800 + (cp >> 10));
+            result += static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+        }
+        else
+        {
+            result += static_cast<wchar_t>(cp);
+        }
+    }
+    return result;
+}
+
+Recorder& Recorder::getInstance()
+{
+    static Recorder instance;
+    return instance;
+}
+
+Recorder::~Recorder()
+{
+    close();
+}
+
+void Recorder::open(const std::string& filename, uint64_t maxFileSize)
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    if (instance.ofs_.is_open())
+        instance.ofs_.close();
+    instance.open_.store(false, std::memory_order_relaxed);
+
+    instance.filename_ = filename;
+    instance.maxFileSize_ = maxFileSize;
+    if (!instance.openFile_())
+        throw std::runtime_error("Failed to open the trace file: " + filename);
+    instance.open_.store(true, std::memory_order_relaxed);
+}
+
+void Recorder::close()
+{
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    instance.open_.store(false, std::memory_order_relaxed);
+    if (instance.ofs_.is_open())
+        instance.ofs_.close();
+}
+
+void Recorder::recordForeground(uint64_t window, uint32_t processId, const std::wstring& className,
+                                const std::function<std::wstring()>& exeDirectory)
+{
+    if (!isOpen())
+        return;
+
+    auto& instance = getInstance();
+    bool isKnown = false;
+    {
+        std::lock_guard<std::mutex> lock(instance.mtx_);
+        isKnown = instance.knownWindows_.count({ window, processId }) != 0;
+    }
+    // 在锁外获取目录，避免阻塞其他记录。
+    std::wstring directory;
+    if (!isKnown && exeDirectory)
+        directory = exeDirectory();
+
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    if (!instance.ofs_.is_open())
+        return;
+    // 轮转后的新文件中此窗口未知，但目录未获取，记为空目录，下次出现时再记录。
+    bool rotated = instance.rotateIfFull_();
+    uint64_t classId = instance.stringId_(toUtf8(className));
+    uint64_t directoryId = isKnown ? 0 : instance.stringId_(toUtf8(directory));
+    if (!isKnown || !rotated)
+        instance.knownWindows_.insert({ window, processId });
+
+    instance.writeHeader_(RECORD_FOREGROUND);
+    instance.writeVarint_(window);
+    instance.writeVarint_(processId);
+    instance.writeVarint_(classId);
+    instance.writeVarint_(directoryId);
+}
+
+void Recorder::recordHotkey(bool isAdmin, bool coalesced)
+{
+    if (!isOpen())
+        return;
+
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    if (!instance.ofs_.is_open())
+        return;
+    instance.rotateIfFull_();
+    instance.writeHeader_(RECORD_HOTKEY);
+    instance.writeVarint_((isAdmin ? 1 : 0) | (coalesced ? 2 : 0));
+}
+
+void Recorder::recordResolve(uint64_t window, const std::wstring& className, Strategy strategy,
+                             const std::wstring& directory)
+{
+    if (!isOpen())
+        return;
+
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    if (!instance.ofs_.is_open())
+        return;
+    instance.rotateIfFull_();
+    uint64_t classId = instance.stringId_(toUtf8(className));
+    uint64_t directoryId = instance.stringId_(toUtf8(directory));
+    instance.writeHeader_(RECORD_RESOLVE);
+    instance.writeVarint_(window);
+    instance.writeVarint_(classId);
+    instance.writeVarint_(strategy);
+    instance.writeVarint_(directoryId);
+}
+
+void Recorder::recordStages(bool isAdmin, uint64_t settingsUs, uint64_t resolveUs, uint64_t launchUs,
+                            uint64_t totalUs)
+{
+    if (!isOpen())
+        return;
+
+    auto& instance = getInstance();
+    std::lock_guard<std::mutex> lock(instance.mtx_);
+    if (!instance.ofs_.is_open())
+        return;
+    instance.rotateIfFull_();
+    instance.writeHeader_(RECORD_STAGES);
+    instance.writeVarint_(isAdmin ? 1 : 0);
+    instance.writeVarint_(settingsUs);
+    instance.writeVarint_(resolveUs);
+    instance.writeVarint_(launchUs);
+    instance.writeVarint_(totalUs);
+}
+
+bool Recorder::openFile_()
+{
+    strings_.clear();
+    knownWindows_.clear();
+    fileSize_ = 0;
+    ofs_.open(std::filesystem::u8path(filename_), std::ios_base::binary | std::ios_base::trunc);
+    if (!ofs_.is_open())
+        return false;
+    write_(MAGIC, sizeof(MAGIC));
+    lastTime_ = Clock::now();
+    return true;
+}
+
+bool Recorder::rotateIfFull_()
+{
+    if (maxFileSize_ == 0 || fileSize_ < maxFileSize_)
+        return false;
+
+    ofs_.close();
+    auto path = std::filesystem::u8path(filename_);
+    auto rotated = path;
+    rotated += ".1";
+    std::error_code ec;
+    std::filesystem::remove(rotated, ec);
+    std::filesystem::rename(path, rotated, ec);
+    // 无法重新打开时停止记录。
+    if (!openFile_())
+        open_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void Recorder::writeHeader_(RecordType type)
+{
+    auto now = Clock::now();
+    auto dt = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastTime_).count();
+    lastTime_ = now;
+    char ch = static_cast<char>(type);
+    write_(&ch, 1);
+    writeVarint_(dt > 0 ? static_cast<uint64_t>(dt) : 0);
+}
+
+void Recorder::writeVarint_(uint64_t value)
+{
+    char buffer[10];
+    size_t size = 0;
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer[size++] = static_cast<char>(value ? byte | 0x80 : byte);
+    } while (value);
+    write_(buffer, size);
+}
+
+void Recorder::write_(const char* data, size_t size)
+{
+    ofs_.write(data, static_cast<std::streamsize>(size));
+    fileSize_ += size;
+}
+
+uint64_t Recorder::stringId_(const std::string& str)
+{
+    if (str.empty())
+        return 0;
+
+    auto it = strings_.find(str);
+    if (it != strings_.end())
+        return it->second;
+
+    uint64_t id = strings_.size() + 1;
+    strings_.emplace(str, id);
+    char ch = static_cast<char>(RECORD_STRING);
+    write_(&ch, 1);
+    writeVarint_(id);
+    writeVarint_(str.size());
+    write_(str.data(), str.size());
+    return id;
+}
+
+Reader::Reader(const std::string& filename) :
+    ifs_(std::filesystem::u8path(filename), std::ios_base::binary)
+{
+    if (!ifs_.is_open())
+        throw std::runtime_error("Failed to open the trace file: " + filename);
+
+    char magic[sizeof(MAGIC)] = {};
+    ifs_.read(magic, sizeof(magic));
+    if (!ifs_ || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error("The file is not a trace file: " + filename);
+}
+
+bool Reader::next(Record& record)
+{
+    while (true)
+    {
+        uint8_t type = 0;
+        if (!readByte_(type))
+            return false;
+
+        if (type == RECORD_STRING)
+        {
+            uint64_t id = 0;
+            uint64_t size = 0;
+            if (!readVarint_(id) || !readVarint_(size) || size > (1ULL << 20))
+            {
+                truncated_ = true;
+                return false;
+            }
+            std::string str(static_cast<size_t>(size), '\0');
+            ifs_.read(&str[0], static_cast<std::streamsize>(size));
+            if (!ifs_)
+            {
+                truncated_ = true;
+                return false;
+            }
+            strings_[id] = std::move(str);
+            continue;
+        }
+
+        uint64_t dt = 0;
+        if (!readVarint_(dt))
+        {
+            truncated_ = true;
+            return false;
+        }
+
+        record = Record();
+        record.type = static_cast<RecordType>(type);
+        uint64_t v[5] = {};
+        bool ok = true;
+        switch (type)
+        {
+            case RECORD_FOREGROUND:
+                for (int i = 0; i < 4 && ok; ++i)
+                    ok = readVarint_(v[i]);
+                record.window = v[0];
+                record.processId = static_cast<uint32_t>(v[1]);
+                record.className = string_(v[2]);
+                record.directory = string_(v[3]);
+                break;
+            case RECORD_HOTKEY:
+                ok = readVarint_(v[0]);
+                record.isAdmin = (v[0] & 1) != 0;
+                record.coalesced = (v[0] & 2) != 0;
+                break;
+            case RECORD_RESOLVE:
+                for (int i = 0; i < 4 && ok; ++i)
+                    ok = readVarint_(v[i]);
+                record.window = v[0];
+                record.className = string_(v[1]);
+                record.strategy = static_cast<Strategy>(v[2]);
+                record.directory = string_(v[3]);
+                break;
+            case RECORD_STAGES:
+                for (int i = 0; i < 5 && ok; ++i)
+                    ok = readVarint_(v[i]);
+                record.isAdmin = (v[0] & 1) != 0;
+                for (int i = 0; i < 4; ++i)
+                    record.stages[i] = v[i + 1];
+                break;
+            default:
+                throw std::runtime_error("Unknown record type in the trace file: " + std::to_string(type));
+        }
+        if (!ok)
+        {
+            truncated_ = true;
+            return false;
+        }
+
+        time_ += dt;
+        record.time = time_;
+        return true;
+    }
+}
+
+bool Reader::readVarint_(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = 0;
+        if (!readByte_(byte))
+            return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool Reader::readByte_(uint8_t& value)
+{
+    int ch = ifs_.get();
+    if (ch == std::char_traits<char>::eof())
+        return false;
+    value = static_cast<uint8_t>(ch);
+    return true;
+}
+
+std::string Reader::string_(uint64_t id) const
+{
+    auto it = strings_.find(id);
+    return it != strings_.end() ? it->second : std::string();
+}
+
+} // namespace trace
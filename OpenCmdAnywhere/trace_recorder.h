@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// 焦点与热键追踪文件的格式（所有整数为LEB128变长编码，字符串为UTF-8）：
+//   文件头: "OCAWTRC" 版本号(1字节)
+//   记录: 类型(1字节) 内容，dt为距上一条记录的纳秒数
+//     'S' 字符串定义: id 长度 字节，之后的记录以id引用字符串（id从1开始，0表示空）
+//     'F' 前台窗口切换: dt 窗口 进程ID 类名id 可执行文件所在目录id（同一窗口与进程只记录一次，之后为0）
+//     'H' 热键触发: dt 标志（bit0为以管理员身份运行，bit1为被合并）
+//     'R' 目录解析: dt 窗口 类名id 策略 目录id
+//     'T' 各阶段耗时: dt 标志（bit0为以管理员身份运行） 读取设置 解析目录 启动 总计（微秒）
+// 文件超过大小上限时轮转：当前文件重命名为"文件名.1"（替换旧的），再以新的文件继续记录。
+// 每个文件包含其所需的字符串定义，可单独读取。
+namespace trace
+{
+
+enum RecordType : uint8_t
+{
+    RECORD_STRING       = 'S',
+    RECORD_FOREGROUND   = 'F',
+    RECORD_HOTKEY       = 'H',
+    RECORD_RESOLVE      = 'R',
+    RECORD_STAGES       = 'T'
+};
+
+enum Strategy : uint8_t
+{
+    STRATEGY_EXECUTABLE,
+    STRATEGY_DESKTOP,
+    STRATEGY_EXPLORER
+};
+
+// 解码后的记录，字符串已由id展开。
+struct Record
+{
+    RecordType type;
+    // 距文件开始的纳秒数。
+    uint64_t time = 0;
+    uint64_t window = 0;
+    uint32_t processId = 0;
+    bool isAdmin = false;
+    bool coalesced = false;
+    Strategy strategy = STRATEGY_EXECUTABLE;
+    std::string className;
+    // 'F'为可执行文件所在目录，'R'为解析的目录。
+    std::string directory;
+    // 'T'的各阶段耗时（微秒），顺序与LatencyStats::Stage相同。
+    uint64_t stages[4] = {};
+};
+
+std::string toUtf8(const std::wstring& str);
+std::wstring fromUtf8(const std::string& str);
+
+// Singleton
+// 可选开启的追踪记录，未开启时各record函数只有一次原子读取的开销。线程安全。
+class Recorder
+{
+public:
+    static Recorder& getInstance();
+
+    static constexpr uint64_t DEFAULT_MAX_FILE_SIZE = 64 * 1024 * 1024;
+
+    // filename为UTF-8编码。maxFileSize为单个文件的大小上限（字节），为0时不轮转。失败时抛出std::runtime_error。
+    static void open(const std::string& filename, uint64_t maxFileSize = DEFAULT_MAX_FILE_SIZE);
+    static void close();
+    static bool isOpen() { return getInstance().open_.load(std::memory_order_relaxed); }
+
+    // exeDirectory仅在此窗口与进程第一次出现时调用（获取目录需打开进程）。
+    static void recordForeground(uint64_t window, uint32_t processId, const std::wstring& className,
+                                 const std::function<std::wstring()>& exeDirectory);
+    static void recordHotkey(bool isAdmin, bool coalesced);
+    static void recordResolve(uint64_t window, const std::wstring& className, Strategy strategy,
+                              const std::wstring& directory);
+    static void recordStages(bool isAdmin, uint64_t settingsUs, uint64_t resolveUs, uint64_t launchUs,
+                             uint64_t totalUs);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Recorder() = default;
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // 以下函数需在持有mtx_时调用。
+    // 打开（截断）文件并写入文件头，清空字符串与已知窗口。
+    bool openFile_();
+    // 文件超过大小上限时轮转，需在写入一条记录（包括其字符串定义）前调用。返回是否已轮转。
+    bool rotateIfFull_();
+    void writeHeader_(RecordType type);
+    void writeVarint_(uint64_t value);
+    void write_(const char* data, size_t size);
+    uint64_t stringId_(const std::string& str);
+
+    std::atomic<bool> open_{false};
+    std::mutex mtx_;
+    std::string filename_;
+    uint64_t maxFileSize_ = 0;
+    uint64_t fileSize_ = 0;
+    std::ofstream ofs_;
+    Clock::time_point lastTime_;
+    // 以下两者随文件轮转清空，其大小受文件大小上限约束。
+    std::unordered_map<std::string, uint64_t> strings_;
+    std::set<std::pair<uint64_t, uint32_t>> knownWindows_;
+};
+
+// 读取追踪文件，失败时抛出std::runtime_error。
+class Reader
+{
+public:
+    // filename为UTF-8编码。
+    explicit Reader(const std::string& filename);
+
+    // 读取下一条记录（字符串定义不返回）。到达文件末尾或文件被截断时返回false。
+    bool next(Record& record);
+    // 文件末尾的记录不完整（如进程未正常退出）。
+    bool isTruncated() const { return truncated_; }
+
+private:
+    bool readVarint_(uint64_t& value);
+    bool readByte_(uint8_t& value);
+    // id为0或未定义时返回空字符串。
+    std::string string_(uint64_t id) const;
+
+    std::ifstream ifs_;
+    uint64_t time_ = 0;
+    bool truncated_ = false;
+    std::unordered_map<uint64_t, std::string> strings_;
+};
+
+} // namespace trace
@@ -10,6 +10,8 @@
 
 #include <minilog.hpp>
 
+#include "metrics.h"
+
 bool isRunOnStartup()
 {
     QSettings settings(
@@ -39,6 +41,11 @@ bool setRunOnStartup(bool enable)
 
 QIcon getExecutableIcon(const QString& exePath)
 {
+    static auto& lookupSuccess = Metrics::counter("ocaw_icon_lookups_total",
+        "The number of the executable icon lookups.", "result=\"success\"");
+    static auto& lookupFailure = Metrics::counter("ocaw_icon_lookups_total",
+        "The number of the executable icon lookups.", "result=\"failure\"");
+
     std::wstring path = QDir::toNativeSeparators(exePath).toStdWString();
     SHFILEINFOW sfi = {0};
     // https://learn.microsoft.com/en-us/windows/win32/api/shellapi/nf-shellapi-shgetfileinfow
@@ -60,5 +67,6 @@ QIcon getExecutableIcon(const QString& exePath)
         DestroyIcon(sfi.hIcon);
     }
 
+    (icon.isNull() ? lookupFailure : lookupSuccess).increment();
     return icon;
 }
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "latency.h"
+
+// 手动推进的时钟，用于模拟。伪造的窗口系统与进程启动以推进时钟代替真实的耗时，
+// 使模拟的延迟结果可复现，且与机器的快慢无关。
+class VirtualClock
+{
+public:
+    LatencyStats::TimePoint now() const
+    {
+        return LatencyStats::TimePoint(std::chrono::nanoseconds(ns_.load(std::memory_order_acquire)));
+    }
+
+    void advance(std::chrono::nanoseconds duration)
+    {
+        ns_.fetch_add(duration.count(), std::memory_order_acq_rel);
+    }
+
+    // 如果time早于当前时间则不变。
+    void advanceTo(LatencyStats::TimePoint time)
+    {
+        int64_t target = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        int64_t current = ns_.load(std::memory_order_acquire);
+        while (current < target && !ns_.compare_exchange_weak(current, target, std::memory_order_acq_rel))
+            ;
+    }
+
+private:
+    std::atomic<int64_t> ns_{0};
+};
@@ -0,0 +1,123 @@
+// The minimal benchmark framework of the ocaw_bench.
+//
+// Define a benchmark in any source file of the target:
+//   OCAW_BENCHMARK(counter_increment)
+//   {
+//       Counter counter;                // The setup.
+//       state.resetTimer();
+//       for (uint64_t i = 0; i < state.iterations(); ++i)
+//           counter.increment();
+//   }
+// The runner chooses the number of the iterations to run at least the minimum time and reports the time per iteration.
+// A benchmark can also report counters (e.g. the allocations per iteration) by the state.setCounter(), the counters
+// of the median repetition are printed and written to the JSON results.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BenchState
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit BenchState(uint64_t iterations) : iterations_(iterations), start_(Clock::now()) {}
+
+    uint64_t iterations() const { return iterations_; }
+
+    // Restart the timing, call it after the setup which should not be measured.
+    void resetTimer() { start_ = Clock::now(); }
+
+    Clock::time_point start() const { return start_; }
+
+    // Set the value of the named counter, replace the previous value of the same name.
+    void setCounter(const std::string& name, double value)
+    {
+        for (auto& counter : counters_)
+        {
+            if (counter.first == name)
+            {
+                counter.second = value;
+                return;
+            }
+        }
+        counters_.push_back({ name, value });
+    }
+
+    const std::vector<std::pair<std::string, double>>& counters() const { return counters_; }
+
+private:
+    uint64_t iterations_;
+    Clock::time_point start_;
+    std::vector<std::pair<std::string, double>> counters_;
+};
+
+using BenchFunction = void (*)(BenchState& state);
+
+void registerBenchmark(const char* name, BenchFunction function);
+
+struct BenchRegistrar
+{
+    BenchRegistrar(const char* name, BenchFunction function) { registerBenchmark(name, function); }
+};
+
+#define OCAW_BENCHMARK(name) \
+    static void name(BenchState& state); \
+    static BenchRegistrar name##Registrar_(#name, name); \
+    static void name(BenchState& state)
+
+// Prevent the compiler from optimizing away the computation of the value.
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Count the allocations of all threads by the global operator new which is replaced in the ocaw_bench,
+// the allocations are counted only while any AllocationCounter exists.
+class AllocationCounter
+{
+public:
+    AllocationCounter();
+
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    // The number of the allocations since this counter is created.
+    uint64_t count() const;
+
+private:
+    uint64_t start_;
+};
+
+// The paths in the languages file are relative to the working directory of the application,
+// so the benchmarks which load the languages run in the source directory of the application.
+class WorkingDirectoryGuard
+{
+public:
+    explicit WorkingDirectoryGuard(const std::filesystem::path& path) :
+        original_(std::filesystem::current_path())
+    {
+        std::filesystem::current_path(path);
+    }
+
+    ~WorkingDirectoryGuard() { std::filesystem::current_path(original_); }
+
+private:
+    std::filesystem::path original_;
+};
@@ -0,0 +1,47 @@
+// The global operator new of the ocaw_bench, replaced to count the allocations for the AllocationCounter.
+// It is in its own source file, so the operator new is not inlined into the callers of the operator delete.
+
+#include <cstdlib>
+#include <new>
+
+#include "bench.h"
+
+// The allocations are counted only while any AllocationCounter exists, so the other benchmarks pay a load only.
+static std::atomic<int> allocationCounters{0};
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new(std::size_t size)
+{
+    if (allocationCounters.load(std::memory_order_relaxed) != 0)
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+AllocationCounter::AllocationCounter()
+{
+    allocationCounters.fetch_add(1, std::memory_order_relaxed);
+    start_ = allocations.load(std::memory_order_relaxed);
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    allocationCounters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::count() const
+{
+    return allocations.load(std::memory_order_relaxed) - start_;
+}
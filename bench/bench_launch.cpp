@@ -0,0 +1,72 @@
+// The process spawn latency of each launcher backend. Each iteration launches a trivial child and waits for its exit,
+// so the time includes the process creation and teardown, which the user waits for at least the first part of.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "launcher.h"
+
+#include "bench.h"
+
+#ifdef _WIN32
+static const wchar_t* CHILD_EXECUTABLE  = L"cmd.exe";
+static const wchar_t* CHILD_PARAMETER   = L"/c exit";
+#else
+static const wchar_t* CHILD_EXECUTABLE  = L"true";
+static const wchar_t* CHILD_PARAMETER   = L"";
+#endif
+
+static void benchLaunch(BenchState& state, ProcessLauncher& launcher, const std::wstring& workDirectory)
+{
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        ProcessLauncher::Process process = ProcessLauncher::INVALID_PROCESS;
+        if (!launcher.launch(CHILD_EXECUTABLE, workDirectory, CHILD_PARAMETER, false, &process))
+        {
+            std::fprintf(stderr, "Failed to launch by the %s\n", launcher.name());
+            std::exit(2);
+        }
+        doNotOptimize(ProcessLauncher::waitProcess(process));
+    }
+}
+
+#ifdef _WIN32
+
+OCAW_BENCHMARK(launch_shell_execute)
+{
+    ShellExecuteLauncher launcher;
+    benchLaunch(state, launcher, L"");
+}
+
+OCAW_BENCHMARK(launch_create_process)
+{
+    CreateProcessLauncher launcher;
+    benchLaunch(state, launcher, L"");
+}
+
+#else
+
+OCAW_BENCHMARK(launch_posix_spawn)
+{
+    SpawnLauncher launcher;
+    benchLaunch(state, launcher, L"");
+}
+
+OCAW_BENCHMARK(launch_posix_spawn_chdir)
+{
+    SpawnLauncher launcher;
+    benchLaunch(state, launcher, L"/tmp");
+}
+
+// The quoted parameter of a typical terminal command line.
+OCAW_BENCHMARK(launch_split_parameter)
+{
+    std::string parameter = "-NoExit -Command \"Set-Location \\\"/home/bench/Open Cmd\\\"; git status\"";
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(SpawnLauncher::splitParameter(parameter));
+}
+
+#endif
@@ -0,0 +1,377 @@
+// The formatting and throughput of the MiniLog, as configured by the application.
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <minilog.hpp>
+#include <minilog_binary.hpp>
+
+#include "bench.h"
+#include "latency.h"
+#include "minilog_reference.h"
+
+// Discard the output, so only the formatting and the dispatching are measured.
+class NullBuffer : public std::streambuf
+{
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+};
+
+OCAW_BENCHMARK(log_format_text)
+{
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    mlog::Logger logger("Null", os, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        logger.warning("Failed to resolve the directory, hotkey: {}, rc: {}", "Ctrl+Alt+T", i);
+}
+
+OCAW_BENCHMARK(log_format_json_event)
+{
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    mlog::Logger logger("Null", os, mlog::OUT_AS_JSON | mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        logger.event<mlog::LVL_WARNING>("Failed to add the hotkey", { mlog::field("hotkey", "Ctrl+Alt+T"),
+            mlog::field("admin", false), mlog::field("rc", static_cast<int>(i)) });
+    }
+}
+
+// The cost of the timestamp per message, compared with the log_timestamp_none.
+static void timestamp(BenchState& state, int outflag, mlog::TimestampPrecision precision, bool isRelative)
+{
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    mlog::Logger logger("Null", os, outflag);
+    logger.setTimestampPrecision(precision);
+    logger.setRelativeTime(isRelative);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        logger.warning("Launched the executable");
+}
+
+OCAW_BENCHMARK(log_timestamp_none)
+{
+    timestamp(state, mlog::OUT_WITH_LEVEL, mlog::TIMESTAMP_SECOND, false);
+}
+
+OCAW_BENCHMARK(log_timestamp_second)
+{
+    timestamp(state, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP, mlog::TIMESTAMP_SECOND, false);
+}
+
+OCAW_BENCHMARK(log_timestamp_millisecond)
+{
+    timestamp(state, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP, mlog::TIMESTAMP_MILLISECOND, false);
+}
+
+OCAW_BENCHMARK(log_timestamp_microsecond)
+{
+    timestamp(state, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP, mlog::TIMESTAMP_MICROSECOND, false);
+}
+
+// The monotonic seconds since the logger is created, e.g. +12.345678.
+OCAW_BENCHMARK(log_timestamp_relative)
+{
+    timestamp(state, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP, mlog::TIMESTAMP_MICROSECOND, true);
+}
+
+// The text styles of the sinks in turn, the colorize flag is ignored as the sinks are not the console.
+static const int SINK_STYLES[] = {
+    mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP,
+    mlog::OUT_WITH_LEVEL,
+    mlog::OUT_WITH_ALL,
+    mlog::OUT_WITH_NONE
+};
+
+// The cost per message written to all sinks, the message is rendered once per distinct style.
+template <typename Logger>
+static void fanOut(BenchState& state, int sinkCount)
+{
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    Logger logger;
+    for (int i = 0; i < sinkCount; ++i)
+        logger.addOs("Null" + std::to_string(i), os, SINK_STYLES[i % std::size(SINK_STYLES)]);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        logger.template log<mlog::LVL_WARNING>("Failed to resolve the directory, hotkey: {}, rc: {}", "Ctrl+Alt+T", i);
+}
+
+// The current fan-out and the fan-out before, which rendered the message into a stringstream for each sink.
+#define FAN_OUT_BENCHMARK(n) \
+    OCAW_BENCHMARK(log_fan_out_##n) \
+    { \
+        fanOut<mlog::Logger>(state, n); \
+    } \
+    OCAW_BENCHMARK(log_fan_out_##n##_reference) \
+    { \
+        fanOut<reference::Logger>(state, n); \
+    }
+
+FAN_OUT_BENCHMARK(1)
+FAN_OUT_BENCHMARK(4)
+FAN_OUT_BENCHMARK(16)
+
+template <bool isReference, typename Tuple, size_t... I>
+static void formatOnce(const std::string& fmt, const Tuple& args, std::index_sequence<I...>)
+{
+    if constexpr (isReference)
+        doNotOptimize(reference::format(fmt, std::get<I % std::tuple_size<Tuple>::value>(args)...));
+    else
+        doNotOptimize(mlog::format(fmt, std::get<I % std::tuple_size<Tuple>::value>(args)...));
+}
+
+// Format the message of N arguments, the arguments are an integer, a floating point and a string in turn.
+template <size_t N, bool isReference>
+static void formatArgs(BenchState& state)
+{
+    std::string fmt = "Launch";
+    for (size_t i = 0; i < N; ++i)
+        fmt += ", value " + std::to_string(i) + ": {}";
+    const auto args = std::make_tuple(42, 3.14159, std::string("C:\\Users\\Bench"));
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        formatOnce<isReference>(fmt, args, std::make_index_sequence<N>());
+}
+
+// The single pass formatter and the recursive stringstream formatter it replaced.
+#define FORMAT_ARGS_BENCHMARK(n) \
+    OCAW_BENCHMARK(log_format_args_##n) \
+    { \
+        formatArgs<n, false>(state); \
+    } \
+    OCAW_BENCHMARK(log_format_args_##n##_reference) \
+    { \
+        formatArgs<n, true>(state); \
+    }
+
+FORMAT_ARGS_BENCHMARK(1)
+FORMAT_ARGS_BENCHMARK(2)
+FORMAT_ARGS_BENCHMARK(3)
+FORMAT_ARGS_BENCHMARK(4)
+FORMAT_ARGS_BENCHMARK(5)
+FORMAT_ARGS_BENCHMARK(6)
+FORMAT_ARGS_BENCHMARK(7)
+FORMAT_ARGS_BENCHMARK(8)
+
+// The debug call rejected by the runtime level mask, only the mask is checked before returning.
+OCAW_BENCHMARK(log_disabled_level_mask)
+{
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    mlog::Logger logger("Null", os, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    logger.setLevelMask(mlog::LVL_INFO | mlog::LVL_WARNING | mlog::LVL_ERROR | mlog::LVL_FATAL);
+    std::string directory = "C:\\Users\\Bench\\Documents";
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        logger.debug("Resolved the directory: {}, elapsed: {} us", directory, i);
+}
+
+// The same call before the level mask: the message and the timestamp are built, then the stream rejects it.
+OCAW_BENCHMARK(log_disabled_before_mask)
+{
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    reference::Logger logger;
+    logger.addOs("Null", os, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP,
+        mlog::LVL_INFO | mlog::LVL_WARNING | mlog::LVL_ERROR | mlog::LVL_FATAL);
+    std::string directory = "C:\\Users\\Bench\\Documents";
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        logger.log<mlog::LVL_DEBUG>("Resolved the directory: {}, elapsed: {} us", directory, i);
+}
+
+static long long steadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Record the latency from the log call to the sink, the message ends with the steady time of the log call (ns).
+class LatencyBuffer : public std::streambuf
+{
+public:
+    const LatencyHistogram& latency() const { return latency_; }
+
+protected:
+    // The stream writes each rendered message (include the newline) at once.
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        const char* end = s + n;
+        if (end != s && end[-1] == '\n')
+            --end;
+        const char* begin = end;
+        while (begin != s && begin[-1] != ' ')
+            --begin;
+        long long sent = 0;
+        if (std::from_chars(begin, end, sent).ec == std::errc())
+            latency_.record(static_cast<uint64_t>(std::max(steadyNs() - sent, 0LL)));
+        return n;
+    }
+
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+
+private:
+    // In nanoseconds instead of the microseconds of the hotkey latency.
+    LatencyHistogram latency_;
+};
+
+// The producers share the iterations, the time includes draining the queue by the background thread.
+// The counters are the latency from the log call to the sink and the ratio of the dropped messages.
+static void asyncThroughput(BenchState& state, int producerCount, mlog::OverflowPolicy policy)
+{
+    LatencyBuffer buffer;
+    std::ostream os(&buffer);
+    mlog::Logger logger("Latency", os, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+    logger.enableAsync(4096, policy);
+
+    std::atomic<bool> start{false};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < producerCount; ++t)
+    {
+        uint64_t count = state.iterations() / producerCount;
+        if (static_cast<uint64_t>(t) < state.iterations() % producerCount)
+            ++count;
+        producers.emplace_back([&, count]()
+        {
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (uint64_t i = 0; i < count; ++i)
+                logger.warning("Failed to resolve the directory, hotkey: {}, sent: {}", "Ctrl+Alt+T", steadyNs());
+        });
+    }
+
+    state.resetTimer();
+    start.store(true, std::memory_order_release);
+    for (auto& producer : producers)
+        producer.join();
+    logger.disableAsync();
+
+    const auto& latency = buffer.latency();
+    state.setCounter("latency_p50_ns", static_cast<double>(latency.percentile(50)));
+    state.setCounter("latency_p99_ns", static_cast<double>(latency.percentile(99)));
+    state.setCounter("latency_max_ns", static_cast<double>(latency.max()));
+    state.setCounter("dropped_ratio", static_cast<double>(logger.droppedCount()) / state.iterations());
+}
+
+#define ASYNC_THROUGHPUT_BENCHMARK(name, producerCount, policy) \
+    OCAW_BENCHMARK(log_throughput_async_##name##_##producerCount) \
+    { \
+        asyncThroughput(state, producerCount, policy); \
+    }
+
+// Wait for the free space when the queue is full.
+ASYNC_THROUGHPUT_BENCHMARK(block, 1, mlog::OVERFLOW_BLOCK)
+ASYNC_THROUGHPUT_BENCHMARK(block, 2, mlog::OVERFLOW_BLOCK)
+ASYNC_THROUGHPUT_BENCHMARK(block, 4, mlog::OVERFLOW_BLOCK)
+ASYNC_THROUGHPUT_BENCHMARK(block, 8, mlog::OVERFLOW_BLOCK)
+ASYNC_THROUGHPUT_BENCHMARK(block, 16, mlog::OVERFLOW_BLOCK)
+
+// Discard the new message when the queue is full.
+ASYNC_THROUGHPUT_BENCHMARK(drop, 1, mlog::OVERFLOW_DROP)
+ASYNC_THROUGHPUT_BENCHMARK(drop, 2, mlog::OVERFLOW_DROP)
+ASYNC_THROUGHPUT_BENCHMARK(drop, 4, mlog::OVERFLOW_DROP)
+ASYNC_THROUGHPUT_BENCHMARK(drop, 8, mlog::OVERFLOW_DROP)
+ASYNC_THROUGHPUT_BENCHMARK(drop, 16, mlog::OVERFLOW_DROP)
+
+// Discard the oldest message when the queue is full.
+ASYNC_THROUGHPUT_BENCHMARK(drop_oldest, 1, mlog::OVERFLOW_DROP_OLDEST)
+ASYNC_THROUGHPUT_BENCHMARK(drop_oldest, 2, mlog::OVERFLOW_DROP_OLDEST)
+ASYNC_THROUGHPUT_BENCHMARK(drop_oldest, 4, mlog::OVERFLOW_DROP_OLDEST)
+ASYNC_THROUGHPUT_BENCHMARK(drop_oldest, 8, mlog::OVERFLOW_DROP_OLDEST)
+ASYNC_THROUGHPUT_BENCHMARK(drop_oldest, 16, mlog::OVERFLOW_DROP_OLDEST)
+
+// The sustained write throughput of the rotating file stream, the small files are rotated during the run.
+// One of every 64 messages is a warning, the rest are the info.
+static void rotatingFile(BenchState& state, mlog::FlushPolicy policy)
+{
+    auto dir = std::filesystem::temp_directory_path() / "ocaw_bench_rotate";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    mlog::RotatingFileOptions options;
+    options.maxFileSize = 256 * 1024;
+    options.maxFiles = 3;
+    options.flushPolicy = policy;
+    options.flushInterval = 10;
+    {
+        mlog::Logger logger;
+        logger.addOs("File", (dir / "ocaw.log").string(), options, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+        state.resetTimer();
+        for (uint64_t i = 0; i < state.iterations(); ++i)
+        {
+            if (i % 64 == 0)
+                logger.warning("Failed to resolve the directory, hotkey: {}, rc: {}", "Ctrl+Alt+T", i);
+            else
+                logger.info("Resolved the directory, hotkey: {}, elapsed: {} us", "Ctrl+Alt+T", i);
+        }
+    }
+    std::filesystem::remove_all(dir);
+}
+
+OCAW_BENCHMARK(log_rotating_file_flush_every_message)
+{
+    rotatingFile(state, mlog::FLUSH_EVERY_MESSAGE);
+}
+
+// Flush every 10 ms.
+OCAW_BENCHMARK(log_rotating_file_flush_interval)
+{
+    rotatingFile(state, mlog::FLUSH_INTERVAL);
+}
+
+OCAW_BENCHMARK(log_rotating_file_flush_on_warning)
+{
+    rotatingFile(state, mlog::FLUSH_ON_WARNING);
+}
+
+// The size of the log file per message, to compare the binary log with the text log.
+static void setFileSizeCounter(BenchState& state, const std::filesystem::path& path)
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    state.setCounter("file_bytes_per_op", ec ? 0.0 : static_cast<double>(size) / state.iterations());
+    std::filesystem::remove(path, ec);
+}
+
+OCAW_BENCHMARK(log_binary_trace)
+{
+    auto path = std::filesystem::temp_directory_path() / "ocaw_bench.mlogbin";
+    auto& logger = mlog::bin::BinaryLogger::getGlobalInstance();
+    logger.open(path.string());
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        MLOG_BINARY(mlog::LVL_WARNING, "Failed to resolve the directory, hotkey: {}, rc: {}", "Ctrl+Alt+T", i);
+    logger.close();
+    setFileSizeCounter(state, path);
+}
+
+// The same message written to a text log file, as the text mode of the application.
+OCAW_BENCHMARK(log_text_trace)
+{
+    auto path = std::filesystem::temp_directory_path() / "ocaw_bench.log";
+    std::filesystem::remove(path);
+    {
+        mlog::Logger logger("File", path.string(), mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+        state.resetTimer();
+        for (uint64_t i = 0; i < state.iterations(); ++i)
+            logger.warning("Failed to resolve the directory, hotkey: {}, rc: {}", "Ctrl+Alt+T", i);
+    }
+    setFileSizeCounter(state, path);
+}
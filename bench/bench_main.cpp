@@ -0,0 +1,251 @@
+// Run the benchmarks of the OpenCmdAnywhere, record the results as JSON and compare them with a baseline.
+//
+// Usage: ocaw_bench [options]
+//   --filter <text>        Run only the benchmarks whose name contains the text.
+//   --min-time <ms>        The minimum time of each repetition (default: 200).
+//   --repetitions <n>      The number of the repetitions, the median is reported (default: 5).
+//   --out <file>           Write the results to the JSON file.
+//   --baseline <file>      Compare the results with the JSON file written by the --out.
+//   --tolerance <percent>  The slowdown allowed by the comparison (default: 10).
+//   --list                 List the benchmarks.
+// The exit code is 1 if any benchmark is slower than the baseline beyond the tolerance.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "bench.h"
+
+using Json = nlohmann::json;
+
+struct Benchmark
+{
+    const char* name;
+    BenchFunction function;
+};
+
+struct Result
+{
+    std::string name;
+    double nsPerOp;
+    double minNsPerOp;
+    uint64_t iterations;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+static std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> instance;
+    return instance;
+}
+
+void registerBenchmark(const char* name, BenchFunction function)
+{
+    benchmarks().push_back({ name, function });
+}
+
+// Return the elapsed nanoseconds of the measured part.
+static double runOnce(const Benchmark& benchmark, uint64_t iterations,
+    std::vector<std::pair<std::string, double>>* counters = nullptr)
+{
+    BenchState state(iterations);
+    benchmark.function(state);
+    auto end = BenchState::Clock::now();
+    if (counters)
+        *counters = state.counters();
+    return std::chrono::duration<double, std::nano>(end - state.start()).count();
+}
+
+static Result runBenchmark(const Benchmark& benchmark, double minTimeNs, int repetitions)
+{
+    // Grow the iterations until a run takes a tenth of the minimum time, then scale it to the minimum time.
+    uint64_t iterations = 1;
+    double elapsed = runOnce(benchmark, iterations);
+    while (elapsed < minTimeNs / 10 && iterations < (1ULL << 40))
+    {
+        iterations *= 10;
+        elapsed = runOnce(benchmark, iterations);
+    }
+    if (elapsed < minTimeNs)
+        iterations = static_cast<uint64_t>(iterations * (minTimeNs / std::max(elapsed, 1.0))) + 1;
+
+    // The time per iteration and the counters of each repetition.
+    std::vector<std::pair<double, std::vector<std::pair<std::string, double>>>> runs(repetitions);
+    for (auto& run : runs)
+        run.first = runOnce(benchmark, iterations, &run.second) / iterations;
+    std::sort(runs.begin(), runs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const auto& median = runs[runs.size() / 2];
+    return { benchmark.name, median.first, runs.front().first, iterations, median.second };
+}
+
+static bool writeResults(const std::string& filename, const std::vector<Result>& results)
+{
+    Json benchmarks = Json::array();
+    for (const auto& result : results)
+    {
+        Json item = {
+            { "name", result.name },
+            { "ns_per_op", result.nsPerOp },
+            { "min_ns_per_op", result.minNsPerOp },
+            { "iterations", result.iterations }
+        };
+        if (!result.counters.empty())
+        {
+            Json counters = Json::object();
+            for (const auto& counter : result.counters)
+                counters[counter.first] = counter.second;
+            item["counters"] = counters;
+        }
+        benchmarks.push_back(item);
+    }
+
+    std::ofstream ofs(filename);
+    if (!ofs.is_open())
+        return false;
+    ofs << Json({ { "version", 1 }, { "benchmarks", benchmarks } }).dump(4) << std::endl;
+    return static_cast<bool>(ofs);
+}
+
+// Return the number of the regressed benchmarks, or -1 if failed to read the baseline.
+static int compareResults(const std::string& filename, const std::vector<Result>& results, double tolerance)
+{
+    std::ifstream ifs(filename);
+    if (!ifs.is_open())
+    {
+        std::fprintf(stderr, "Failed to open the baseline file: %s\n", filename.c_str());
+        return -1;
+    }
+
+    Json baseline = Json::parse(ifs, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("benchmarks") || !baseline["benchmarks"].is_array())
+    {
+        std::fprintf(stderr, "Invalid baseline file: %s\n", filename.c_str());
+        return -1;
+    }
+
+    int regressed = 0;
+    std::printf("\nCompared with %s (tolerance %g%%)\n", filename.c_str(), tolerance);
+    for (const auto& result : results)
+    {
+        const Json* base = nullptr;
+        for (const auto& item : baseline["benchmarks"])
+        {
+            if (item.value("name", "") == result.name)
+                base = &item;
+        }
+
+        if (!base || !(*base)["ns_per_op"].is_number())
+        {
+            std::printf("  %-40s %12.2f ns   NEW\n", result.name.c_str(), result.nsPerOp);
+            continue;
+        }
+
+        double baseNs = (*base)["ns_per_op"].get<double>();
+        double change = baseNs > 0 ? (result.nsPerOp - baseNs) / baseNs * 100 : 0;
+        const char* status = "OK";
+        if (change > tolerance)
+        {
+            status = "REGRESSED";
+            ++regressed;
+        }
+        else if (change < -tolerance)
+        {
+            status = "IMPROVED";
+        }
+        std::printf("  %-40s %12.2f ns   %12.2f ns   %+7.1f%%   %s\n",
+            result.name.c_str(), baseNs, result.nsPerOp, change, status);
+    }
+    return regressed;
+}
+
+static void printUsage()
+{
+    std::fprintf(stderr,
+        "Usage: ocaw_bench [--filter text] [--min-time ms] [--repetitions n] [--out file]\n"
+        "                  [--baseline file] [--tolerance percent] [--list]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    std::string outFile;
+    std::string baselineFile;
+    double minTimeMs = 200;
+    int repetitions = 5;
+    double tolerance = 10;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue)
+            filter = argv[++i];
+        else if (arg == "--min-time" && hasValue)
+            minTimeMs = std::atof(argv[++i]);
+        else if (arg == "--repetitions" && hasValue)
+            repetitions = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue)
+            outFile = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            baselineFile = argv[++i];
+        else if (arg == "--tolerance" && hasValue)
+            tolerance = std::atof(argv[++i]);
+        else if (arg == "--list")
+        {
+            for (const auto& benchmark : benchmarks())
+                std::printf("%s\n", benchmark.name);
+            return 0;
+        }
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+    if (minTimeMs <= 0 || repetitions <= 0 || tolerance < 0)
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<Result> results;
+    std::printf("%-40s %12s %12s %14s\n", "Benchmark", "ns/op", "min ns/op", "iterations");
+    for (const auto& benchmark : benchmarks())
+    {
+        if (!filter.empty() && std::string(benchmark.name).find(filter) == std::string::npos)
+            continue;
+        results.push_back(runBenchmark(benchmark, minTimeMs * 1e6, repetitions));
+        const auto& result = results.back();
+        std::printf("%-40s %12.2f %12.2f %14llu\n", result.name.c_str(), result.nsPerOp, result.minNsPerOp,
+            static_cast<unsigned long long>(result.iterations));
+        for (const auto& counter : result.counters)
+            std::printf("    %-36s %12g\n", counter.first.c_str(), counter.second);
+        std::fflush(stdout);
+    }
+
+    if (!outFile.empty() && !writeResults(outFile, results))
+    {
+        std::fprintf(stderr, "Failed to write the results file: %s\n", outFile.c_str());
+        return 2;
+    }
+
+    if (!baselineFile.empty())
+    {
+        int regressed = compareResults(baselineFile, results, tolerance);
+        if (regressed < 0)
+            return 2;
+        if (regressed > 0)
+        {
+            std::printf("%d benchmarks regressed\n", regressed);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+// The metrics and the latency histograms, which are updated on the hotkey path.
+
+#include <thread>
+#include <vector>
+
+#include "latency.h"
+#include "metrics.h"
+
+#include "bench.h"
+
+OCAW_BENCHMARK(metrics_counter_increment)
+{
+    static auto& counter = Metrics::counter("ocaw_bench_total", "The counter of the benchmark.");
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        counter.increment();
+}
+
+// Four threads increment the same counter, the time is per increment of each thread.
+OCAW_BENCHMARK(metrics_counter_increment_4_threads)
+{
+    static auto& counter = Metrics::counter("ocaw_bench_total", "The counter of the benchmark.");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (uint64_t i = 0; i < state.iterations(); ++i)
+                counter.increment();
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+}
+
+OCAW_BENCHMARK(latency_histogram_record)
+{
+    LatencyHistogram histogram;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        histogram.record(i & 0xFFFF);
+}
+
+OCAW_BENCHMARK(metrics_exposition)
+{
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(Metrics::exposition());
+}
@@ -0,0 +1,88 @@
+// The launch profile matching of the resolved directory, with 10 and 10,000 directory prefix rules.
+// The trie match is compared with the linear scan of all rules, which is what a plain list of rules costs.
+
+#include <cwctype>
+#include <string>
+#include <vector>
+
+#include "launch_profile.h"
+
+#include "bench.h"
+
+static const wchar_t* MATCHED_DIRECTORY = L"d:\\Repos\\Team57\\Project42\\src\\OpenCmdAnywhere\\build";
+static const wchar_t* MISSED_DIRECTORY  = L"C:\\Users\\user\\Documents\\Projects\\OpenCmdAnywhere\\build";
+
+// The rules of D:\repos\team<t>\project<p>, 100 projects of each team.
+static std::vector<LaunchProfile> makeRules(size_t count)
+{
+    std::vector<LaunchProfile> rules;
+    rules.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        rules.push_back({ L"D:\\repos\\team" + std::to_wstring(i / 100) + L"\\project" + std::to_wstring(i % 100),
+            L"git-bash.exe", nullptr });
+    }
+    return rules;
+}
+
+static void benchMatch(BenchState& state, size_t ruleCount, const wchar_t* directory)
+{
+    LaunchProfiles profiles(makeRules(ruleCount));
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(profiles.match(directory));
+}
+
+OCAW_BENCHMARK(profile_build_10000)
+{
+    auto rules = makeRules(10000);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        LaunchProfiles profiles(rules);
+        doNotOptimize(profiles.size());
+    }
+}
+
+OCAW_BENCHMARK(profile_match_10)
+{
+    benchMatch(state, 10, L"d:\\Repos\\Team0\\Project7\\src\\OpenCmdAnywhere\\build");
+}
+
+OCAW_BENCHMARK(profile_match_10000)
+{
+    benchMatch(state, 10000, MATCHED_DIRECTORY);
+}
+
+OCAW_BENCHMARK(profile_match_miss_10000)
+{
+    benchMatch(state, 10000, MISSED_DIRECTORY);
+}
+
+// The baseline: compare the directory with each rule, keep the longest matched rule.
+static const LaunchProfile* matchLinear(const std::vector<LaunchProfile>& rules, const std::wstring& directory)
+{
+    auto fold = [](wchar_t ch) { return ch == L'/' ? L'\\' : static_cast<wchar_t>(std::towlower(ch)); };
+    const LaunchProfile* matched = nullptr;
+    for (const auto& rule : rules)
+    {
+        const auto& prefix = rule.directory;
+        if (prefix.size() > directory.size() || (matched && prefix.size() <= matched->directory.size()))
+            continue;
+        size_t i = 0;
+        while (i < prefix.size() && fold(prefix[i]) == fold(directory[i]))
+            ++i;
+        if (i == prefix.size() && (i == directory.size() || directory[i] == L'\\' || directory[i] == L'/'))
+            matched = &rule;
+    }
+    return matched;
+}
+
+OCAW_BENCHMARK(profile_match_linear_10000)
+{
+    auto rules = makeRules(10000);
+    std::wstring directory = MATCHED_DIRECTORY;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(matchLinear(rules, directory));
+}
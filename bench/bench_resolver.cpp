@@ -0,0 +1,79 @@
+// The directory resolver and its executable directory cache, with a window system which costs nothing,
+// so only the overhead of the resolver itself is measured.
+
+#include <string>
+#include <vector>
+
+#include "resolver.h"
+
+#include "bench.h"
+
+class StaticWindowSystem : public WindowSystem
+{
+public:
+    Window window = 1;
+    std::wstring className = L"Notepad";
+
+    Window foregroundWindow() override { return window; }
+    std::wstring windowClassName(Window) override { return className; }
+    uint32_t windowProcessId(Window window) override { return static_cast<uint32_t>(window) + 1000; }
+    std::wstring windowExePath(Window) override { return L"C:\\Program Files\\Notepad++\\notepad++.exe"; }
+    std::wstring windowExeDirectory(Window) override { return L"C:\\Program Files\\Notepad++"; }
+    std::wstring desktopDirectory() override { return L"C:\\Users\\Bench\\Desktop"; }
+    std::wstring explorerDirectory(Window) override { return L"D:\\Work\\OpenCmdAnywhere\\build"; }
+};
+
+OCAW_BENCHMARK(resolver_cache_hit)
+{
+    ExeDirectoryCache cache(64);
+    for (WindowSystem::Window window = 0; window < 64; ++window)
+        cache.insert(window, static_cast<uint32_t>(window) + 1000, L"C:\\Program Files\\App" + std::to_wstring(window));
+    std::wstring directory;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        WindowSystem::Window window = i % 64;
+        doNotOptimize(cache.find(window, static_cast<uint32_t>(window) + 1000, directory));
+    }
+}
+
+// Each lookup misses and inserts, evicting the oldest entry.
+OCAW_BENCHMARK(resolver_cache_miss_insert)
+{
+    ExeDirectoryCache cache(64);
+    std::wstring directory;
+    const std::wstring path = L"C:\\Program Files\\App";
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        if (!cache.find(i, 1000, directory))
+            cache.insert(i, 1000, path);
+    }
+}
+
+OCAW_BENCHMARK(resolve_executable_cached)
+{
+    StaticWindowSystem windowSystem;
+    ExeDirectoryCache cache;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(resolveFocusedWindowDirectory(windowSystem, &cache));
+}
+
+OCAW_BENCHMARK(resolve_executable_uncached)
+{
+    StaticWindowSystem windowSystem;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(resolveFocusedWindowDirectory(windowSystem));
+}
+
+OCAW_BENCHMARK(resolve_explorer)
+{
+    StaticWindowSystem windowSystem;
+    windowSystem.className = L"CabinetWClass";
+    ExeDirectoryCache cache;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(resolveFocusedWindowDirectory(windowSystem, &cache));
+}
@@ -0,0 +1,166 @@
+// The Qt side of the translation: the QEASYTR() cache, the language switch which invalidates the cache and
+// retranslates the widgets registered to the Retranslator, and the event dispatch cost of the app-wide
+// LanguageChange filter which the Retranslator replaces. The widgets are created on the offscreen platform,
+// so no display is required. The retranslation benchmarks also report the allocations per iteration.
+
+#include <iterator>
+
+#include <qapplication.h>
+#include <qbytearray.h>
+#include <qevent.h>
+#include <qlabel.h>
+#include <qlayout.h>
+#include <qobject.h>
+#include <qstring.h>
+#include <qwidget.h>
+
+#include <easy_translate.hpp>
+
+#include "bench.h"
+#include "language.h"
+#include "retranslator.h"
+
+static const int LABEL_COUNT = 200;
+
+static const char* const TRANSLATION_IDS[] = {
+    "About", "Add Executable", "Cancel", "Confirm", "Display Name", "Edit Executable", "Executable File",
+    "Language", "Remove Executable", "Run As Admin Hotkey", "Run As User Hotkey", "Run With", "Setting",
+    "Startup Parameter", "Warning"
+};
+
+static void ensureApplication()
+{
+    static QApplication* application = nullptr;
+    if (application)
+        return;
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    static int argc = 1;
+    static char name[] = "ocaw_bench";
+    static char* argv[] = { name, nullptr };
+    // Never destroyed, the Qt must not be shut down after the main() returns.
+    application = new QApplication(argc, argv);
+
+    WorkingDirectoryGuard guard(OCAW_SOURCE_DIR);
+    setLanguage("ZH");
+}
+
+// The window of the labels registered to the Retranslator, as the setting window does.
+class LabelWindow
+{
+public:
+    LabelWindow()
+    {
+        auto layout = new QVBoxLayout(&window_);
+        for (int i = 0; i < LABEL_COUNT; ++i)
+        {
+            auto label = new QLabel(&window_);
+            layout->addWidget(label);
+            Retranslator::add(label, TRANSLATION_IDS[i % std::size(TRANSLATION_IDS)], &QLabel::setText);
+        }
+        window_.show();
+        QApplication::processEvents();
+    }
+
+private:
+    // The labels are unregistered from the Retranslator when they are destroyed with the window.
+    QWidget window_;
+};
+
+// The cache hit, only the shared QString is copied.
+OCAW_BENCHMARK(qeasytr_cached)
+{
+    ensureApplication();
+    QEASYTR("Run As Admin Hotkey");
+    AllocationCounter allocations;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(QEASYTR("Run As Admin Hotkey"));
+    state.setCounter("allocations_per_op", static_cast<double>(allocations.count()) / state.iterations());
+}
+
+// Without the cache, every lookup decodes the UTF-8 text.
+OCAW_BENCHMARK(qeasytr_uncached)
+{
+    ensureApplication();
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(QString::fromUtf8(EASYTR("Run As Admin Hotkey")));
+}
+
+// Retranslate the registered labels in the current language, all lookups hit the cache.
+OCAW_BENCHMARK(retranslate_labels_200)
+{
+    ensureApplication();
+    LabelWindow window;
+    AllocationCounter allocations;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        Retranslator::retranslate();
+        QApplication::processEvents();
+    }
+    state.setCounter("allocations_per_op", static_cast<double>(allocations.count()) / state.iterations());
+}
+
+// The language switch: reload the languages, invalidate the cache, then retranslate the labels and repaint.
+OCAW_BENCHMARK(retranslate_language_switch_200)
+{
+    ensureApplication();
+    LabelWindow window;
+    WorkingDirectoryGuard guard(OCAW_SOURCE_DIR);
+    AllocationCounter allocations;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        setLanguage(i % 2 == 0 ? "EN" : "ZH");
+        QApplication::processEvents();
+    }
+    state.setCounter("allocations_per_op", static_cast<double>(allocations.count()) / state.iterations());
+    setLanguage("ZH");
+}
+
+// The app-wide filter as the SystemTray was installed before the Retranslator, every event of the application
+// passes through it to catch the LanguageChange.
+class LanguageChangeFilter : public QObject
+{
+public:
+    bool eventFilter(QObject* obj, QEvent* event) override
+    {
+        if (event->type() == QEvent::LanguageChange)
+            ++languageChanges_;
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    int languageChanges_ = 0;
+};
+
+static void dispatchEvents(BenchState& state, bool filtered)
+{
+    ensureApplication();
+    QLabel label;
+    LanguageChangeFilter filter;
+    if (filtered)
+        qApp->installEventFilter(&filter);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        QEvent event(QEvent::User);
+        QApplication::sendEvent(&label, &event);
+    }
+    qApp->removeEventFilter(&filter);
+}
+
+// The dispatch of an event to a widget without any app-wide filter, as it is now.
+OCAW_BENCHMARK(event_dispatch)
+{
+    dispatchEvents(state, false);
+}
+
+// The same dispatch with the app-wide LanguageChange filter, as it was before the Retranslator.
+OCAW_BENCHMARK(event_dispatch_language_filter)
+{
+    dispatchEvents(state, true);
+}
@@ -0,0 +1,81 @@
+// The settings read and write through the QSettings, and the executable registry which is stored as one map.
+// Only built if the Qt Core is found.
+
+#include <qcoreapplication.h>
+#include <qstring.h>
+#include <qvariant.h>
+
+#include "settings_manager.h"
+
+#include "bench.h"
+
+static const char* BENCH_ORGANIZATION = "OpenCmdAnywhereBench";
+
+// The settings of the benchmarks are stored in the user settings of the system (the registry on Windows) as the
+// application does, under their own organization, and removed when the benchmarks exit.
+class BenchSettings
+{
+public:
+    BenchSettings() : sm_(BENCH_ORGANIZATION, "Bench") { sm_.clearSettings(); }
+
+    ~BenchSettings() { sm_.clearSettings(); }
+
+    SettingsManager& get() { return sm_; }
+
+private:
+    SettingsManager sm_;
+};
+
+static SettingsManager& settingsManager()
+{
+    static BenchSettings instance;
+    return instance.get();
+}
+
+OCAW_BENCHMARK(settings_read)
+{
+    auto& sm = settingsManager();
+    sm.writeSetting("Parameter", "/k echo OpenCmdAnywhere");
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(sm.readSetting("Parameter", "").toString());
+}
+
+OCAW_BENCHMARK(settings_write)
+{
+    auto& sm = settingsManager();
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        sm.writeSetting("Parameter", QString::number(i));
+}
+
+// Add one executable to a registry of the given size, as Settings::addExecutable() writes the whole map.
+static void addExecutable(BenchState& state, int registrySize)
+{
+    auto& sm = settingsManager();
+    QVariantMap executables;
+    for (int i = 0; i < registrySize; ++i)
+        executables[QString("Executable %1").arg(i)] = QString("C:\\Tools\\tool%1.exe").arg(i);
+    sm.writeSetting("Executables", executables);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        executables["Bench"] = QString::number(i);
+        sm.writeSetting("Executables", executables);
+    }
+}
+
+OCAW_BENCHMARK(executable_registry_add_10)
+{
+    addExecutable(state, 10);
+}
+
+OCAW_BENCHMARK(executable_registry_add_100)
+{
+    addExecutable(state, 100);
+}
+
+OCAW_BENCHMARK(executable_registry_add_1000)
+{
+    addExecutable(state, 1000);
+}
@@ -0,0 +1,69 @@
+// The compilation and the expansion of the parameter templates. The expansion runs on each hotkey press,
+// compared with the naive find and replace of the placeholders in the parameter text.
+
+#include <string>
+
+#include "parameter_template.h"
+
+#include "bench.h"
+
+static const std::wstring TEMPLATE_TEXT = L"/k cd /d {dir_quoted} & title {exe_dir} & echo {dir}";
+static const wchar_t* DIRECTORY         = L"C:\\Users\\user\\Documents\\Projects\\OpenCmdAnywhere\\";
+static const wchar_t* EXE_PATH          = L"C:\\Program Files\\Microsoft VS Code\\Code.exe";
+
+OCAW_BENCHMARK(template_compile)
+{
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        ParameterTemplate parameterTemplate(TEMPLATE_TEXT);
+        doNotOptimize(parameterTemplate.isContextFree());
+    }
+}
+
+// The parameter without the placeholders, as the existing settings.
+OCAW_BENCHMARK(template_expand_constant)
+{
+    ParameterTemplate parameterTemplate(L"-NoExit -Command \"& {Set-PSReadLineOption -EditMode Emacs}\"");
+    std::wstring output;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        parameterTemplate.expand({ DIRECTORY, EXE_PATH }, output);
+        doNotOptimize(output.data());
+    }
+}
+
+// The output buffer is reused, as the capacity is enough after the first expansion.
+OCAW_BENCHMARK(template_expand_dir_quoted)
+{
+    ParameterTemplate parameterTemplate(TEMPLATE_TEXT);
+    std::wstring output;
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        parameterTemplate.expand({ DIRECTORY, EXE_PATH }, output);
+        doNotOptimize(output.data());
+    }
+}
+
+static void replaceAll(std::wstring& text, const std::wstring& from, const std::wstring& to)
+{
+    for (auto pos = text.find(from); pos != std::wstring::npos; pos = text.find(from, pos + to.size()))
+        text.replace(pos, from.size(), to);
+}
+
+// The baseline: scan the parameter text for each placeholder on each launch.
+OCAW_BENCHMARK(template_expand_naive_replace)
+{
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+        std::wstring exePath = EXE_PATH;
+        std::wstring output = TEMPLATE_TEXT;
+        replaceAll(output, L"{dir_quoted}", ParameterTemplate::quote(DIRECTORY));
+        replaceAll(output, L"{exe_dir}", exePath.substr(0, exePath.find_last_of(L"\\/")));
+        replaceAll(output, L"{dir}", DIRECTORY);
+        doNotOptimize(output.data());
+    }
+}
@@ -0,0 +1,66 @@
+// The translation lookup and the language switch of the EasyTranslate, with the language files of the application.
+
+#include <atomic>
+#include <thread>
+
+#include <easy_translate.hpp>
+
+#include "bench.h"
+
+static void loadLanguages()
+{
+    static bool loaded = false;
+    if (loaded)
+        return;
+
+    WorkingDirectoryGuard guard(OCAW_SOURCE_DIR);
+    easytr::setLanguages("language/languages.json");
+    easytr::setCurrentLanguage("ZH");
+    loaded = true;
+}
+
+OCAW_BENCHMARK(translate_lookup)
+{
+    loadLanguages();
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(EASYTR("Run As Admin Hotkey"));
+}
+
+// The missing translation falls back to the Translation ID.
+OCAW_BENCHMARK(translate_lookup_missing)
+{
+    loadLanguages();
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(EASYTR("Not Exists Translation ID"));
+}
+
+OCAW_BENCHMARK(translate_language_switch)
+{
+    loadLanguages();
+    WorkingDirectoryGuard guard(OCAW_SOURCE_DIR);
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        easytr::setCurrentLanguage(i % 2 == 0 ? "EN" : "ZH");
+    easytr::setCurrentLanguage("ZH");
+}
+
+// The lookup while another thread keeps switching the language, the lookup should not slow down.
+OCAW_BENCHMARK(translate_lookup_while_switching)
+{
+    loadLanguages();
+    WorkingDirectoryGuard guard(OCAW_SOURCE_DIR);
+    std::atomic<bool> stop{false};
+    std::thread switcher([&]()
+    {
+        for (int i = 0; !stop.load(std::memory_order_relaxed); ++i)
+            easytr::setCurrentLanguage(i % 2 == 0 ? "EN" : "ZH");
+    });
+    state.resetTimer();
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+        doNotOptimize(EASYTR("Run As Admin Hotkey"));
+    stop = true;
+    switcher.join();
+    easytr::setCurrentLanguage("ZH");
+}
@@ -0,0 +1,204 @@
+// The minilog as it was before the single pass formatter and the level mask, kept as the reference of the tests
+// (the output of the new formatter must be the same) and of the benchmarks (the cost before the changes).
+
+#pragma once
+
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <minilog.hpp>
+
+namespace reference
+{
+
+using String = std::string;
+
+template <typename T>
+String format(const String& fmt, const T& arg)
+{
+    std::stringstream ss;
+
+    if (fmt.size() < 4)
+    {
+        size_t pos = fmt.find("{}");
+        if (pos == String::npos)
+            return fmt;
+
+        ss << fmt.substr(0, pos);
+        ss << arg;
+
+        return ss.str() + fmt.substr(pos + 2);
+    }
+
+    String window(4, '\0');
+    for (size_t i = 0; i < fmt.size();)
+    {
+        window[0] = fmt[i];
+        window[1] = i < fmt.size() - 1 ? fmt[i + 1] : '\0';
+        window[2] = i < fmt.size() - 2 ? fmt[i + 2] : '\0';
+        window[3] = i < fmt.size() - 3 ? fmt[i + 3] : '\0';
+
+        if (window == "{{}}")
+        {
+            ss << "{}";
+            i += 4;
+            continue;
+        }
+
+        if (window[0] == '{' && window[1] == '}')
+        {
+            ss << arg;
+            return ss.str() + fmt.substr(i + 2);
+        }
+        else
+        {
+            ss << window[0];
+            i += 1;
+            continue;
+        }
+    }
+
+    return ss.str();
+}
+
+template <typename T, typename... Args>
+String format(const String& fmt, const T& arg, Args&&... args)
+{
+    std::stringstream ss;
+
+    if (fmt.size() < 4)
+    {
+        size_t pos = fmt.find("{}");
+        if (pos == String::npos)
+            return fmt;
+
+        ss << fmt.substr(0, pos);
+        ss << arg;
+
+        return ss.str() + fmt.substr(pos + 2);
+    }
+
+    String window(4, '\0');
+    for (size_t i = 0; i < fmt.size();)
+    {
+        window[0] = fmt[i];
+        window[1] = i < fmt.size() - 1 ? fmt[i + 1] : '\0';
+        window[2] = i < fmt.size() - 2 ? fmt[i + 2] : '\0';
+        window[3] = i < fmt.size() - 3 ? fmt[i + 3] : '\0';
+
+        if (window == "{{}}")
+        {
+            ss << "{}";
+            i += 4;
+            continue;
+        }
+
+        if (window[0] == '{' && window[1] == '}')
+        {
+            ss << arg;
+            return ss.str() + format(fmt.substr(i + 2), std::forward<Args>(args)...);
+        }
+        else
+        {
+            ss << window[0];
+            i += 1;
+            continue;
+        }
+    }
+
+    return ss.str();
+}
+
+
+// The Logger::log() of a plain message: the message is formatted and the timestamp is built before the level
+// filter of each stream is checked, and each stream renders the message into its own stringstream.
+class Logger
+{
+public:
+    void addOs(const String& nameid, std::ostream& os, int outflag = mlog::OUT_WITH_ALL,
+        int levelFilter = mlog::LEVLE_FILTER_ALL)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        outs_[nameid] = { &os, outflag, levelFilter };
+    }
+
+    template <mlog::Level level, typename... Args>
+    void log(const String& fmt, const Args&... args)
+    {
+        String message = format(fmt, args...);
+        String curtimeStr = currentTimeString_();
+        String levelStr = mlog::levelToString(level);
+
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        for (auto& var : outs_)
+        {
+            OutStream& os = var.second;
+
+            if (!(level & os.levelFilter))
+                continue;
+
+            bool isConsole = os.os == &std::cout || os.os == &std::cerr || os.os == &std::clog;
+            bool isColorize = isConsole && (os.outflag & mlog::OUT_WITH_COLORIZE);
+
+            std::stringstream ss;
+
+            if (os.outflag & mlog::OUT_WITH_TIMESTAMP)
+            {
+                ss << (isColorize ? "\033[0m\033[1;30m" : "");
+                ss << curtimeStr;
+                ss << (isColorize ? "\033[0m" : "");
+                ss << ' ';
+            }
+
+            // The color of each level is simplified, the benchmarks don't write to the console.
+            if (os.outflag & mlog::OUT_WITH_LEVEL)
+            {
+                if (isColorize)
+                    ss << "\033[0m\033[33m";
+                ss << levelStr;
+                ss << (isColorize ? "\033[0m" : "");
+                ss << ' ';
+            }
+
+            ss << message << "\n";
+
+            *os.os << ss.str();
+        }
+    }
+
+private:
+    struct OutStream
+    {
+        std::ostream* os;
+        int outflag;
+        int levelFilter;
+    };
+
+    static String currentTimeString_()
+    {
+        time_t time = 0;
+        ::time(&time);
+
+        tm lt = {};
+    #ifdef _WIN32
+        ::localtime_s(&lt, &time);
+    #else
+        ::localtime_r(&time, &lt);
+    #endif // _WIN32
+
+        char buffer[32] = {};
+        ::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &lt);
+
+        return buffer;
+    }
+
+    std::map<String, OutStream> outs_;
+    std::mutex mtx_;
+};
+
+} // namespace reference
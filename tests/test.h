@@ -0,0 +1,49 @@
+// The minimal test framework of the tests, each test executable is registered to the CTest.
+//
+// Define a test in any source file of the target:
+//   OCAW_TEST(counter_increment)
+//   {
+//       Counter counter;
+//       counter.increment();
+//       OCAW_CHECK_EQ(counter.value(), 1);
+//   }
+// A failed check is reported and the test continues, the exit code of the executable is 1 if any check failed.
+
+#pragma once
+
+#include <sstream>
+#include <string>
+
+using TestFunction = void (*)();
+
+void registerTest(const char* name, TestFunction function);
+
+// Report a failed check of the running test.
+void failCheck(const char* file, int line, const std::string& message);
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, TestFunction function) { registerTest(name, function); }
+};
+
+#define OCAW_TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar_(#name, name); \
+    static void name()
+
+#define OCAW_CHECK(expr) \
+    do { if (!(expr)) failCheck(__FILE__, __LINE__, #expr); } while (0)
+
+// The values are printed if the check failed, so they must support the operator<<.
+#define OCAW_CHECK_EQ(actual, expected) \
+    checkEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+template <typename A, typename E>
+inline void checkEqual(const A& actual, const E& expected, const char* expr, const char* file, int line)
+{
+    if (actual == expected)
+        return;
+    std::ostringstream oss;
+    oss << expr << "\n    actual:   " << actual << "\n    expected: " << expected;
+    failCheck(file, line, oss.str());
+}
@@ -0,0 +1,90 @@
+// The exit of the LaunchPipeline: the destructor waits for the finished workers, and abandons the hung ones after
+// the exit timeout, the abandoned workers finish later without touching the destroyed pipeline.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "launch_pipeline.h"
+
+#include "test.h"
+
+using namespace std::chrono;
+
+// Blocks the launcher until it is opened.
+struct Gate
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool entered = false;
+    bool opened = false;
+};
+
+static LaunchPipeline::ConfigSource configSource()
+{
+    return []() { return LaunchPipeline::Config{ L"cmd.exe", nullptr, nullptr }; };
+}
+
+static LaunchPipeline::Resolver resolver()
+{
+    return [](std::wstring*) { return std::wstring(L"C:\\Users\\Test"); };
+}
+
+OCAW_TEST(pipeline_exit_waits_for_workers)
+{
+    auto launched = std::make_shared<std::atomic<int>>(0);
+    {
+        LaunchPipeline pipeline(configSource(), resolver(),
+            [launched](const std::wstring&, const std::wstring&, const std::wstring&, bool, bool)
+            {
+                std::this_thread::sleep_for(milliseconds(20));
+                (*launched)++;
+                return true;
+            });
+        pipeline.trigger(false);
+        pipeline.trigger(true);
+    }
+    OCAW_CHECK_EQ(launched->load(), 2);
+}
+
+OCAW_TEST(pipeline_exit_abandons_hung_workers)
+{
+    auto gate = std::make_shared<Gate>();
+    auto start = steady_clock::now();
+    {
+        LaunchPipeline pipeline(configSource(), resolver(),
+            [gate](const std::wstring&, const std::wstring&, const std::wstring&, bool, bool)
+            {
+                std::unique_lock<std::mutex> lock(gate->mtx);
+                gate->entered = true;
+                gate->cv.notify_all();
+                gate->cv.wait(lock, [&]() { return gate->opened; });
+                return true;
+            });
+        pipeline.setExitTimeout(milliseconds(100));
+        pipeline.trigger(false);
+
+        std::unique_lock<std::mutex> lock(gate->mtx);
+        gate->cv.wait(lock, [&]() { return gate->entered; });
+        start = steady_clock::now();
+    }
+    // The destructor returned after the timeout while the worker is still blocked.
+    auto waited = steady_clock::now() - start;
+    OCAW_CHECK(waited >= milliseconds(100));
+    OCAW_CHECK(waited < seconds(2));
+
+    {
+        std::lock_guard<std::mutex> lock(gate->mtx);
+        gate->opened = true;
+    }
+    gate->cv.notify_all();
+
+    // The launcher is destroyed with the shared state of the pipeline when the abandoned worker finishes.
+    auto deadline = steady_clock::now() + seconds(5);
+    while (gate.use_count() > 1 && steady_clock::now() < deadline)
+        std::this_thread::sleep_for(milliseconds(1));
+    OCAW_CHECK_EQ(gate.use_count(), 1L);
+}
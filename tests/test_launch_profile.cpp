@@ -0,0 +1,112 @@
+// The matching of the LaunchProfiles: the longest directory prefix rule at the separator boundaries, the root and
+// UNC rules, the case folding, and the / and \ separators.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "launch_profile.h"
+#include "trace_recorder.h"
+
+#include "test.h"
+
+static std::vector<LaunchProfile> rules()
+{
+    return {
+        { L"D:\\repos", L"git-bash.exe", nullptr },
+        { L"D:\\repos\\OpenCmdAnywhere\\build\\", L"vs-dev.exe", nullptr },
+        { L"d:/REPOS/archive", L"cmd.exe", nullptr },
+        // The same directory as the first rule, it is ignored.
+        { L"D:\\Repos\\", L"ignored.exe", nullptr },
+        { L"\\\\server\\share", L"unc.exe", nullptr },
+        { L"E:\\", L"root.exe", nullptr },
+        { L"/home/user", L"bash", nullptr },
+        { L"/", L"sh", nullptr },
+        { L"C:\\Users\\\u00C9MILE", L"accent.exe", nullptr },
+        // The empty directory is ignored.
+        { L"", L"empty.exe", nullptr },
+        { L"\\/", L"slashes.exe", nullptr },
+    };
+}
+
+// The executable of the matched rule in UTF-8, "(none)" if no rule matches.
+static std::string match(const LaunchProfiles& profiles, const wchar_t* directory)
+{
+    const LaunchProfile* profile = profiles.match(directory);
+    return profile ? trace::toUtf8(profile->executable) : "(none)";
+}
+
+OCAW_TEST(profile_rules)
+{
+    LaunchProfiles profiles(rules());
+    OCAW_CHECK_EQ(profiles.size(), static_cast<size_t>(9));
+    OCAW_CHECK(!profiles.usesExe());
+
+    LaunchProfiles none;
+    OCAW_CHECK(none.empty());
+    OCAW_CHECK_EQ(match(none, L"D:\\repos"), "(none)");
+
+    LaunchProfiles withExe({ { L"C:\\", L"cmd.exe", std::make_shared<const ParameterTemplate>(L"/k echo {exe_dir}") } });
+    OCAW_CHECK(withExe.usesExe());
+}
+
+OCAW_TEST(profile_separator_boundary)
+{
+    LaunchProfiles profiles(rules());
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos"), "git-bash.exe");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\"), "git-bash.exe");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\OpenCmdAnywhere"), "git-bash.exe");
+    // A rule matches the whole path components only.
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos2"), "(none)");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repo"), "(none)");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\"), "(none)");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\OpenCmdAnywhere\\builds"), "git-bash.exe");
+    OCAW_CHECK_EQ(match(profiles, L"/home/username"), "sh");
+}
+
+OCAW_TEST(profile_root)
+{
+    LaunchProfiles profiles(rules());
+    OCAW_CHECK_EQ(match(profiles, L"E:\\"), "root.exe");
+    OCAW_CHECK_EQ(match(profiles, L"e:\\games"), "root.exe");
+    OCAW_CHECK_EQ(match(profiles, L"E:"), "root.exe");
+    OCAW_CHECK_EQ(match(profiles, L"/tmp"), "sh");
+    OCAW_CHECK_EQ(match(profiles, L"\\\\server\\share\\docs"), "unc.exe");
+    // The rule of the separators only matches any UNC path.
+    OCAW_CHECK_EQ(match(profiles, L"\\\\server\\shared"), "slashes.exe");
+    OCAW_CHECK_EQ(match(profiles, L""), "(none)");
+}
+
+OCAW_TEST(profile_case_folding)
+{
+    LaunchProfiles profiles(rules());
+    OCAW_CHECK_EQ(match(profiles, L"d:\\Repos\\ocaw"), "git-bash.exe");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\REPOS\\OPENCMDANYWHERE\\BUILD\\x64\\Release"), "vs-dev.exe");
+    OCAW_CHECK_EQ(match(profiles, L"C:\\Users\\\u00C9mile\\Documents"), "accent.exe");
+    OCAW_CHECK_EQ(match(profiles, L"C:\\Users\\Emile"), "(none)");
+}
+
+OCAW_TEST(profile_slashes)
+{
+    LaunchProfiles profiles(rules());
+    OCAW_CHECK_EQ(match(profiles, L"D:/repos/ocaw/src"), "git-bash.exe");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\archive\\2020"), "cmd.exe");
+    OCAW_CHECK_EQ(match(profiles, L"/home/user/src"), "bash");
+}
+
+OCAW_TEST(profile_longest_match)
+{
+    LaunchProfiles profiles(rules());
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\OpenCmdAnywhere\\build"), "vs-dev.exe");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\OpenCmdAnywhere\\build\\x64"), "vs-dev.exe");
+    OCAW_CHECK_EQ(match(profiles, L"D:\\repos\\archive"), "cmd.exe");
+    OCAW_CHECK_EQ(match(profiles, L"/home/user"), "bash");
+
+    // The order of the rules doesn't matter.
+    LaunchProfiles reversed({
+        { L"D:\\repos\\OpenCmdAnywhere", L"inner.exe", nullptr },
+        { L"D:\\repos", L"outer.exe", nullptr },
+    });
+    OCAW_CHECK_EQ(match(reversed, L"D:\\repos\\OpenCmdAnywhere\\src"), "inner.exe");
+    OCAW_CHECK_EQ(match(reversed, L"D:\\repos\\other"), "outer.exe");
+}
@@ -0,0 +1,48 @@
+// The minilog: the async mode enabled and disabled while other threads keep logging.
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <minilog.hpp>
+
+#include "test.h"
+
+static const int WRITER_COUNT = 4;
+
+OCAW_TEST(log_toggle_async_while_logging)
+{
+    const int messageCount = 20000;
+    std::ostringstream oss;
+    mlog::Logger logger("test", oss, mlog::OUT_WITH_NONE);
+
+    std::atomic<int> running{WRITER_COUNT};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < WRITER_COUNT; ++t)
+    {
+        writers.emplace_back([&]()
+        {
+            for (int i = 0; i < messageCount; ++i)
+                logger.log<mlog::LVL_WARNING>("message {}", i);
+            running--;
+        });
+    }
+
+    // A small queue, the producers also block on the full queue while the async mode is disabled.
+    while (running.load() > 0)
+    {
+        logger.enableAsync(64);
+        std::this_thread::yield();
+        logger.disableAsync();
+    }
+    for (auto& writer : writers)
+        writer.join();
+
+    // No message is lost, either queued and written by the disableAsync() or written synchronously.
+    auto output = oss.str();
+    OCAW_CHECK_EQ(static_cast<int>(std::count(output.begin(), output.end(), '\n')), WRITER_COUNT * messageCount);
+    OCAW_CHECK(!logger.isAsync());
+}
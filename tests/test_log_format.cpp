@@ -0,0 +1,121 @@
+// The single pass formatter of the minilog must produce the same text as the recursive stringstream formatter
+// it replaced, which is kept in the minilog_reference.h.
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <minilog.hpp>
+
+#include "minilog_reference.h"
+#include "test.h"
+
+// A type without the fast path, formatted by the operator<<.
+struct Point
+{
+    int x;
+    int y;
+};
+
+static std::ostream& operator<<(std::ostream& os, const Point& point)
+{
+    return os << '(' << point.x << ", " << point.y << ')';
+}
+
+#define CHECK_FORMAT(...) OCAW_CHECK_EQ(mlog::format(__VA_ARGS__), reference::format(__VA_ARGS__))
+
+OCAW_TEST(format_floating_point)
+{
+    CHECK_FORMAT("{}", 3.14159f);
+    CHECK_FORMAT("{}", 0.1);
+    CHECK_FORMAT("{}", 1.0 / 3.0);
+    CHECK_FORMAT("{}", 100.0);
+    CHECK_FORMAT("{}", 123456.0);
+    CHECK_FORMAT("{}", 1234567.0);
+    CHECK_FORMAT("{}", 1e20);
+    CHECK_FORMAT("{}", 1e-5);
+    CHECK_FORMAT("{}", 1e-7f);
+    CHECK_FORMAT("{}", -0.0);
+    CHECK_FORMAT("{}", 2.5L);
+    CHECK_FORMAT("{}", std::numeric_limits<double>::max());
+    CHECK_FORMAT("{}", std::numeric_limits<double>::denorm_min());
+    CHECK_FORMAT("{}", std::numeric_limits<double>::infinity());
+    CHECK_FORMAT("{}", -std::numeric_limits<float>::infinity());
+    CHECK_FORMAT("{}", std::numeric_limits<double>::quiet_NaN());
+    CHECK_FORMAT("elapsed {} ms, ratio {}", 12.75, 0.000123f);
+}
+
+OCAW_TEST(format_integer_width)
+{
+    CHECK_FORMAT("{}", static_cast<short>(-32768));
+    CHECK_FORMAT("{}", static_cast<unsigned short>(65535));
+    CHECK_FORMAT("{}", std::numeric_limits<int>::min());
+    CHECK_FORMAT("{}", std::numeric_limits<unsigned>::max());
+    CHECK_FORMAT("{}", std::numeric_limits<long>::min());
+    CHECK_FORMAT("{}", std::numeric_limits<long long>::min());
+    CHECK_FORMAT("{}", std::numeric_limits<unsigned long long>::max());
+    CHECK_FORMAT("{}", static_cast<size_t>(0));
+    // The character types are written as the characters.
+    CHECK_FORMAT("{}", static_cast<int8_t>('A'));
+    CHECK_FORMAT("{}", static_cast<uint8_t>('z'));
+    CHECK_FORMAT("{}", 'c');
+    CHECK_FORMAT("{} {}", true, false);
+}
+
+OCAW_TEST(format_escape)
+{
+    // The "{{}}" is written as the "{}" while the arguments remain, the rest is copied as is.
+    CHECK_FORMAT("{{}}", 1);
+    CHECK_FORMAT("{{}} {}", 1);
+    CHECK_FORMAT("{} {{}}", 1);
+    CHECK_FORMAT("{{}} {} {{}}", 1, 2);
+    CHECK_FORMAT("{{{}}}", 1);
+    CHECK_FORMAT("{{}", 1);
+    CHECK_FORMAT("{}}", 1);
+    CHECK_FORMAT("{{}}}", 1);
+    CHECK_FORMAT("{ }", 1);
+    CHECK_FORMAT("{", 1);
+    CHECK_FORMAT("}", 1);
+    CHECK_FORMAT("", 1);
+    CHECK_FORMAT("no placeholder", 1);
+    // More placeholders than the arguments, or more arguments than the placeholders.
+    CHECK_FORMAT("{} {} {}", 1, 2);
+    CHECK_FORMAT("{}", 1, 2, 3);
+    CHECK_FORMAT("{}{}", "a", std::string("b"));
+    CHECK_FORMAT("point {} at {}", Point{ 1, -2 }, "origin");
+}
+
+OCAW_TEST(format_random)
+{
+    // The format strings of the braces and the text, in particular shorter than the 4 characters window.
+    std::mt19937 rng(20261019);
+    const char alphabet[] = "{}{}{}ab ";
+    int mismatches = 0;
+    for (int n = 0; n < 20000; ++n)
+    {
+        std::string fmt(rng() % 12, ' ');
+        for (auto& ch : fmt)
+            ch = alphabet[rng() % (sizeof(alphabet) - 1)];
+
+        switch (n % 4)
+        {
+            case 0:
+                mismatches += mlog::format(fmt, 42) != reference::format(fmt, 42);
+                break;
+            case 1:
+                mismatches += mlog::format(fmt, 2.5, std::string("str")) != reference::format(fmt, 2.5, std::string("str"));
+                break;
+            case 2:
+                mismatches += mlog::format(fmt, 1.5f, 'c', -7LL) != reference::format(fmt, 1.5f, 'c', -7LL);
+                break;
+            default:
+                mismatches += mlog::format(fmt, true, "text", Point{ 3, 4 }, 9u) !=
+                    reference::format(fmt, true, "text", Point{ 3, 4 }, 9u);
+                break;
+        }
+    }
+    OCAW_CHECK_EQ(mismatches, 0);
+}
@@ -0,0 +1,215 @@
+// The rate limiter and the sampler of the minilog, driven by a fake clock.
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <minilog.hpp>
+
+#include "test.h"
+
+static std::atomic<long long> fakeNow{0};
+
+static long long fakeClock()
+{
+    return fakeNow.load();
+}
+
+// Replace the clock of the rate limiters during the test.
+class FakeClockGuard
+{
+public:
+    FakeClockGuard()
+    {
+        fakeNow = 0;
+        mlog::RateLimiter::setClock(&fakeClock);
+    }
+
+    ~FakeClockGuard() { mlog::RateLimiter::setClock(nullptr); }
+};
+
+// Write the messages of the global logger to a string during the test.
+class CaptureGuard
+{
+public:
+    CaptureGuard() { mlog::addOs("capture", oss_, mlog::OUT_WITH_NONE); }
+
+    ~CaptureGuard() { mlog::removeOs("capture"); }
+
+    std::string text() const { return oss_.str(); }
+
+private:
+    std::ostringstream oss_;
+};
+
+OCAW_TEST(rate_limiter_periods)
+{
+    FakeClockGuard clock;
+    mlog::RateLimiter limiter(3, 1000);
+    uint64_t suppressed = 0;
+
+    int allowed = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        allowed += limiter.tryAcquire(suppressed);
+        OCAW_CHECK_EQ(suppressed, static_cast<uint64_t>(0));
+    }
+    OCAW_CHECK_EQ(allowed, 3);
+
+    // Still in the first period.
+    fakeNow = 999;
+    OCAW_CHECK(!limiter.tryAcquire(suppressed));
+
+    // The first message of the next period reports the 3 suppressed ones.
+    fakeNow = 1000;
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    OCAW_CHECK_EQ(suppressed, static_cast<uint64_t>(3));
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    OCAW_CHECK(!limiter.tryAcquire(suppressed));
+
+    // A period starts at the first message over the limit after the previous one ended, the idle periods
+    // are skipped.
+    fakeNow = 5000;
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    OCAW_CHECK_EQ(suppressed, static_cast<uint64_t>(1));
+    fakeNow = 5999;
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    fakeNow = 6000;
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    OCAW_CHECK_EQ(suppressed, static_cast<uint64_t>(0));
+}
+
+OCAW_TEST(rate_limiter_concurrent)
+{
+    FakeClockGuard clock;
+    mlog::RateLimiter limiter(10, 1000);
+    const int threadCount = 4;
+    const int callCount = 1000;
+
+    std::atomic<int> allowed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            uint64_t suppressed = 0;
+            for (int i = 0; i < callCount; ++i)
+                allowed += limiter.tryAcquire(suppressed);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    OCAW_CHECK_EQ(allowed.load(), 10);
+
+    // Exactly one caller starts the next period and reports the suppressed messages, every message is either
+    // allowed or reported.
+    fakeNow = 1000;
+    std::atomic<uint64_t> reported{0};
+    std::atomic<int> starters{0};
+    allowed = 0;
+    threads.clear();
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            uint64_t suppressed = 0;
+            allowed += limiter.tryAcquire(suppressed);
+            if (suppressed != 0)
+            {
+                reported += suppressed;
+                starters++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    OCAW_CHECK_EQ(starters.load(), 1);
+    OCAW_CHECK_EQ(reported.load() + allowed.load(), static_cast<uint64_t>(threadCount * (callCount + 1) - 10));
+}
+
+OCAW_TEST(rate_limiter_take_suppressed)
+{
+    FakeClockGuard clock;
+    mlog::RateLimiter limiter(2, 1000);
+    uint64_t suppressed = 0;
+    for (int i = 0; i < 5; ++i)
+        limiter.tryAcquire(suppressed);
+
+    // Nothing is taken before the period ends.
+    fakeNow = 999;
+    OCAW_CHECK_EQ(limiter.takeSuppressed(), static_cast<uint64_t>(0));
+
+    // Taken once, the next message starts clean.
+    fakeNow = 1000;
+    OCAW_CHECK_EQ(limiter.takeSuppressed(), static_cast<uint64_t>(3));
+    OCAW_CHECK_EQ(limiter.takeSuppressed(), static_cast<uint64_t>(0));
+    OCAW_CHECK(limiter.tryAcquire(suppressed));
+    OCAW_CHECK_EQ(suppressed, static_cast<uint64_t>(0));
+
+    // The forced take doesn't wait for the period.
+    limiter.tryAcquire(suppressed);
+    limiter.tryAcquire(suppressed);
+    OCAW_CHECK_EQ(limiter.takeSuppressed(), static_cast<uint64_t>(0));
+    OCAW_CHECK_EQ(limiter.takeSuppressed(true), static_cast<uint64_t>(1));
+}
+
+OCAW_TEST(rate_limited_call_site)
+{
+    FakeClockGuard clock;
+    CaptureGuard capture;
+    auto logAll = [](int count)
+    {
+        for (int i = 0; i < count; ++i)
+            MLOG_RATE_LIMITED(mlog::LVL_WARNING, 2, 1000, "message {}", i);
+    };
+
+    logAll(10);
+    fakeNow = 1000;
+    logAll(1);
+    OCAW_CHECK_EQ(capture.text(),
+        "message 0\nmessage 1\nSuppressed 8 messages of the call site since the last report\nmessage 0\n");
+}
+
+OCAW_TEST(rate_limited_flush_reports)
+{
+    FakeClockGuard clock;
+    CaptureGuard capture;
+    int line = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        line = __LINE__ + 1;
+        MLOG_RATE_LIMITED(mlog::LVL_WARNING, 2, 1000, "message {}", i);
+    }
+
+    // The call site doesn't log again, the flush reports the summary once the period has ended.
+    mlog::flush();
+    fakeNow = 1000;
+    mlog::flush();
+    mlog::flush();
+    OCAW_CHECK_EQ(capture.text(), "message 0\nmessage 1\nSuppressed 3 messages of the call site " +
+        std::string(__FILE__) + ':' + std::to_string(line) + " since the last report\n");
+}
+
+OCAW_TEST(sampler_every_nth)
+{
+    mlog::Sampler sampler(3);
+    std::string pattern;
+    for (int i = 0; i < 7; ++i)
+        pattern += sampler.tryAcquire() ? 'x' : '.';
+    OCAW_CHECK_EQ(pattern, "x..x..x");
+
+    // The rate 0 is treated as 1, every message is allowed.
+    mlog::Sampler all(0);
+    OCAW_CHECK(all.tryAcquire() && all.tryAcquire());
+}
+
+OCAW_TEST(sampled_call_site)
+{
+    CaptureGuard capture;
+    for (int i = 0; i < 10; ++i)
+        MLOG_SAMPLED(mlog::LVL_WARNING, 4, "sample {}", i);
+    OCAW_CHECK_EQ(capture.text(), "sample 0\nsample 4\nsample 8\n");
+}
@@ -0,0 +1,82 @@
+// The memory-mapped log ring of the minilog survives the writer being killed: the committed records are read
+// back in order by the MappedRing::read(), as the mlog_ring tool does after a crash. POSIX only.
+
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <minilog_mapped.hpp>
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+// Small enough to wrap around many times before the writer is killed.
+static const size_t RING_CAPACITY = 4096;
+static const int RECORDS_BEFORE_KILL = 10000;
+
+static std::string recordText(int i)
+{
+    return "record " + std::to_string(i) + "\n";
+}
+
+// Append the records forever, tell the parent after the first RECORDS_BEFORE_KILL ones.
+[[noreturn]] static void runWriter(const std::string& filename, int notifyFd)
+{
+    mlog::MappedRing ring(filename, RING_CAPACITY);
+    for (int i = 0;; ++i)
+    {
+        auto text = recordText(i);
+        ring.append(text.data(), text.size());
+        if (i == RECORDS_BEFORE_KILL)
+        {
+            char ch = 1;
+            (void)!write(notifyFd, &ch, 1);
+        }
+    }
+}
+
+OCAW_TEST(mapped_ring_survives_killed_writer)
+{
+    auto dir = fs::temp_directory_path() / "ocaw_test_log_ring";
+    fs::create_directories(dir);
+    auto filename = (dir / "app.ring").string();
+    fs::remove(filename);
+
+    int fds[2];
+    OCAW_CHECK(pipe(fds) == 0);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        runWriter(filename, fds[1]);
+    }
+    close(fds[1]);
+
+    // Kill the writer in the middle of the stream, without any chance to flush or unmap.
+    char ch = 0;
+    OCAW_CHECK_EQ(read(fds[0], &ch, 1), static_cast<ssize_t>(1));
+    close(fds[0]);
+    kill(pid, SIGKILL);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    OCAW_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+    // The retained records are the newest ones, consecutive and in order; a record being written when the writer
+    // was killed is not committed and skipped.
+    auto records = mlog::MappedRing::read(filename);
+    OCAW_CHECK(records.size() > 100);
+    int first = -1;
+    if (!records.empty())
+        std::sscanf(records.front().c_str(), "record %d", &first);
+    OCAW_CHECK(first > 0);
+    int broken = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+        broken += records[i] != recordText(first + static_cast<int>(i));
+    OCAW_CHECK_EQ(broken, 0);
+    OCAW_CHECK(first + static_cast<int>(records.size()) > RECORDS_BEFORE_KILL);
+}
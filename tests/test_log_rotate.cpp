@@ -0,0 +1,158 @@
+// The rotating file stream of the minilog: the rotation by the size, and the flush policies in the sync and
+// async mode.
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <minilog.hpp>
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+// An empty directory of the test.
+static fs::path testDirectory(const std::string& name)
+{
+    auto dir = fs::temp_directory_path() / "ocaw_test_log_rotate" / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static std::string readFile(const fs::path& path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+static mlog::RotatingFileOptions flushOptions(mlog::FlushPolicy policy)
+{
+    mlog::RotatingFileOptions options;
+    options.flushPolicy = policy;
+    options.flushInterval = 50;
+    return options;
+}
+
+OCAW_TEST(rotate_by_size)
+{
+    auto file = testDirectory("size") / "app.log";
+    mlog::RotatingFileOptions options;
+    options.maxFileSize = 100;
+    options.maxFiles = 2;
+    options.flushPolicy = mlog::FLUSH_EVERY_MESSAGE;
+
+    std::string all;
+    {
+        mlog::Logger logger;
+        logger.addOs("file", file.string(), options, mlog::OUT_WITH_NONE);
+        for (int i = 0; i < 20; ++i)
+        {
+            // 20 bytes each, 5 messages per file.
+            auto message = "rotating message " + std::to_string(10 + i);
+            logger.log<mlog::LVL_INFO>(message);
+            all += message + "\n";
+        }
+    }
+
+    // Only the current file and the 2 newest rotated files are retained, in order and each within the size.
+    OCAW_CHECK(fs::exists(file.string() + ".1") && fs::exists(file.string() + ".2"));
+    OCAW_CHECK(!fs::exists(file.string() + ".3"));
+    auto retained = readFile(file.string() + ".2") + readFile(file.string() + ".1") + readFile(file);
+    OCAW_CHECK_EQ(retained, all.substr(all.size() - 15 * 20));
+    for (const auto& name : { file.string(), file.string() + ".1", file.string() + ".2" })
+        OCAW_CHECK_EQ(fs::file_size(name), static_cast<uintmax_t>(100));
+}
+
+OCAW_TEST(rotate_utf8_filename)
+{
+    // The file name is UTF-8, as the application passes QString::toStdString().
+    auto dir = testDirectory("utf8");
+    std::string filename = (dir / "app").u8string() + "\xe6\x97\xa5\xe5\xbf\x97.log";
+    mlog::RotatingFileOptions options;
+    options.maxFileSize = 20;
+    options.maxFiles = 1;
+    options.flushPolicy = mlog::FLUSH_EVERY_MESSAGE;
+    {
+        mlog::Logger logger;
+        logger.addOs("file", filename, options, mlog::OUT_WITH_NONE);
+        logger.log<mlog::LVL_INFO>("rotating message 10");
+        logger.log<mlog::LVL_INFO>("rotating message 11");
+    }
+
+    auto file = fs::u8path(filename);
+    OCAW_CHECK_EQ(readFile(file), "rotating message 11\n");
+    OCAW_CHECK_EQ(readFile(fs::u8path(filename + ".1")), "rotating message 10\n");
+}
+
+OCAW_TEST(flush_every_message)
+{
+    auto file = testDirectory("every") / "app.log";
+    mlog::Logger logger;
+    logger.addOs("file", file.string(), flushOptions(mlog::FLUSH_EVERY_MESSAGE), mlog::OUT_WITH_NONE);
+    logger.log<mlog::LVL_INFO>("info");
+    OCAW_CHECK_EQ(readFile(file), "info\n");
+}
+
+OCAW_TEST(flush_on_warning)
+{
+    auto file = testDirectory("warning") / "app.log";
+    mlog::Logger logger;
+    logger.addOs("file", file.string(), flushOptions(mlog::FLUSH_ON_WARNING), mlog::OUT_WITH_NONE);
+    logger.log<mlog::LVL_INFO>("info");
+    OCAW_CHECK_EQ(readFile(file), "");
+    logger.log<mlog::LVL_WARNING>("warning");
+    OCAW_CHECK_EQ(readFile(file), "info\nwarning\n");
+}
+
+OCAW_TEST(flush_on_full_buffer)
+{
+    auto file = testDirectory("full") / "app.log";
+    auto options = flushOptions(mlog::FLUSH_ON_WARNING);
+    options.bufferSize = 16;
+    mlog::Logger logger;
+    logger.addOs("file", file.string(), options, mlog::OUT_WITH_NONE);
+    logger.log<mlog::LVL_INFO>("0123456");
+    OCAW_CHECK_EQ(readFile(file), "");
+    logger.log<mlog::LVL_INFO>("0123456");
+    OCAW_CHECK_EQ(readFile(file), "0123456\n0123456\n");
+}
+
+OCAW_TEST(flush_interval_sync)
+{
+    // In the sync mode the elapsed interval is checked by the next message only.
+    auto file = testDirectory("interval_sync") / "app.log";
+    auto options = flushOptions(mlog::FLUSH_INTERVAL);
+    options.flushInterval = 200;
+    mlog::Logger logger;
+    logger.addOs("file", file.string(), options, mlog::OUT_WITH_NONE);
+    logger.log<mlog::LVL_INFO>("first");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    OCAW_CHECK_EQ(readFile(file), "");
+    logger.log<mlog::LVL_INFO>("second");
+    OCAW_CHECK_EQ(readFile(file), "first\nsecond\n");
+
+    logger.log<mlog::LVL_INFO>("third");
+    OCAW_CHECK_EQ(readFile(file), "first\nsecond\n");
+    logger.flush();
+    OCAW_CHECK_EQ(readFile(file), "first\nsecond\nthird\n");
+}
+
+OCAW_TEST(flush_interval_async)
+{
+    // In the async mode the background thread flushes the buffer after the interval without another message.
+    auto file = testDirectory("interval_async") / "app.log";
+    mlog::Logger logger;
+    logger.addOs("file", file.string(), flushOptions(mlog::FLUSH_INTERVAL), mlog::OUT_WITH_NONE);
+    logger.enableAsync();
+    logger.log<mlog::LVL_INFO>("first");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (readFile(file).empty() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    OCAW_CHECK_EQ(readFile(file), "first\n");
+    logger.disableAsync();
+}
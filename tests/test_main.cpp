@@ -0,0 +1,56 @@
+// Run the tests of the executable.
+//
+// Usage: <test executable> [filter]
+//   filter                 Run only the tests whose name contains the text.
+// The exit code is 1 if any check failed.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test.h"
+
+struct Test
+{
+    const char* name;
+    TestFunction function;
+};
+
+static std::vector<Test>& tests()
+{
+    static std::vector<Test> instance;
+    return instance;
+}
+
+static int failures = 0;
+
+void registerTest(const char* name, TestFunction function)
+{
+    tests().push_back({ name, function });
+}
+
+void failCheck(const char* file, int line, const std::string& message)
+{
+    ++failures;
+    std::printf("  %s:%d: check failed: %s\n", file, line, message.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+    int failedTests = 0, count = 0;
+    for (const auto& test : tests())
+    {
+        if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos)
+            continue;
+        int before = failures;
+        test.function();
+        bool passed = failures == before;
+        failedTests += !passed;
+        ++count;
+        std::printf("%s %s\n", passed ? "PASS" : "FAIL", test.name);
+        std::fflush(stdout);
+    }
+    std::printf("%d of %d tests passed\n", count - failedTests, count);
+    return failedTests == 0 ? 0 : 1;
+}
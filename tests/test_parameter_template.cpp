@@ -0,0 +1,130 @@
+// The expansion of the ParameterTemplate: the placeholders, the quoting of the directory by the rules of the
+// CommandLineToArgvW(), the {env:NAME} and %NAME% variables, and the passthrough of the other braces.
+
+#include <cstdlib>
+#include <string>
+
+#include "parameter_template.h"
+#include "trace_recorder.h"
+
+#include "test.h"
+
+// Compared in UTF-8, so the values are printed if a check failed.
+static std::string expand(const wchar_t* text, const wchar_t* directory, const wchar_t* exePath = L"")
+{
+    return trace::toUtf8(ParameterTemplate(text).expand({ directory, exePath }));
+}
+
+static std::string utf8(const wchar_t* text)
+{
+    return trace::toUtf8(text);
+}
+
+static void setVariable(const char* name, const char* value)
+{
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+// The variables are read when the template is compiled.
+static void setTestVariables()
+{
+    setVariable("OCAW_TEMPLATE_TEST", "{dir} 100%");
+    setVariable("OCAW_TEMPLATE_PATH", "C:\\Bin");
+    setVariable("OCAW_TEMPLATE_NESTED", "%OCAW_TEMPLATE_PATH%");
+}
+
+OCAW_TEST(template_without_placeholders)
+{
+    OCAW_CHECK_EQ(expand(L"", L"C:\\Work"), "");
+    OCAW_CHECK_EQ(expand(L"-NoExit", L"C:\\Work"), "-NoExit");
+    OCAW_CHECK_EQ(expand(L"-NoExit -Command \"& {Get-Location}\"", L"C:\\Work"),
+        "-NoExit -Command \"& {Get-Location}\"");
+}
+
+OCAW_TEST(template_brace_passthrough)
+{
+    OCAW_CHECK_EQ(expand(L"{dir", L"C:\\Work"), "{dir");
+    OCAW_CHECK_EQ(expand(L"{unknown} {} }{", L"C:\\Work"), "{unknown} {} }{");
+    OCAW_CHECK_EQ(expand(L"{env:}", L"C:\\Work"), "{env:}");
+    OCAW_CHECK_EQ(expand(L"{{dir}}", L"C:\\Work"), "{C:\\Work}");
+}
+
+OCAW_TEST(template_directory)
+{
+    OCAW_CHECK_EQ(expand(L"/k cd /d {dir}", L"C:\\Work"), "/k cd /d C:\\Work");
+    OCAW_CHECK_EQ(expand(L"{dir}{dir}", L"D:\\\u9879\u76EE"), utf8(L"D:\\\u9879\u76EE" L"D:\\\u9879\u76EE"));
+    OCAW_CHECK_EQ(expand(L"[{dir}]", L""), "[]");
+}
+
+OCAW_TEST(template_directory_quoted)
+{
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"C:\\Program Files"), "\"C:\\Program Files\"");
+    // The trailing backslashes are doubled before the closing quote.
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"C:\\"), "\"C:\\\\\"");
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"D:\\Work\\"), "\"D:\\Work\\\\\"");
+    // The quote is escaped, the backslashes before it are doubled.
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"a\"b"), "\"a\\\"b\"");
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"a\\\\\"b"), "\"a\\\\\\\\\\\"b\"");
+    // The other backslashes are unchanged.
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"\\\\server\\share"), "\"\\\\server\\share\"");
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L""), "\"\"");
+}
+
+OCAW_TEST(template_executable)
+{
+    OCAW_CHECK_EQ(expand(L"{exe} | {exe_dir}", L"C:\\Work", L"C:\\Windows\\System32\\cmd.exe"),
+        "C:\\Windows\\System32\\cmd.exe | C:\\Windows\\System32");
+    OCAW_CHECK_EQ(expand(L"{exe_dir}", L"C:\\Work", L"C:\\a.exe"), "C:\\");
+    OCAW_CHECK_EQ(expand(L"{exe_dir}", L"C:\\Work", L"/usr/bin/sh"), "/usr/bin");
+    OCAW_CHECK_EQ(expand(L"{exe_dir}", L"C:\\Work", L"/sh"), "/");
+    OCAW_CHECK_EQ(expand(L"{exe_dir}", L"C:\\Work", L"a.exe"), "");
+    OCAW_CHECK_EQ(expand(L"[{exe}|{exe_dir}]", L"C:\\Work", L""), "[|]");
+}
+
+OCAW_TEST(template_env_variables)
+{
+    setTestVariables();
+    // The value is not expanded again.
+    OCAW_CHECK_EQ(expand(L"-d {env:OCAW_TEMPLATE_TEST}", L"C:\\Work"), "-d {dir} 100%");
+    OCAW_CHECK_EQ(expand(L"-d {env:OCAW_TEMPLATE_MISSING}.", L"C:\\Work"), "-d .");
+    OCAW_CHECK_EQ(expand(L"{env:OCAW_TEMPLATE_NESTED}", L"C:\\Work"), "%OCAW_TEMPLATE_PATH%");
+}
+
+OCAW_TEST(template_percent_variables)
+{
+    setTestVariables();
+    OCAW_CHECK_EQ(expand(L"/k set P=%OCAW_TEMPLATE_PATH%", L"C:\\Work"), "/k set P=C:\\Bin");
+    OCAW_CHECK_EQ(expand(L"50% of %OCAW_TEMPLATE_PATH%", L"C:\\Work"), "50% of C:\\Bin");
+    // The undefined ones are unchanged.
+    OCAW_CHECK_EQ(expand(L"%OCAW_TEMPLATE_MISSING% 100%% done", L"C:\\Work"), "%OCAW_TEMPLATE_MISSING% 100%% done");
+    OCAW_CHECK_EQ(expand(L"{%OCAW_TEMPLATE_PATH%}", L"C:\\Work"), "{C:\\Bin}");
+    // Expanded before the placeholders, a name split by a placeholder is not a variable.
+    OCAW_CHECK_EQ(expand(L"%OCAW_TEMPLATE_{dir}PATH%", L"X"), "%OCAW_TEMPLATE_XPATH%");
+}
+
+OCAW_TEST(template_percent_in_values)
+{
+    setTestVariables();
+    // The % in the values of the placeholders is literal.
+    OCAW_CHECK_EQ(expand(L"/k cd /d {dir}", L"D:\\100%OCAW_TEMPLATE_PATH%x"), "/k cd /d D:\\100%OCAW_TEMPLATE_PATH%x");
+    OCAW_CHECK_EQ(expand(L"{dir_quoted}", L"D:\\50% %OCAW_TEMPLATE_PATH%"), "\"D:\\50% %OCAW_TEMPLATE_PATH%\"");
+    OCAW_CHECK_EQ(expand(L"%OCAW_TEMPLATE_PATH%\\{exe_dir}", L"C:\\Work", L"D:\\%OCAW_TEMPLATE_PATH%\\a.exe"),
+        "C:\\Bin\\D:\\%OCAW_TEMPLATE_PATH%");
+}
+
+OCAW_TEST(template_flags)
+{
+    setTestVariables();
+    ParameterTemplate unknown(L"-NoExit {unknown}");
+    OCAW_CHECK(!unknown.usesExe() && unknown.isContextFree());
+    ParameterTemplate env(L"{env:OCAW_TEMPLATE_TEST}");
+    OCAW_CHECK(!env.usesExe() && env.isContextFree());
+    ParameterTemplate quoted(L"{dir_quoted}");
+    OCAW_CHECK(!quoted.usesExe() && !quoted.isContextFree());
+    ParameterTemplate exeDir(L"{exe_dir}");
+    OCAW_CHECK(exeDir.usesExe() && !exeDir.isContextFree());
+}
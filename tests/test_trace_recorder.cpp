@@ -0,0 +1,72 @@
+// The trace file of the trace::Recorder is rotated at the size limit, each file is read back on its own, and the
+// UTF-8 file names are opened by both the writer and the reader.
+
+#include <filesystem>
+#include <string>
+
+#include "trace_recorder.h"
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+static fs::path testDirectory()
+{
+    auto dir = fs::temp_directory_path() / "ocaw_test_trace_recorder";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+// Read all records of the file, return the number of the records, -1 if the file is truncated.
+static int readAll(const std::string& filename, int& unresolved)
+{
+    trace::Reader reader(filename);
+    trace::Record record;
+    int count = 0;
+    while (reader.next(record))
+    {
+        ++count;
+        if (record.type == trace::RECORD_RESOLVE && (record.directory.empty() || record.className.empty()))
+            ++unresolved;
+    }
+    return reader.isTruncated() ? -1 : count;
+}
+
+OCAW_TEST(trace_rotate_at_size_limit)
+{
+    const uint64_t maxFileSize = 4096;
+    auto filename = (testDirectory() / "trace.bin").u8string();
+    trace::Recorder::open(filename, maxFileSize);
+    for (int i = 0; i < 2000; ++i)
+    {
+        // The new directories keep adding the string definitions.
+        trace::Recorder::recordResolve(i, L"CabinetWClass", trace::STRATEGY_EXPLORER,
+            L"C:\\Users\\Trace\\Directory " + std::to_wstring(i));
+        trace::Recorder::recordForeground(i % 7, 100, L"ConsoleWindowClass", []() { return L"C:\\Windows"; });
+    }
+    trace::Recorder::close();
+
+    // The current file and the previous one are kept, both within the limit and one record.
+    OCAW_CHECK(fs::exists(fs::u8path(filename + ".1")));
+    OCAW_CHECK(!fs::exists(fs::u8path(filename + ".2")));
+    OCAW_CHECK(fs::file_size(fs::u8path(filename)) < maxFileSize + 256);
+    OCAW_CHECK(fs::file_size(fs::u8path(filename + ".1")) < maxFileSize + 256);
+
+    // Each file defines the strings it uses.
+    int unresolved = 0;
+    OCAW_CHECK(readAll(filename, unresolved) > 0);
+    OCAW_CHECK(readAll(filename + ".1", unresolved) > 0);
+    OCAW_CHECK_EQ(unresolved, 0);
+}
+
+OCAW_TEST(trace_utf8_filename)
+{
+    auto filename = (testDirectory() / fs::u8path(u8"追踪 trace.bin")).u8string();
+    trace::Recorder::open(filename);
+    trace::Recorder::recordHotkey(true, false);
+    trace::Recorder::close();
+
+    int unresolved = 0;
+    OCAW_CHECK_EQ(readAll(filename, unresolved), 1);
+}
@@ -0,0 +1,156 @@
+// The EasyTranslate: the concurrent lookups and language switches, the reclamation of the retired snapshots,
+// and the concurrent Translation ID set.
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <easy_translate.hpp>
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+static const int READER_COUNT = 4;
+
+static fs::path testDirectory()
+{
+    auto dir = fs::temp_directory_path() / "ocaw_test_translate";
+    fs::create_directories(dir);
+    return dir;
+}
+
+static std::string writeFile(const std::string& filename, const std::string& content)
+{
+    auto path = (testDirectory() / filename).string();
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << content;
+    return path;
+}
+
+// Two languages, the ZH falls back to the EN for the "Only EN".
+static easytr::Languages writeLanguages()
+{
+    auto en = writeFile("en.json", R"({ "Hello": "Hello", "Only EN": "English only" })");
+    auto zh = writeFile("zh.json", R"({ "Hello": "你好", "Only EN": "" })");
+    easytr::Languages languages(std::map<std::string, std::string>{ { "EN", en }, { "ZH", zh } });
+    languages.setFallback("ZH", "EN");
+    return languages;
+}
+
+OCAW_TEST(translate_concurrent_language_switch)
+{
+    easytr::setLanguages(writeLanguages());
+    OCAW_CHECK(easytr::setCurrentLanguage("EN"));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> unexpected{0};
+    std::atomic<uint64_t> lookups{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < READER_COUNT; ++i)
+    {
+        readers.emplace_back([&]()
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                // Each result belongs to one of the published languages and stays valid after the switches.
+                const char* hello = EASYTR("Hello");
+                const char* onlyEn = EASYTR("Only EN");
+                const char* language = easytr::currentLanguage();
+                if ((std::strcmp(hello, "Hello") != 0 && std::strcmp(hello, "你好") != 0) ||
+                    std::strcmp(onlyEn, "English only") != 0 ||
+                    (std::strcmp(language, "EN") != 0 && std::strcmp(language, "ZH") != 0 && language[0] != '\0'))
+                    unexpected++;
+                if (easytr::languageCount() != 2 || !easytr::hasLanguage("ZH") || easytr::languages().empty())
+                    unexpected++;
+                lookups++;
+            }
+        });
+    }
+
+    // Switch the language and republish the languages while the readers run.
+    auto languages = writeLanguages();
+    for (int i = 0; i < 200; ++i)
+    {
+        if (i % 50 == 0)
+            easytr::setLanguages(languages);
+        OCAW_CHECK(easytr::setCurrentLanguage(i % 2 == 0 ? "ZH" : "EN"));
+    }
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    OCAW_CHECK_EQ(unexpected.load(), 0);
+    OCAW_CHECK(lookups.load() > 0);
+    OCAW_CHECK_EQ(std::string(easytr::currentLanguage()), "EN");
+}
+
+OCAW_TEST(translate_snapshots_reclaimed)
+{
+    easytr::setLanguages(writeLanguages());
+    OCAW_CHECK(easytr::setCurrentLanguage("EN"));
+    const char* hello = EASYTR("Hello");
+    const char* language = easytr::currentLanguage();
+
+    // Without the readers, each switch frees the retired snapshots, the texts stay in the pool.
+    for (int i = 0; i < 100; ++i)
+        OCAW_CHECK(easytr::setCurrentLanguage(i % 2 == 0 ? "ZH" : "EN"));
+    OCAW_CHECK_EQ(easytr::getTranslateManager().snapshotCount(), static_cast<size_t>(1));
+    OCAW_CHECK_EQ(std::string(hello), "Hello");
+    OCAW_CHECK_EQ(std::string(language), "EN");
+    OCAW_CHECK_EQ(std::string(EASYTR("Hello")), "Hello");
+}
+
+OCAW_TEST(translation_id_set_concurrent_insert)
+{
+    // More than the capacity of the lock-free table, the rest go to the overflow set.
+    const int idCount = static_cast<int>(easytr::TranslationIdSet::CAPACITY) * 2;
+    easytr::TranslationIdSet set;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < READER_COUNT; ++t)
+    {
+        // Each ID is inserted by two threads.
+        writers.emplace_back([&, t]()
+        {
+            int begin = t / 2 * idCount / 2;
+            for (int i = begin; i < begin + idCount / 2; ++i)
+                set.insert("App.Id." + std::to_string(i));
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+
+    OCAW_CHECK_EQ(set.count(), static_cast<size_t>(idCount));
+    int missing = 0;
+    for (int i = 0; i < idCount; ++i)
+        missing += !set.has("App.Id." + std::to_string(i));
+    OCAW_CHECK_EQ(missing, 0);
+    OCAW_CHECK(!set.has("App.Id.Missing"));
+}
+
+OCAW_TEST(languages_from_malformed_json)
+{
+    auto languages = easytr::Languages::fromJson(R"({
+        "EN": "en.json",
+        "ZH": { "file": "zh.json", "fallback": "EN" },
+        "FR": { "file": 1, "fallback": "EN" },
+        "DE": { "fallback": "EN" },
+        "JA": { "file": "ja.json", "fallback": ["EN"] },
+        "KO": 2,
+        "RU": null
+    })");
+    OCAW_CHECK_EQ(languages.count(), static_cast<size_t>(3));
+    OCAW_CHECK_EQ(std::string(languages.at("ZH")), "zh.json");
+    OCAW_CHECK_EQ(std::string(languages.fallback("ZH")), "EN");
+    OCAW_CHECK_EQ(std::string(languages.at("JA")), "ja.json");
+    OCAW_CHECK_EQ(std::string(languages.fallback("JA")), "");
+    OCAW_CHECK(!languages.has("FR") && !languages.has("DE") && !languages.has("KO") && !languages.has("RU"));
+
+    OCAW_CHECK(easytr::Languages::fromJson("[\"en.json\"]").empty());
+    OCAW_CHECK(easytr::Languages::fromJson("\"en.json\"").empty());
+    OCAW_CHECK(easytr::Languages::fromJson("{ invalid").empty());
+}
@@ -0,0 +1,103 @@
+// The update of the translations files of the EasyTranslate, which writes the merged JSON directly,
+// must be byte-identical to the nlohmann::json::dump(4) of the sorted merged object as it was written before.
+// Built with the EASY_TRANSLATE_UPDATE_TRANSLATIONS_FILES.
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+
+#include <easy_translate.hpp>
+#include <nlohmann/json.hpp>
+
+#include "test.h"
+
+namespace fs = std::filesystem;
+
+using Json = nlohmann::json;
+
+static fs::path testDirectory()
+{
+    auto dir = fs::temp_directory_path() / "ocaw_test_translate_update";
+    fs::create_directories(dir);
+    return dir;
+}
+
+static std::string readFile(const std::string& filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << content;
+}
+
+// The output of the previous implementation: the existing string text or empty of each ID, dumped by the nlohmann.
+static std::string expectedContent(const std::string& original, bool exists, const std::set<std::string>& tranIds)
+{
+    Json j = exists ? Json::parse(original, nullptr, false, true) : Json();
+    std::map<std::string, std::string> map;
+    for (const auto& tranId : tranIds)
+    {
+        bool hasText = j.is_object() && j.contains(tranId) && j[tranId].is_string();
+        map.insert({ tranId, hasText ? j[tranId].get<std::string>() : "" });
+    }
+    Json out;
+    for (const auto& var : map)
+        out[var.first] = var.second;
+    return out.dump(4);
+}
+
+OCAW_TEST(update_translations_files_match_json_dump)
+{
+    auto dir = testDirectory();
+    auto a = (dir / "a.json").string();
+    auto b = (dir / "b.json").string();
+    auto c = (dir / "c.json").string();
+    auto d = (dir / "d.json").string();
+    fs::remove(b);
+
+    // The escapes of the keys and the texts: the quote, the backslash, the short escapes, the other control
+    // characters, the slash and the DEL which are not escaped, and the UTF-8 text which is written as it is.
+    Json original = {
+        { "App.Title", "Open \"CMD\" Anywhere" },
+        { "Path\\Sep", "C:\\Windows\\System32" },
+        { "Control", std::string("\b\f\n\r\t\x01\x1f\x7f", 8) },
+        { "Slash/Key", "a/b" },
+        { "Unicode", "你好 \xF0\x9F\x98\x80" },
+        { "Empty", "" }
+    };
+    auto aContent = original.dump(2);
+    writeFile(a, aContent);
+    // The text which is not a string is written as empty.
+    auto cContent = R"({ "App.Title": 42, "Unicode": null, "Removed": "x" })";
+    writeFile(c, cContent);
+    writeFile(d, "{ invalid json");
+
+    easytr::setLanguages(easytr::Languages(
+        std::map<std::string, std::string>{ { "A", a }, { "B", b }, { "C", c }, { "D", d } }));
+    OCAW_CHECK(easytr::setCurrentLanguage("A"));
+
+    std::set<std::string> tranIds;
+    for (const auto& var : original.items())
+        tranIds.insert(var.key());
+    for (const char* tranId : { "New \"Quoted\" ID", "New\tTab\x02", "新的", "App.Title", "" })
+    {
+        EASYTR(tranId);
+        tranIds.insert(tranId);
+    }
+
+    OCAW_CHECK_EQ(easytr::updateTranslationsFiles(), static_cast<size_t>(4));
+    OCAW_CHECK_EQ(readFile(a), expectedContent(aContent, true, tranIds));
+    OCAW_CHECK_EQ(readFile(b), expectedContent("", false, tranIds));
+    OCAW_CHECK_EQ(readFile(c), expectedContent(cContent, true, tranIds));
+    OCAW_CHECK_EQ(readFile(d), expectedContent("{ invalid json", true, tranIds));
+
+    // The unchanged files are not written again.
+    OCAW_CHECK_EQ(easytr::updateTranslationsFiles(), static_cast<size_t>(0));
+}
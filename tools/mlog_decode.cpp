@@ -0,0 +1,87 @@
+// Decode the binary log written by the MLOG_BINARY to the text log of the MiniLog.
+//
+// Usage: mlog_decode <binary log> [text log] [--precision s|ms|us]
+// The text log is written to the standard output if not specified.
+
+#include <cstring>
+#include <iostream>
+
+#include <minilog_binary.hpp>
+
+static int usage()
+{
+    std::cerr << "Usage: mlog_decode <binary log> [text log] [--precision s|ms|us]" << std::endl;
+    return 2;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* input = nullptr;
+    const char* output = nullptr;
+    mlog::TimestampPrecision precision = mlog::TIMESTAMP_MICROSECOND;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--precision") == 0 && i + 1 < argc)
+        {
+            const char* value = argv[++i];
+            if (std::strcmp(value, "s") == 0)
+                precision = mlog::TIMESTAMP_SECOND;
+            else if (std::strcmp(value, "ms") == 0)
+                precision = mlog::TIMESTAMP_MILLISECOND;
+            else if (std::strcmp(value, "us") == 0)
+                precision = mlog::TIMESTAMP_MICROSECOND;
+            else
+                return usage();
+        }
+        else if (!input)
+        {
+            input = argv[i];
+        }
+        else if (!output)
+        {
+            output = argv[i];
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (!input)
+        return usage();
+
+    try
+    {
+        mlog::bin::BinaryReader reader(input);
+
+        // Same as the text log which written to the file, i.e. without the color.
+        mlog::Logger logger;
+        if (output)
+            logger.addOs("Output", output, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+        else
+            logger.addOs("Output", std::cout, mlog::OUT_WITH_LEVEL | mlog::OUT_WITH_TIMESTAMP);
+        logger.setTimestampPrecision(precision);
+
+        size_t count = 0;
+        mlog::bin::BinaryReader::Record record;
+        while (reader.next(record))
+        {
+            logger.logAt(record.level, record.time, record.message);
+            ++count;
+        }
+        logger.flush();
+
+        if (reader.isCorrupted())
+        {
+            std::cerr << "The binary log is truncated or corrupted after " << count << " events" << std::endl;
+            return 1;
+        }
+    } catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
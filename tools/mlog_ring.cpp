@@ -0,0 +1,43 @@
+// Reconstruct the text log from the memory-mapped log ring written by the mlog::MappedRing,
+// e.g. after the process crashed.
+//
+// Usage: mlog_ring <log ring> [text log]
+// The text log is written to the standard output if not specified.
+
+#include <fstream>
+#include <iostream>
+
+#include <minilog_mapped.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: mlog_ring <log ring> [text log]" << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        auto records = mlog::MappedRing::read(argv[1]);
+
+        std::ofstream ofs;
+        if (argc == 3)
+        {
+            ofs.open(argv[2], std::ios_base::binary);
+            if (!ofs.is_open())
+                throw std::runtime_error(std::string("Failed to open the file: ") + argv[2]);
+        }
+        std::ostream& os = argc == 3 ? ofs : std::cout;
+
+        for (const auto& record : records)
+            os << record;
+        os.flush();
+    } catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
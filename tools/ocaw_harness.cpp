@@ -0,0 +1,180 @@
+// Drive the hotkey trigger, resolve and launch path of the OpenCmdAnywhere by the scripted trigger sequences,
+// with the fake hotkey backend and the fake resolve and launch steps, no real key press or display is required.
+//
+// Usage: ocaw_harness [options]
+//   --scenario <name>      burst, held, interleaved or all (default: all).
+//   --count <n>            The number of the triggers of each scenario (default: 1000).
+//   --interval-us <us>     The interval between the triggers of the held and interleaved scenarios (default: 1000).
+//   --resolve-us <us>      The time taken by the fake resolve step (default: 200).
+//   --launch-us <us>       The time taken by the fake launch step (default: 2000).
+//   --no-coalescing        Start a worker for every trigger, even if the previous one is not finished.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hotkey_backend.h"
+#include "launch_pipeline.h"
+#include "latency.h"
+
+static const char* USER_HOTKEY  = "Ctrl+Alt+T";
+static const char* ADMIN_HOTKEY = "Ctrl+Alt+Shift+T";
+
+struct Options
+{
+    std::string scenario    = "all";
+    int count               = 1000;
+    int intervalUs          = 1000;
+    int resolveUs           = 200;
+    int launchUs            = 2000;
+    bool coalescing         = true;
+};
+
+static void printUsage()
+{
+    std::fprintf(stderr,
+        "Usage: ocaw_harness [--scenario burst|held|interleaved|all] [--count n] [--interval-us us]\n"
+        "                    [--resolve-us us] [--launch-us us] [--no-coalescing]\n");
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scenario" && hasValue)
+            options.scenario = argv[++i];
+        else if (arg == "--count" && hasValue)
+            options.count = std::atoi(argv[++i]);
+        else if (arg == "--interval-us" && hasValue)
+            options.intervalUs = std::atoi(argv[++i]);
+        else if (arg == "--resolve-us" && hasValue)
+            options.resolveUs = std::atoi(argv[++i]);
+        else if (arg == "--launch-us" && hasValue)
+            options.launchUs = std::atoi(argv[++i]);
+        else if (arg == "--no-coalescing")
+            options.coalescing = false;
+        else
+            return false;
+    }
+    return options.count > 0 && options.intervalUs >= 0 && options.resolveUs >= 0 && options.launchUs >= 0;
+}
+
+// Return false if the scenario name is unknown.
+static bool runScenario(const std::string& name, const Options& options)
+{
+    // The trigger sequence, true means the admin hotkey.
+    std::vector<bool> sequence;
+    int intervalUs = 0;
+    if (name == "burst")
+    {
+        // All triggers arrive at once, e.g. the key events are delivered late.
+        sequence.assign(options.count, false);
+    }
+    else if (name == "held")
+    {
+        // The auto repeat of a held hotkey.
+        sequence.assign(options.count, false);
+        intervalUs = options.intervalUs;
+    }
+    else if (name == "interleaved")
+    {
+        for (int i = 0; i < options.count; ++i)
+            sequence.push_back(i % 2 != 0);
+        intervalUs = options.intervalUs;
+    }
+    else
+    {
+        return false;
+    }
+
+    auto resolveTime = std::chrono::microseconds(options.resolveUs);
+    auto launchTime = std::chrono::microseconds(options.launchUs);
+    LaunchPipeline pipeline(
+        []() { return LaunchPipeline::Config{ L"cmd.exe", nullptr, nullptr }; },
+        [=](std::wstring*)
+        {
+            std::this_thread::sleep_for(resolveTime);
+            return std::wstring(L"C:\\Users\\Harness");
+        },
+        [=](const std::wstring&, const std::wstring&, const std::wstring&, bool, bool)
+        {
+            std::this_thread::sleep_for(launchTime);
+            return true;
+        }
+    );
+    pipeline.setCoalescing(options.coalescing);
+
+    // The hotkeys are registered as the HotkeyHandler does.
+    FakeHotkeyBackend backend;
+    backend.initialize();
+    backend.add(USER_HOTKEY, [&]() { pipeline.trigger(false); });
+    backend.add(ADMIN_HOTKEY, [&]() { pipeline.trigger(true); });
+
+    LatencyStats::reset();
+    // The time spent in the hotkey callbacks, which blocks the hotkey thread of the gbhk.
+    std::chrono::steady_clock::duration callbackTime{};
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    for (bool isAdmin : sequence)
+    {
+        if (intervalUs > 0)
+        {
+            next += std::chrono::microseconds(intervalUs);
+            std::this_thread::sleep_until(next);
+        }
+        auto callbackStart = std::chrono::steady_clock::now();
+        backend.trigger(isAdmin ? ADMIN_HOTKEY : USER_HOTKEY);
+        callbackTime += std::chrono::steady_clock::now() - callbackStart;
+    }
+    pipeline.waitIdle();
+    auto end = std::chrono::steady_clock::now();
+    backend.uninitialize();
+
+    auto stats = pipeline.stats();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double callbackUs = std::chrono::duration<double, std::micro>(callbackTime).count();
+
+    std::printf("== %s (%d triggers, interval %d us, coalescing %s)\n",
+        name.c_str(), options.count, intervalUs, options.coalescing ? "on" : "off");
+    std::printf("  triggered %llu, coalesced %llu, launched %llu, failed %llu\n",
+        static_cast<unsigned long long>(stats.triggered), static_cast<unsigned long long>(stats.coalesced),
+        static_cast<unsigned long long>(stats.launched), static_cast<unsigned long long>(stats.failed));
+    std::printf("  peak worker threads %llu\n", static_cast<unsigned long long>(stats.peakWorkers));
+    std::printf("  callback cost %.2f us/trigger, throughput %.1f launches/s over %.3f s\n",
+        callbackUs / sequence.size(), stats.launched / seconds, seconds);
+    std::printf("%s", LatencyStats::report().c_str());
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<std::string> scenarios;
+    if (options.scenario == "all")
+        scenarios = { "burst", "held", "interleaved" };
+    else
+        scenarios = { options.scenario };
+
+    for (const auto& scenario : scenarios)
+    {
+        if (!runScenario(scenario, options))
+        {
+            std::fprintf(stderr, "Unknown scenario: %s\n", scenario.c_str());
+            printUsage();
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,386 @@
+// Run the lifecycle scenarios of the standby pool with the real processes: the standby instances are spawned by the
+// posix_spawn, and the child program is a shell which reads the directory from the stdin, changes to it,
+// writes its working directory to a file and exits.
+// The exit code is 1 if any check of the scenarios failed.
+//
+// Usage: ocaw_pool [options]
+//   --scenario <name>      Run only the specified scenario (default: all).
+//   --list                 List the scenarios.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "launcher.h"
+#include "standby_pool.h"
+#include "trace_recorder.h"
+
+namespace fs = std::filesystem;
+using std::chrono::milliseconds;
+using Clock = std::chrono::steady_clock;
+
+static const milliseconds READY_TIMEOUT(5000);
+
+// The working directories and the output file of the child program.
+class Sandbox
+{
+public:
+    Sandbox() : root_(fs::temp_directory_path() / ("ocaw_pool_" + std::to_string(getpid())))
+    {
+        fs::create_directories(root_);
+    }
+
+    ~Sandbox()
+    {
+        std::error_code ec;
+        fs::remove_all(root_, ec);
+    }
+
+    // The directory with a space in the name, which has to survive the standby shell.
+    std::wstring directory(int index) const
+    {
+        auto path = root_ / ("work dir " + std::to_string(index));
+        fs::create_directories(path);
+        return path.wstring();
+    }
+
+    std::wstring output() const { return (root_ / "pwd.txt").wstring(); }
+
+    // The parameter of the "sh" of the standby instance, which reads the directory from the stdin.
+    std::wstring parameter() const
+    {
+        return L"-c \"IFS= read -r dir && cd \\\"$dir\\\" && pwd > \\\"$0\\\"\" \"" + output() + L"\"";
+    }
+
+    // The parameter of the "sh" of the cold spawn, which is started in the directory.
+    std::wstring coldParameter() const { return L"-c \"pwd > \\\"$0\\\"\" \"" + output() + L"\""; }
+
+    void clearOutput() const
+    {
+        std::error_code ec;
+        fs::remove(root_ / "pwd.txt", ec);
+    }
+
+    // Wait for the child program to write the output file, return the written directory or empty if timed out.
+    std::wstring waitOutput(milliseconds timeout) const
+    {
+        auto deadline = Clock::now() + timeout;
+        while (Clock::now() < deadline)
+        {
+            std::ifstream ifs(root_ / "pwd.txt");
+            std::string line;
+            if (std::getline(ifs, line) && ifs.good())
+                return trace::fromUtf8(line);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return L"";
+    }
+
+private:
+    fs::path root_;
+};
+
+// The child processes of this process which are not exited.
+static std::vector<pid_t> liveChildren()
+{
+    std::vector<pid_t> children;
+    DIR* dir = opendir("/proc");
+    if (!dir)
+        return children;
+    while (auto* entry = readdir(dir))
+    {
+        pid_t pid = std::atoi(entry->d_name);
+        if (pid <= 0)
+            continue;
+        std::ifstream ifs("/proc/" + std::to_string(pid) + "/stat");
+        std::string stat;
+        std::getline(ifs, stat);
+        // The fields after the command name: state ppid ...
+        auto pos = stat.rfind(')');
+        if (pos == std::string::npos)
+            continue;
+        char state = 0;
+        int ppid = 0;
+        if (std::sscanf(stat.c_str() + pos + 1, " %c %d", &state, &ppid) == 2 && ppid == getpid() && state != 'Z')
+            children.push_back(pid);
+    }
+    closedir(dir);
+    return children;
+}
+
+struct Context
+{
+    Sandbox sandbox;
+    int failed = 0;
+
+    void check(bool ok, const std::string& message)
+    {
+        std::printf("  %s %s\n", ok ? "PASS" : "FAIL", message.c_str());
+        if (!ok)
+            ++failed;
+    }
+};
+
+static StandbyPool::Options options(size_t size, milliseconds idleExpiry = std::chrono::minutes(10),
+                                    uint64_t memoryLimit = 0)
+{
+    StandbyPool::Options options;
+    options.size = size;
+    options.idleExpiry = idleExpiry;
+    options.memoryLimit = memoryLimit;
+    return options;
+}
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0 : values[values.size() / 2];
+}
+
+struct Scenario
+{
+    const char* name;
+    const char* description;
+    std::function<void(Context&)> script;
+};
+
+static std::vector<Scenario> scenarios()
+{
+    return {
+        {
+            "activate",
+            "Open in the different directories by the standby instances and by the cold spawn, compare the latency.",
+            [](Context& ctx)
+            {
+                const int count = 20;
+                auto parameter = ctx.sandbox.parameter();
+                std::vector<double> warm, cold;
+                int wrongDirectories = 0;
+                {
+                    StandbyPool pool;
+                    pool.setExecutable(L"sh", parameter);
+                    pool.setOptions(options(2));
+                    for (int i = 0; i < count; ++i)
+                    {
+                        // The presses are apart, the replenished instance has finished its startup.
+                        pool.waitReady(READY_TIMEOUT);
+                        std::this_thread::sleep_for(milliseconds(20));
+                        ctx.sandbox.clearOutput();
+                        auto start = Clock::now();
+                        if (!pool.acquire(L"sh", parameter, ctx.sandbox.directory(i)))
+                            continue;
+                        auto written = ctx.sandbox.waitOutput(READY_TIMEOUT);
+                        warm.push_back(elapsedMs(start));
+                        wrongDirectories += written != ctx.sandbox.directory(i);
+                    }
+
+                    auto stats = pool.stats();
+                    ctx.check(stats.hits == count && stats.misses == 0,
+                        "hits " + std::to_string(stats.hits) + ", misses " + std::to_string(stats.misses));
+                    ctx.check(pool.waitReady(READY_TIMEOUT) && pool.stats().ready == 2, "replenished to 2 instances");
+                }
+                ctx.check(wrongDirectories == 0, "wrong directories " + std::to_string(wrongDirectories));
+
+                SpawnLauncher launcher;
+                for (int i = 0; i < count; ++i)
+                {
+                    std::this_thread::sleep_for(milliseconds(20));
+                    ctx.sandbox.clearOutput();
+                    auto start = Clock::now();
+                    ProcessLauncher::Process process;
+                    if (!launcher.launch(L"sh", ctx.sandbox.directory(i), ctx.sandbox.coldParameter(), false, &process))
+                        continue;
+                    ctx.sandbox.waitOutput(READY_TIMEOUT);
+                    cold.push_back(elapsedMs(start));
+                    ProcessLauncher::waitProcess(process);
+                }
+                std::printf("  median open latency: standby %.3f ms, cold spawn %.3f ms\n", median(warm), median(cold));
+                ctx.check(median(warm) <= median(cold), "standby is not slower than the cold spawn");
+            }
+        },
+        {
+            "idle_expiry",
+            "The idle instances are replaced after the expiry.",
+            [](Context& ctx)
+            {
+                StandbyPool pool;
+                pool.setExecutable(L"sh", ctx.sandbox.parameter());
+                pool.setOptions(options(1, milliseconds(100)));
+                std::this_thread::sleep_for(milliseconds(550));
+                pool.waitReady(READY_TIMEOUT);
+                auto stats = pool.stats();
+                ctx.check(stats.expired >= 3, "expired " + std::to_string(stats.expired));
+                ctx.check(stats.spawned == stats.expired + 1 && stats.ready == 1,
+                    "spawned " + std::to_string(stats.spawned) + ", ready " + std::to_string(stats.ready));
+                ctx.check(liveChildren().size() == 1, "live children " + std::to_string(liveChildren().size()));
+            }
+        },
+        {
+            "memory_limit",
+            "The instances beyond the memory limit are terminated and not respawned.",
+            [](Context& ctx)
+            {
+                auto parameter = ctx.sandbox.parameter();
+                StandbyPool pool;
+                pool.setExecutable(L"sh", parameter);
+                pool.setOptions(options(3));
+                pool.waitReady(READY_TIMEOUT);
+                uint64_t perInstance = pool.stats().memory / 3;
+                std::printf("  memory of 3 instances %.1f KB\n", pool.stats().memory / 1024.0);
+
+                // Room for one instance and a half.
+                pool.setOptions(options(3, std::chrono::minutes(10), perInstance * 3 / 2));
+                pool.waitReady(READY_TIMEOUT);
+                std::this_thread::sleep_for(milliseconds(1200));
+                auto stats = pool.stats();
+                ctx.check(stats.ready == 1 && stats.overBudget >= 1,
+                    "ready " + std::to_string(stats.ready) + ", over budget " + std::to_string(stats.overBudget));
+
+                pool.setOptions(options(3, std::chrono::minutes(10), 1));
+                pool.waitReady(READY_TIMEOUT);
+                ctx.check(pool.stats().ready == 0, "no instance fits the limit of 1 byte");
+                ctx.check(!pool.acquire(L"sh", parameter, ctx.sandbox.directory(0)), "acquire falls back to the launch");
+            }
+        },
+        {
+            "reconfigure",
+            "Changing the executable or the parameter terminates the old instances and spawns the new ones.",
+            [](Context& ctx)
+            {
+                StandbyPool pool;
+                pool.setExecutable(L"sh", L"-c \"exit 1\"");
+                pool.setOptions(options(2));
+                pool.waitReady(READY_TIMEOUT);
+                auto oldChildren = liveChildren();
+
+                // The acquire with the new parameter misses once, then the pool follows it.
+                auto parameter = ctx.sandbox.parameter();
+                ctx.check(!pool.acquire(L"sh", parameter, ctx.sandbox.directory(0)), "the first acquire misses");
+                pool.waitReady(READY_TIMEOUT);
+                auto newChildren = liveChildren();
+                bool replaced = newChildren.size() == 2;
+                for (auto pid : oldChildren)
+                    replaced = replaced && std::find(newChildren.begin(), newChildren.end(), pid) == newChildren.end();
+                ctx.check(replaced, "the old instances are replaced");
+
+                ctx.sandbox.clearOutput();
+                ctx.check(pool.acquire(L"sh", parameter, ctx.sandbox.directory(1)) &&
+                    ctx.sandbox.waitOutput(READY_TIMEOUT) == ctx.sandbox.directory(1), "the next acquire hits");
+            }
+        },
+        {
+            "instance_died",
+            "A standby instance killed from outside is detected and replaced.",
+            [](Context& ctx)
+            {
+                StandbyPool pool;
+                pool.setExecutable(L"sh", ctx.sandbox.parameter());
+                pool.setOptions(options(2));
+                pool.waitReady(READY_TIMEOUT);
+                auto children = liveChildren();
+                for (auto pid : children)
+                    kill(pid, SIGKILL);
+                std::this_thread::sleep_for(milliseconds(50));
+
+                // Detected either by the periodic check or by the acquire, which misses unless the check has replaced them.
+                pool.acquire(L"sh", ctx.sandbox.parameter(), ctx.sandbox.directory(0));
+                auto stats = pool.stats();
+                ctx.check(stats.died == children.size(), "died " + std::to_string(stats.died));
+                ctx.check(pool.waitReady(READY_TIMEOUT) && pool.stats().ready == 2, "replenished to 2 instances");
+            }
+        },
+        {
+            "unsupported",
+            "The executable which can not stand by disables the pool without spawning.",
+            [](Context& ctx)
+            {
+                StandbyPool pool([](const std::wstring&, const std::wstring&) { return nullptr; });
+                pool.setExecutable(L"sh", ctx.sandbox.parameter());
+                pool.setOptions(options(2));
+                ctx.check(pool.waitReady(READY_TIMEOUT) && pool.stats().spawned == 0, "nothing spawned");
+                ctx.check(!pool.acquire(L"sh", ctx.sandbox.parameter(), ctx.sandbox.directory(0)), "acquire misses");
+            }
+        },
+        {
+            "shutdown",
+            "Disabling or destroying the pool terminates all standby instances.",
+            [](Context& ctx)
+            {
+                {
+                    StandbyPool pool;
+                    pool.setExecutable(L"sh", ctx.sandbox.parameter());
+                    pool.setOptions(options(3));
+                    pool.waitReady(READY_TIMEOUT);
+                    ctx.check(liveChildren().size() == 3, "3 instances before disabling");
+                    pool.setOptions(options(0));
+                    ctx.check(liveChildren().empty(), "no instance after disabling");
+                    pool.setOptions(options(3));
+                    pool.waitReady(READY_TIMEOUT);
+                }
+                ctx.check(liveChildren().empty(), "no instance after destroying");
+            }
+        }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    std::string only;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--scenario" && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (arg == "--list")
+        {
+            for (const auto& scenario : scenarios())
+                std::printf("%-20s %s\n", scenario.name, scenario.description);
+            return 0;
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: ocaw_pool [--scenario name] [--list]\n");
+            return 2;
+        }
+    }
+
+    int runCount = 0;
+    int failedCount = 0;
+    for (const auto& scenario : scenarios())
+    {
+        if (!only.empty() && only != scenario.name)
+            continue;
+        ++runCount;
+        std::printf("== %s\n  %s\n", scenario.name, scenario.description);
+        Context ctx;
+        scenario.script(ctx);
+        if (ctx.failed > 0)
+            ++failedCount;
+    }
+
+    if (runCount == 0)
+    {
+        std::fprintf(stderr, "Unknown scenario: %s\n", only.c_str());
+        return 2;
+    }
+
+    std::printf("%d of %d scenarios passed\n", runCount - failedCount, runCount);
+    return failedCount == 0 ? 0 : 1;
+}
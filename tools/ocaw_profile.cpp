@@ -0,0 +1,44 @@
+// Match directories against the launch profile rules of the OpenCmdAnywhere (the LaunchProfiles setting),
+// the matching rules are tested by the tests/test_launch_profile.cpp.
+//
+// Usage: ocaw_profile --rule <directory> <executable> [--rule ...] <directory>...
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "launch_profile.h"
+#include "trace_recorder.h"
+
+int main(int argc, char* argv[])
+{
+    std::vector<LaunchProfile> profiles;
+    std::vector<std::wstring> directories;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--rule" && i + 2 < argc)
+        {
+            profiles.push_back({ trace::fromUtf8(argv[i + 1]), trace::fromUtf8(argv[i + 2]), nullptr });
+            i += 2;
+        }
+        else if (arg.rfind("--", 0) != 0)
+            directories.push_back(trace::fromUtf8(arg));
+        else
+            directories.clear();
+    }
+    if (profiles.empty() || directories.empty())
+    {
+        std::fprintf(stderr, "Usage: ocaw_profile --rule <directory> <executable> [--rule ...] <directory>...\n");
+        return 2;
+    }
+
+    LaunchProfiles launchProfiles(std::move(profiles));
+    for (const auto& directory : directories)
+    {
+        const LaunchProfile* profile = launchProfiles.match(directory);
+        std::printf("%s => %s\n", trace::toUtf8(directory).c_str(),
+            profile ? trace::toUtf8(profile->executable).c_str() : "(none)");
+    }
+    return 0;
+}
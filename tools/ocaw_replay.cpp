@@ -0,0 +1,294 @@
+// Replay the focus and hotkey trace recorded by the OpenCmdAnywhere (the TraceFile setting) through the resolver
+// and the executable directory cache, to benchmark them with the real window switching patterns.
+// The window system is replaced by the recorded answers, so the replay runs on any platform.
+//
+// Usage: ocaw_replay <trace file> [options]
+//   --cache-size <n>       The capacity of the executable directory cache, 0 disables the cache (default: 64).
+//   --repeat <n>           Replay the resolves n times to time them, the cache is cleared each time (default: 1).
+//   --dump                 Print the records and exit.
+// The exit code is 1 if any resolved directory differs from the recorded one.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "latency.h"
+#include "resolver.h"
+#include "trace_recorder.h"
+
+// The resolve as recorded, with the window state at that moment.
+struct Resolve
+{
+    WindowSystem::Window window;
+    uint32_t processId;
+    std::wstring className;
+    trace::Strategy strategy;
+    std::wstring directory;
+    // The executable directory of the window process recorded by the foreground change, may be unknown.
+    std::wstring exeDirectory;
+};
+
+// Answer the queries of the resolver with the recorded state of the current resolve.
+class ReplayWindowSystem : public WindowSystem
+{
+public:
+    void setCurrent(const Resolve* resolve) { current_ = resolve; }
+
+    uint64_t exeDirectoryQueries() const { return exeDirectoryQueries_; }
+
+    Window foregroundWindow() override { return current_->window; }
+
+    std::wstring windowClassName(Window) override { return current_->className; }
+
+    uint32_t windowProcessId(Window) override { return current_->processId; }
+
+    // The path is not recorded, only the executable directory is replayed.
+    std::wstring windowExePath(Window) override { return L""; }
+
+    std::wstring windowExeDirectory(Window) override
+    {
+        ++exeDirectoryQueries_;
+        if (current_->strategy == trace::STRATEGY_EXECUTABLE)
+            return current_->directory;
+        return current_->exeDirectory;
+    }
+
+    std::wstring desktopDirectory() override { return current_->directory; }
+
+    std::wstring explorerDirectory(Window) override
+    {
+        // The explorer which was browsing a non-filesystem view fell back to the executable directory.
+        return current_->strategy == trace::STRATEGY_EXPLORER ? current_->directory : std::wstring();
+    }
+
+private:
+    const Resolve* current_ = nullptr;
+    uint64_t exeDirectoryQueries_ = 0;
+};
+
+static const char* strategyName(trace::Strategy strategy)
+{
+    switch (strategy)
+    {
+    case trace::STRATEGY_EXECUTABLE:    return "executable";
+    case trace::STRATEGY_DESKTOP:       return "desktop";
+    case trace::STRATEGY_EXPLORER:      return "explorer";
+    }
+    return "unknown";
+}
+
+static void dumpRecord(const trace::Record& record)
+{
+    double ms = record.time / 1e6;
+    switch (record.type)
+    {
+    case trace::RECORD_FOREGROUND:
+        std::printf("%12.3f ms  F  window=%#llx pid=%u class=\"%s\" exe_dir=\"%s\"\n", ms,
+            static_cast<unsigned long long>(record.window), record.processId, record.className.c_str(),
+            record.directory.c_str());
+        break;
+    case trace::RECORD_HOTKEY:
+        std::printf("%12.3f ms  H  %s%s\n", ms, record.isAdmin ? "admin" : "user",
+            record.coalesced ? " coalesced" : "");
+        break;
+    case trace::RECORD_RESOLVE:
+        std::printf("%12.3f ms  R  window=%#llx class=\"%s\" strategy=%s dir=\"%s\"\n", ms,
+            static_cast<unsigned long long>(record.window), record.className.c_str(),
+            strategyName(record.strategy), record.directory.c_str());
+        break;
+    case trace::RECORD_STAGES:
+        std::printf("%12.3f ms  T  %s settings=%llu resolve=%llu launch=%llu total=%llu us\n", ms,
+            record.isAdmin ? "admin" : "user", static_cast<unsigned long long>(record.stages[0]),
+            static_cast<unsigned long long>(record.stages[1]), static_cast<unsigned long long>(record.stages[2]),
+            static_cast<unsigned long long>(record.stages[3]));
+        break;
+    default:
+        break;
+    }
+}
+
+static void printUsage()
+{
+    std::fprintf(stderr, "Usage: ocaw_replay <trace file> [--cache-size n] [--repeat n] [--dump]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filename;
+    size_t cacheSize = 64;
+    int repeat = 1;
+    bool dump = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--cache-size" && hasValue)
+            cacheSize = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--repeat" && hasValue)
+            repeat = std::atoi(argv[++i]);
+        else if (arg == "--dump")
+            dump = true;
+        else if (filename.empty() && arg.rfind("--", 0) != 0)
+            filename = arg;
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+    if (filename.empty() || repeat <= 0)
+    {
+        printUsage();
+        return 2;
+    }
+
+    // Load the trace, track the process and the executable directory of each window by the foreground changes.
+    struct WindowState
+    {
+        uint32_t processId = 0;
+        std::wstring exeDirectory;
+    };
+    std::map<WindowSystem::Window, WindowState> windows;
+    std::vector<Resolve> resolves;
+    LatencyHistogram stages[2][LatencyStats::STAGE_COUNT];
+    uint64_t foregroundChanges = 0, hotkeys = 0, coalesced = 0, duration = 0;
+    bool truncated = false;
+
+    try
+    {
+        trace::Reader reader(filename);
+        trace::Record record;
+        while (reader.next(record))
+        {
+            duration = record.time;
+            if (dump)
+            {
+                dumpRecord(record);
+                continue;
+            }
+
+            switch (record.type)
+            {
+            case trace::RECORD_FOREGROUND:
+            {
+                ++foregroundChanges;
+                auto& state = windows[record.window];
+                // The directory is recorded only at the first time of the window and the process.
+                if (state.processId != record.processId || !record.directory.empty())
+                    state.exeDirectory = trace::fromUtf8(record.directory);
+                state.processId = record.processId;
+                break;
+            }
+            case trace::RECORD_HOTKEY:
+                ++hotkeys;
+                if (record.coalesced)
+                    ++coalesced;
+                break;
+            case trace::RECORD_RESOLVE:
+            {
+                const auto& state = windows[record.window];
+                resolves.push_back({ record.window, state.processId, trace::fromUtf8(record.className),
+                    record.strategy, trace::fromUtf8(record.directory), state.exeDirectory });
+                break;
+            }
+            case trace::RECORD_STAGES:
+                for (int stage = 0; stage < LatencyStats::STAGE_COUNT; ++stage)
+                    stages[record.isAdmin][stage].record(record.stages[stage]);
+                break;
+            default:
+                break;
+            }
+        }
+        truncated = reader.isTruncated();
+    } catch (std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+
+    if (truncated)
+        std::fprintf(stderr, "The trace is truncated, the incomplete record is ignored.\n");
+    if (dump)
+        return 0;
+
+    std::printf("Trace: %s (%.1f s)\n", filename.c_str(), duration / 1e9);
+    std::printf("  foreground changes %llu, hotkeys %llu (coalesced %llu), resolves %zu\n",
+        static_cast<unsigned long long>(foregroundChanges), static_cast<unsigned long long>(hotkeys),
+        static_cast<unsigned long long>(coalesced), resolves.size());
+
+    // Replay the resolves in the recorded order.
+    ReplayWindowSystem windowSystem;
+    ExeDirectoryCache cache(cacheSize);
+    ExeDirectoryCache* cachePtr = cacheSize > 0 ? &cache : nullptr;
+    uint64_t mismatches = 0;
+    uint64_t executableResolves = 0;
+    std::vector<double> nsPerResolve;
+
+    for (int round = 0; round < repeat; ++round)
+    {
+        cache.clear();
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& resolve : resolves)
+        {
+            windowSystem.setCurrent(&resolve);
+            auto directory = resolveFocusedWindowDirectory(windowSystem, cachePtr);
+            if (round > 0)
+                continue;
+
+            if (resolve.strategy == trace::STRATEGY_EXECUTABLE)
+                ++executableResolves;
+            if (directory != resolve.directory)
+            {
+                ++mismatches;
+                std::printf("  MISMATCH #%zu window=%#llx class=\"%s\" recorded=\"%s\" replayed=\"%s\"\n",
+                    static_cast<size_t>(&resolve - resolves.data()),
+                    static_cast<unsigned long long>(resolve.window), trace::toUtf8(resolve.className).c_str(),
+                    trace::toUtf8(resolve.directory).c_str(), trace::toUtf8(directory).c_str());
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (!resolves.empty())
+            nsPerResolve.push_back(std::chrono::duration<double, std::nano>(end - start).count() / resolves.size());
+    }
+
+    // The queries of each round are the same, report those of the first round.
+    uint64_t queries = windowSystem.exeDirectoryQueries() / repeat;
+    std::printf("\nResolver (cache size %zu)\n", cacheSize);
+    std::printf("  executable strategy %llu, executable directory queries %llu, cache hit rate %.1f%%\n",
+        static_cast<unsigned long long>(executableResolves), static_cast<unsigned long long>(queries),
+        executableResolves ? 100.0 * (executableResolves - queries) / executableResolves : 0.0);
+    if (!nsPerResolve.empty())
+    {
+        double best = nsPerResolve.front();
+        for (double ns : nsPerResolve)
+            best = ns < best ? ns : best;
+        std::printf("  %.1f ns per resolve (best of %d)\n", best, repeat);
+    }
+    std::printf("  mismatches %llu\n", static_cast<unsigned long long>(mismatches));
+
+    std::printf("\nRecorded latency (us)\n");
+    std::printf("  %-8s %-10s %8s %8s %8s %8s %8s\n", "hotkey", "stage", "count", "p50", "p90", "p99", "max");
+    for (int isAdmin = 0; isAdmin < 2; ++isAdmin)
+    {
+        for (int stage = 0; stage < LatencyStats::STAGE_COUNT; ++stage)
+        {
+            const auto& histogram = stages[isAdmin][stage];
+            if (histogram.count() == 0)
+                continue;
+            std::printf("  %-8s %-10s %8llu %8llu %8llu %8llu %8llu\n", isAdmin ? "admin" : "user",
+                LatencyStats::stageName(static_cast<LatencyStats::Stage>(stage)),
+                static_cast<unsigned long long>(histogram.count()),
+                static_cast<unsigned long long>(histogram.percentile(50)),
+                static_cast<unsigned long long>(histogram.percentile(90)),
+                static_cast<unsigned long long>(histogram.percentile(99)),
+                static_cast<unsigned long long>(histogram.max()));
+        }
+    }
+
+    return mismatches > 0 ? 1 : 0;
+}
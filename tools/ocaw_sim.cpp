@@ -0,0 +1,477 @@
+// Run the scripted scenarios of the whole hotkey pipeline of the OpenCmdAnywhere in the simulation,
+// the window system, the process spawning and the settings are faked and the time is a virtual clock,
+// so the results are reproducible and independent of the machine. Each scenario has the latency budgets,
+// the exit code is 1 if any budget or the expected directories are not met.
+//
+// Usage: ocaw_sim [options]
+//   --scenario <name>      Run only the specified scenario (default: all).
+//   --scale <factor>       Multiply the simulated cost of all operations, e.g. to check the budgets (default: 1).
+//   --list                 List the scenarios.
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "hotkey_backend.h"
+#include "launch_pipeline.h"
+#include "latency.h"
+#include "resolver.h"
+#include "virtual_clock.h"
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+static const char* USER_HOTKEY  = "Ctrl+Alt+T";
+static const char* ADMIN_HOTKEY = "Ctrl+Alt+Shift+T";
+
+// The simulated cost of each operation, close to the measurements on a typical desktop.
+struct Costs
+{
+    microseconds settingsRead   {100};
+    microseconds className      {20};
+    microseconds processId      {10};
+    microseconds exeDirectory   {400};
+    microseconds desktop        {150};
+    microseconds explorer       {6000};
+    microseconds spawnUser      {25000};
+    microseconds spawnAdmin     {250000};
+
+    void scale(double factor)
+    {
+        for (auto* cost : { &settingsRead, &className, &processId, &exeDirectory, &desktop, &explorer, &spawnUser, &spawnAdmin })
+            *cost = microseconds(static_cast<int64_t>(cost->count() * factor));
+    }
+};
+
+class FakeWindowSystem : public WindowSystem
+{
+public:
+    struct WindowInfo
+    {
+        std::wstring className;
+        std::wstring exeDirectory;
+        // The browsing directory of the explorer window.
+        std::wstring explorerDirectory;
+        // The extra time of the explorer query if the window is not responding.
+        microseconds hang{0};
+        uint32_t processId = 0;
+    };
+
+    FakeWindowSystem(VirtualClock& clock, const Costs& costs) :
+        clock_(clock), costs_(costs)
+    {}
+
+    void addWindow(Window window, WindowInfo info) { windows_[window] = std::move(info); }
+    WindowInfo& window(Window window) { return windows_.at(window); }
+    void setForeground(Window window) { foreground_ = window; }
+
+    Window foregroundWindow() override
+    {
+        if (windows_.find(foreground_) == windows_.end())
+            throw std::runtime_error("Failed to GetForegroundWindow()");
+        return foreground_;
+    }
+
+    std::wstring windowClassName(Window window) override
+    {
+        clock_.advance(costs_.className);
+        return windows_.at(window).className;
+    }
+
+    uint32_t windowProcessId(Window window) override
+    {
+        clock_.advance(costs_.processId);
+        return windows_.at(window).processId;
+    }
+
+    std::wstring windowExePath(Window window) override
+    {
+        clock_.advance(costs_.exeDirectory);
+        return windows_.at(window).exeDirectory + L"\\app.exe";
+    }
+
+    std::wstring windowExeDirectory(Window window) override
+    {
+        clock_.advance(costs_.exeDirectory);
+        return windows_.at(window).exeDirectory;
+    }
+
+    std::wstring desktopDirectory() override
+    {
+        clock_.advance(costs_.desktop);
+        return L"C:\\Users\\Sim\\Desktop";
+    }
+
+    std::wstring explorerDirectory(Window window) override
+    {
+        const auto& info = windows_.at(window);
+        clock_.advance(costs_.explorer + info.hang);
+        return info.explorerDirectory;
+    }
+
+private:
+    VirtualClock& clock_;
+    const Costs& costs_;
+    std::map<Window, WindowInfo> windows_;
+    Window foreground_ = 0;
+};
+
+// The state of a scenario run, the scenario script drives it by the press().
+class Simulation
+{
+public:
+    struct Launch
+    {
+        std::wstring executable;
+        std::wstring directory;
+        std::wstring parameter;
+        bool isAdmin;
+        bool useStandby;
+    };
+
+    explicit Simulation(const Costs& costs) :
+        costs(costs),
+        windows(clock, this->costs),
+        pipeline(
+            [this]()
+            {
+                clock.advance(this->costs.settingsRead);
+                return LaunchPipeline::Config{ executable, parameter, profiles };
+            },
+            [this](std::wstring* exePath) { return resolveFocusedWindowDirectory(windows, &cache, exePath); },
+            [this](const std::wstring& exe, const std::wstring& dir, const std::wstring& parameter, bool isAdmin,
+                   bool useStandby)
+            {
+                clock.advance(isAdmin ? this->costs.spawnAdmin : this->costs.spawnUser);
+                launches.push_back({ exe, dir, parameter, isAdmin, useStandby });
+                return true;
+            }
+        )
+    {
+        pipeline.setClock([this]() { return clock.now(); });
+        pipeline.setExecutor([](std::function<void()> work) { work(); });
+        backend.initialize();
+        backend.add(USER_HOTKEY, [this]() { pipeline.trigger(false); });
+        backend.add(ADMIN_HOTKEY, [this]() { pipeline.trigger(true); });
+    }
+
+    // Press the hotkey at the virtual time (ms since the start),
+    // the expectedDirectory is checked if a launch is expected, empty means no launch is expected.
+    // The expectedParameter and the expectedExecutable are checked if not null.
+    void press(int64_t timeMs, bool isAdmin, const std::wstring& expectedDirectory,
+               const wchar_t* expectedParameter = nullptr, const wchar_t* expectedExecutable = nullptr)
+    {
+        clock.advanceTo(LatencyStats::TimePoint(milliseconds(timeMs)));
+        size_t launchCount = launches.size();
+        backend.trigger(isAdmin ? ADMIN_HOTKEY : USER_HOTKEY);
+
+        bool launched = launches.size() > launchCount;
+        if (expectedDirectory.empty())
+        {
+            if (launched)
+                ++unexpected;
+        }
+        else
+        {
+            ++expectedLaunches;
+            if (!launched || launches.back().directory != expectedDirectory ||
+                (expectedParameter && launches.back().parameter != expectedParameter) ||
+                (expectedExecutable && launches.back().executable != expectedExecutable))
+                ++unexpected;
+        }
+    }
+
+    Costs costs;
+    VirtualClock clock;
+    FakeWindowSystem windows;
+    ExeDirectoryCache cache;
+    std::wstring executable = L"cmd.exe";
+    std::shared_ptr<const ParameterTemplate> parameter;
+    std::shared_ptr<const LaunchProfiles> profiles;
+    FakeHotkeyBackend backend;
+    LaunchPipeline pipeline;
+    std::vector<Launch> launches;
+    size_t expectedLaunches = 0;
+    // The presses which launched in a wrong directory, did not launch as expected or launched unexpectedly.
+    size_t unexpected = 0;
+};
+
+struct Budget
+{
+    bool isAdmin;
+    LatencyStats::Stage stage;
+    double percentile;
+    double maxMs;
+};
+
+struct Scenario
+{
+    const char* name;
+    const char* description;
+    std::function<void(Simulation&)> script;
+    std::vector<Budget> budgets;
+};
+
+static std::wstring workDirectory(int index)
+{
+    return L"D:\\Work\\Project" + std::to_wstring(index);
+}
+
+static std::vector<Scenario> scenarios()
+{
+    return {
+        {
+            "explorer_navigation",
+            "The user navigates an Explorer window between the directories and presses the hotkey in each one.",
+            [](Simulation& sim)
+            {
+                sim.windows.addWindow(1, { L"CabinetWClass", L"C:\\Windows", L"" });
+                sim.windows.setForeground(1);
+                for (int i = 0; i < 200; ++i)
+                {
+                    sim.windows.window(1).explorerDirectory = workDirectory(i % 20);
+                    sim.press(i * 2000, false, workDirectory(i % 20));
+                }
+            },
+            {
+                { false, LatencyStats::STAGE_RESOLVE, 99, 10 },
+                { false, LatencyStats::STAGE_TOTAL, 99, 40 }
+            }
+        },
+        {
+            "foreground_switch",
+            "The foreground switches between the Explorer, the desktop, an application and a virtual folder.",
+            [](Simulation& sim)
+            {
+                sim.windows.addWindow(1, { L"CabinetWClass", L"C:\\Windows", workDirectory(1) });
+                sim.windows.addWindow(2, { L"Progman", L"C:\\Windows", L"" });
+                sim.windows.addWindow(3, { L"Notepad", L"C:\\Program Files\\Notepad", L"" });
+                // "This PC" has no file system path, falls back to the directory of the explorer.exe.
+                sim.windows.addWindow(4, { L"CabinetWClass", L"C:\\Windows", L"" });
+                const std::wstring expected[] = {
+                    workDirectory(1), L"C:\\Users\\Sim\\Desktop", L"C:\\Program Files\\Notepad", L"C:\\Windows"
+                };
+                for (int i = 0; i < 400; ++i)
+                {
+                    sim.windows.setForeground(i % 4 + 1);
+                    sim.press(i * 1000, false, expected[i % 4]);
+                }
+            },
+            {
+                { false, LatencyStats::STAGE_RESOLVE, 50, 2 },
+                { false, LatencyStats::STAGE_RESOLVE, 99, 10 },
+                { false, LatencyStats::STAGE_TOTAL, 99, 40 }
+            }
+        },
+        {
+            "hung_explorer",
+            "Every 20th press hits an Explorer window which is not responding for 5 seconds.",
+            [](Simulation& sim)
+            {
+                sim.windows.addWindow(1, { L"CabinetWClass", L"C:\\Windows", workDirectory(1) });
+                sim.windows.setForeground(1);
+                for (int i = 0; i < 200; ++i)
+                {
+                    sim.windows.window(1).hang = i % 20 == 19 ? microseconds(5000000) : microseconds(0);
+                    sim.press(i * 10000, false, workDirectory(1));
+                }
+            },
+            {
+                { false, LatencyStats::STAGE_TOTAL, 90, 40 },
+                { false, LatencyStats::STAGE_TOTAL, 100, 5100 }
+            }
+        },
+        {
+            "admin_interleaved",
+            "The user and the admin hotkeys are pressed alternately in the same Explorer window.",
+            [](Simulation& sim)
+            {
+                sim.windows.addWindow(1, { L"CabinetWClass", L"C:\\Windows", workDirectory(1) });
+                sim.windows.setForeground(1);
+                for (int i = 0; i < 200; ++i)
+                    sim.press(i * 1000, i % 2 != 0, workDirectory(1));
+            },
+            {
+                { false, LatencyStats::STAGE_TOTAL, 99, 40 },
+                { true, LatencyStats::STAGE_TOTAL, 99, 300 }
+            }
+        },
+        {
+            "settings_change",
+            "The executable is cleared and restored between the presses, nothing is launched while it is empty.",
+            [](Simulation& sim)
+            {
+                sim.windows.addWindow(1, { L"Progman", L"C:\\Windows", L"" });
+                sim.windows.setForeground(1);
+                for (int i = 0; i < 100; ++i)
+                {
+                    bool cleared = (i / 10) % 2 != 0;
+                    sim.executable = cleared ? L"" : L"powershell.exe";
+                    sim.press(i * 1000, false, cleared ? L"" : L"C:\\Users\\Sim\\Desktop");
+                }
+            },
+            {
+                { false, LatencyStats::STAGE_SETTINGS, 99, 1 },
+                { false, LatencyStats::STAGE_TOTAL, 99, 40 }
+            }
+        },
+        {
+            "parameter_template",
+            "The parameter template is expanded with the resolved directory and the executable of the focused window.",
+            [](Simulation& sim)
+            {
+                sim.windows.addWindow(1, { L"CabinetWClass", L"C:\\Windows", L"D:\\Work\\My Project\\" });
+                sim.windows.addWindow(2, { L"Notepad", L"C:\\Program Files\\Notepad", L"" });
+                sim.parameter = std::make_shared<const ParameterTemplate>(L"/k cd /d {dir_quoted} & echo {exe_dir} {x}");
+                for (int i = 0; i < 100; ++i)
+                {
+                    bool explorer = i % 2 == 0;
+                    sim.windows.setForeground(explorer ? 1 : 2);
+                    sim.press(i * 1000, false, explorer ? L"D:\\Work\\My Project\\" : L"C:\\Program Files\\Notepad",
+                        explorer ? L"/k cd /d \"D:\\Work\\My Project\\\\\" & echo C:\\Windows {x}"
+                                 : L"/k cd /d \"C:\\Program Files\\Notepad\" & echo C:\\Program Files\\Notepad {x}");
+                    // The parameter depends on the directory, a standby instance can't be used.
+                    if (!sim.launches.empty() && sim.launches.back().useStandby)
+                        ++sim.unexpected;
+                }
+            },
+            {
+                { false, LatencyStats::STAGE_RESOLVE, 99, 10 },
+                { false, LatencyStats::STAGE_TOTAL, 99, 40 }
+            }
+        },
+        {
+            "launch_profiles",
+            "The executable and the parameter are chosen by the longest directory prefix rule, case-insensitively.",
+            [](Simulation& sim)
+            {
+                auto parameter = [](const wchar_t* text) { return std::make_shared<const ParameterTemplate>(text); };
+                sim.executable = L"powershell.exe";
+                sim.profiles = std::make_shared<const LaunchProfiles>(std::vector<LaunchProfile>{
+                    { L"D:\\repos", L"git-bash.exe", parameter(L"--cd={dir}") },
+                    { L"d:/Repos/OpenCmdAnywhere/build/", L"cmd.exe", parameter(L"/k VsDevCmd.bat") }
+                });
+                sim.windows.addWindow(1, { L"CabinetWClass", L"C:\\Windows", L"D:\\Repos\\OpenCmdAnywhere" });
+                sim.windows.addWindow(2, { L"CabinetWClass", L"C:\\Windows", L"D:\\repos\\OpenCmdAnywhere\\build\\x64" });
+                sim.windows.addWindow(3, { L"CabinetWClass", L"C:\\Windows", L"D:\\repos2" });
+                sim.windows.addWindow(4, { L"Progman", L"C:\\Windows", L"" });
+                for (int i = 0; i < 100; ++i)
+                {
+                    sim.windows.setForeground(i % 4 + 1);
+                    switch (i % 4)
+                    {
+                    case 0:
+                        sim.press(i * 1000, false, L"D:\\Repos\\OpenCmdAnywhere", L"--cd=D:\\Repos\\OpenCmdAnywhere",
+                            L"git-bash.exe");
+                        break;
+                    case 1:
+                        sim.press(i * 1000, false, L"D:\\repos\\OpenCmdAnywhere\\build\\x64", L"/k VsDevCmd.bat",
+                            L"cmd.exe");
+                        break;
+                    case 2:
+                        sim.press(i * 1000, false, L"D:\\repos2", L"", L"powershell.exe");
+                        break;
+                    default:
+                        sim.press(i * 1000, false, L"C:\\Users\\Sim\\Desktop", L"", L"powershell.exe");
+                        break;
+                    }
+                    // Only the directories without a matched profile may use a standby instance.
+                    if (!sim.launches.empty() && sim.launches.back().useStandby != (i % 4 >= 2))
+                        ++sim.unexpected;
+                }
+            },
+            {
+                { false, LatencyStats::STAGE_LAUNCH, 99, 30 },
+                { false, LatencyStats::STAGE_TOTAL, 99, 40 }
+            }
+        }
+    };
+}
+
+// Return false if the scenario failed.
+static bool runScenario(const Scenario& scenario, const Costs& costs)
+{
+    LatencyStats::reset();
+    Simulation sim(costs);
+    scenario.script(sim);
+    sim.pipeline.waitIdle();
+
+    bool passed = sim.unexpected == 0;
+    std::printf("== %s\n  %s\n", scenario.name, scenario.description);
+    std::printf("  %s launched %zu, expected %zu, unexpected %zu\n", sim.unexpected == 0 ? "PASS" : "FAIL",
+        sim.launches.size(), sim.expectedLaunches, sim.unexpected);
+
+    for (const auto& budget : scenario.budgets)
+    {
+        const auto& hist = LatencyStats::histogram(budget.isAdmin, budget.stage);
+        double ms = hist.percentile(budget.percentile) / 1000.0;
+        bool ok = ms <= budget.maxMs;
+        passed = passed && ok;
+        std::printf("  %s %s %s p%g %.3f ms (budget %g ms)\n", ok ? "PASS" : "FAIL",
+            budget.isAdmin ? "admin" : "user", LatencyStats::stageName(budget.stage), budget.percentile,
+            ms, budget.maxMs);
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string only;
+    double scale = 1.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--scenario" && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (arg == "--scale" && i + 1 < argc)
+        {
+            scale = std::atof(argv[++i]);
+        }
+        else if (arg == "--list")
+        {
+            for (const auto& scenario : scenarios())
+                std::printf("%-20s %s\n", scenario.name, scenario.description);
+            return 0;
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: ocaw_sim [--scenario name] [--scale factor] [--list]\n");
+            return 2;
+        }
+    }
+    if (scale <= 0)
+    {
+        std::fprintf(stderr, "The scale should be positive\n");
+        return 2;
+    }
+
+    Costs costs;
+    costs.scale(scale);
+
+    int runCount = 0;
+    int failedCount = 0;
+    for (const auto& scenario : scenarios())
+    {
+        if (!only.empty() && only != scenario.name)
+            continue;
+        ++runCount;
+        if (!runScenario(scenario, costs))
+            ++failedCount;
+    }
+
+    if (runCount == 0)
+    {
+        std::fprintf(stderr, "Unknown scenario: %s\n", only.c_str());
+        return 2;
+    }
+
+    std::printf("%d of %d scenarios passed\n", runCount - failedCount, runCount);
+    return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+// Expand a parameter template of the OpenCmdAnywhere with the given directory and executable,
+// the expansion and the escaping rules are tested by the tests/test_parameter_template.cpp.
+//
+// Usage: ocaw_template <template> [--dir <directory>] [--exe <path>]
+
+#include <cstdio>
+#include <string>
+
+#include "parameter_template.h"
+#include "trace_recorder.h"
+
+int main(int argc, char* argv[])
+{
+    std::wstring text, directory, exePath;
+    bool hasText = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc)
+            directory = trace::fromUtf8(argv[++i]);
+        else if (arg == "--exe" && i + 1 < argc)
+            exePath = trace::fromUtf8(argv[++i]);
+        else if (!hasText)
+        {
+            text = trace::fromUtf8(arg);
+            hasText = true;
+        }
+        else
+        {
+            hasText = false;
+            break;
+        }
+    }
+    if (!hasText)
+    {
+        std::fprintf(stderr, "Usage: ocaw_template <template> [--dir directory] [--exe path]\n");
+        return 2;
+    }
+
+    ParameterTemplate parameterTemplate(text);
+    std::printf("%s\n", trace::toUtf8(parameterTemplate.expand({ directory, exePath })).c_str());
+    return 0;
+}